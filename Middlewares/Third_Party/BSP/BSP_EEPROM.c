@@ -10,6 +10,44 @@
 	**/	
 	
 #include "BSP_EEPROM.h"	
+#include "string.h"
+
+#if (USE_FLASH_EEPROM == 1)
+#include "BSP_EEPROM_Flash.h"
+#endif
+#if (USE_SOFTSPI_WAVE == 1)
+#include "BSP_EEPROM_Wave.h"
+#endif
+#if (USE_HARDSPI_IT == 1)
+#include "BSP_EEPROM_SpiIT.h"
+#endif
+
+EEP_DeviceTypeDef hEeprom = EEP_DEVICE_INIT(EEP_CS_GPIO_Port, EEP_CS_Pin);
+EEP_DeviceTypeDef* pEeprom = &hEeprom; 													// device all EEPROM_SPI_ calls talk to
+
+/**
+  * @brief  builds the instruction and address phase the way the device expects it
+  * @param  pHeader: buffer of at least EEP_HEADER_MAX bytes
+  * @param  ucCmd: CMD_READ or CMD_WRITE
+  * @param  Addr: memory address
+	* @retval header length in bytes
+  */
+//====================================================================================
+static uint8_t EEPROM_SPI_BuildHeader(uint8_t* pHeader, uint8_t ucCmd, uint32_t Addr)
+//====================================================================================
+{
+	uint8_t ucLen = 0;
+
+	// single address byte parts of 512 bytes (25xx040) carry A8 in bit 3 of the opcode
+	if(pEeprom->AddrBytes == 1) ucCmd |= (uint8_t)((Addr >> 5) & 0x08);
+
+	pHeader[ucLen++] = ucCmd;
+	for(int8_t i = (int8_t)pEeprom->AddrBytes - 1; i >= 0; i--){
+		pHeader[ucLen++] = (uint8_t)(Addr >> (8 * i));
+	}
+
+	return ucLen;
+}
 
 //=======================================================================================
 //====================== Functions for Hardware based SPI ===============================
@@ -28,37 +66,63 @@ HAL_StatusTypeDef EEPROM_HardSPI_Init(void)
 	return HAL_OK;
 }
 
+static const uint32_t uwHardSPIPrescaler[EEP_CLK_STEPS] = {
+	SPI_BAUDRATEPRESCALER_2,  SPI_BAUDRATEPRESCALER_4,  SPI_BAUDRATEPRESCALER_8,   SPI_BAUDRATEPRESCALER_16,
+	SPI_BAUDRATEPRESCALER_32, SPI_BAUDRATEPRESCALER_64, SPI_BAUDRATEPRESCALER_128, SPI_BAUDRATEPRESCALER_256
+};
+
+/**
+  * @brief  selects the SPI1 baud rate prescaler
+  * @param  ucStep: clock step, 0 = fPCLK/2 ... 7 = fPCLK/256
+	* @retval HAL_StatusTypeDef enum, HAL_OK in case of successful operation
+  */
+//===========================================================
+HAL_StatusTypeDef EEPROM_HardSPI_SetClock(uint8_t ucStep)
+//===========================================================
+{
+	if(ucStep >= EEP_CLK_STEPS) return HAL_ERROR;
+
+	__HAL_SPI_DISABLE(&hspi1);
+	hspi1.Init.BaudRatePrescaler = uwHardSPIPrescaler[ucStep];
+	MODIFY_REG(hspi1.Instance->CR1, SPI_CR1_BR, hspi1.Init.BaudRatePrescaler);
+	pEeprom->ClkStep = ucStep;
+
+	return HAL_OK;
+}
+
 /**
   * @brief  spi low level function for sending single byte
   * @param  value: data value for write
 	* @retval none
   */
-//========================================================================================
-__STATIC_INLINE HAL_StatusTypeDef EEPROM_HardSPI_SendByte(uint8_t* pByte, uint8_t ucSize)
-//========================================================================================
+//==========================================================================================
+__STATIC_INLINE HAL_StatusTypeDef EEPROM_HardSPI_SendByte(uint8_t* pByte, uint16_t uiSize)
+//==========================================================================================
 {
-	uint32_t uwTimeout = BSP_GetTick();
+	BSP_DeadlineTypeDef deadline = BSP_Deadline_After(EEPROM_SPI_FLAG_TIMEOUT_US);
 	
-  while ((!__HAL_SPI_GET_FLAG(&hspi1, SPI_FLAG_TXE)) && (BSP_GetTick() - uwTimeout < WRITE_TIMEOUT_MS)); //BSP_Delay(1, NONE_BLOCKING);
-	if(BSP_GetTick() - uwTimeout >= 50) return HAL_ERROR;
+  while (!__HAL_SPI_GET_FLAG(&hspi1, SPI_FLAG_TXE)){
+		if(BSP_Deadline_Expired(deadline)) return HAL_ERROR;
+	}
 
-  return HAL_SPI_Transmit(&hspi1, (uint8_t*)pByte, (uint16_t)ucSize, EEPROM_SPI_FLAG_TIMEOUT);
+  return HAL_SPI_Transmit(&hspi1, (uint8_t*)pByte, uiSize, EEPROM_SPI_FLAG_TIMEOUT);
 }
 
 /**
   * @brief  spi low level function for receiving single byte
 	* @retval received data
   */
-//========================================================================================
-__STATIC_INLINE HAL_StatusTypeDef EEPROM_HardSPI_RecvByte(uint8_t* pByte, uint8_t ucSize)
-//========================================================================================
+//==========================================================================================
+__STATIC_INLINE HAL_StatusTypeDef EEPROM_HardSPI_RecvByte(uint8_t* pByte, uint16_t uiSize)
+//==========================================================================================
 {
-	uint32_t uwTimeout = BSP_GetTick();
+	BSP_DeadlineTypeDef deadline = BSP_Deadline_After(EEPROM_SPI_FLAG_TIMEOUT_US);
 	
-  while ((!__HAL_SPI_GET_FLAG(&hspi1, SPI_FLAG_RXNE)) && (BSP_GetTick() - uwTimeout < WRITE_TIMEOUT_MS)); //BSP_Delay(1, NONE_BLOCKING);
-	if(BSP_GetTick() - uwTimeout >= 50) return HAL_ERROR;
+  while (!__HAL_SPI_GET_FLAG(&hspi1, SPI_FLAG_TXE)){
+		if(BSP_Deadline_Expired(deadline)) return HAL_ERROR;
+	}
 
-  return HAL_SPI_Receive(&hspi1, (uint8_t*)pByte, (uint16_t)ucSize, EEPROM_SPI_FLAG_TIMEOUT);
+  return HAL_SPI_Receive(&hspi1, (uint8_t*)pByte, uiSize, EEPROM_SPI_FLAG_TIMEOUT);
 }
 
 /**
@@ -70,23 +134,23 @@ HAL_StatusTypeDef EEPROM_HardSPI_IsReady(void)
 //===========================================================	
 {
 	HAL_StatusTypeDef E2PStatus = HAL_ERROR;
+	BSP_DeadlineTypeDef deadline = BSP_Deadline_After(WRITE_TIMEOUT_US);
   uint8_t sEEstatus[1] = { 0x00 };
   uint8_t command[1] = { CMD_RDSR };
 
   // Select the EEPROM: Chip Select low
   EEP_SPI_CS_LOW();
 
-  // Send "Read Status Register" Instruction and Wait to Receive
+  // Send "Read Status Register" Instruction and keep clocking it out until WIP clears
   if(EEPROM_HardSPI_SendByte(command, 1) == HAL_OK){	
-		for(uint8_t uCount = 0; uCount < 5; uCount++){
-			if(HAL_SPI_Receive(&hspi1, (uint8_t*)sEEstatus, 1, 100) == HAL_OK){
-				if((sEEstatus[0] & 0x01) == 0){
-					E2PStatus = HAL_OK;
-					break;
-				}
+		do
+		{
+			if(EEPROM_HardSPI_RecvByte(sEEstatus, 1) != HAL_OK) break;
+			if(bitRead(sEEstatus[0], BIT_WIP) == 0){
+				E2PStatus = HAL_OK;
+				break;
 			}
-			BSP_Delay(1, NONE_BLOCKING);
-		}
+		} while(!BSP_Deadline_Expired(deadline));
 	}
 			
 	// Deselect the EEPROM: Chip Select high
@@ -94,6 +158,45 @@ HAL_StatusTypeDef EEPROM_HardSPI_IsReady(void)
   return E2PStatus;
 }
 
+/**
+  * @brief  sends a single byte instruction (WREN, WRDI) in its own CS frame
+  * @param  ucCmd: instruction code
+	* @retval HAL_StatusTypeDef enum, HAL_OK in case of successful operation
+  */
+//===========================================================
+HAL_StatusTypeDef EEPROM_HardSPI_SendCommand(uint8_t ucCmd)
+//===========================================================
+{
+	HAL_StatusTypeDef E2PStatus;
+
+	EEP_SPI_CS_LOW();
+	E2PStatus = EEPROM_HardSPI_SendByte(&ucCmd, 1);
+	EEP_SPI_CS_HIGH();
+
+	return E2PStatus;
+}
+
+/**
+  * @brief  reads the status register once, in a single short RDSR frame
+  * @param  pStatus: pointer to status variable
+	* @retval HAL_StatusTypeDef enum, HAL_OK in case of successful operation
+  */
+//===========================================================
+HAL_StatusTypeDef EEPROM_HardSPI_ReadStatus(uint8_t* pStatus)
+//===========================================================
+{
+	HAL_StatusTypeDef E2PStatus = HAL_ERROR;
+  uint8_t command[1] = { CMD_RDSR };
+
+	EEP_SPI_CS_LOW();
+  if(EEPROM_HardSPI_SendByte(command, 1) == HAL_OK){	
+		E2PStatus = EEPROM_HardSPI_RecvByte(pStatus, 1);
+	}
+	EEP_SPI_CS_HIGH();
+
+	return E2PStatus;
+}
+
 /**
   * @brief  stores one byte to eeprom
   * @param  RegAdd: eeprom register address
@@ -101,41 +204,23 @@ HAL_StatusTypeDef EEPROM_HardSPI_IsReady(void)
 	* @retval HAL_StatusTypeDef enum, HAL_OK in case of successful operation
   */
 //================================================================================
-HAL_StatusTypeDef EEPROM_HardSPI_WriteByte(uint16_t RegAdd, uint8_t RegData)	
+HAL_StatusTypeDef EEPROM_HardSPI_WriteByte(uint32_t RegAdd, uint8_t RegData)	
 //=================================================================================
 {
 	HAL_StatusTypeDef E2PStatus = HAL_ERROR;
-	uint32_t tw = BSP_GetTick();
-	uint8_t ucByte;
-
-	EEP_SPI_CS_LOW();
-	ucByte = CMD_RDSR;
-	E2PStatus = EEPROM_HardSPI_SendByte(&ucByte, 1);
-	
-	do
-	{
-		ucByte = 0;
-		E2PStatus = EEPROM_HardSPI_RecvByte(&ucByte, 1);
-		
-	} while((bitRead(ucByte, BIT_WIP) == 1) && (BSP_GetTick() < tw + WRITE_TIMEOUT_MS));
-	
-	 EEP_SPI_CS_HIGH();
+	uint8_t buf[EEP_HEADER_MAX + 1];
+	uint8_t ucLen;
 
-	if(bitRead(ucByte, BIT_WIP) == 1) return HAL_ERROR;
+	if(EEPROM_SPI_WaitReady() != HAL_OK) return HAL_ERROR;
 
-	EEP_SPI_CS_LOW();
-	ucByte = CMD_WREN;
-	E2PStatus = EEPROM_HardSPI_SendByte(&ucByte, 1);
-	EEP_SPI_CS_HIGH();
+	if(EEPROM_HardSPI_SendCommand(CMD_WREN) != HAL_OK) return HAL_ERROR;
 	
 	EEP_SPI_CS_LOW();
-	uint8_t buf4[4];
-	buf4[0]=CMD_WRITE;
-	buf4[1]=(uint8_t)(RegAdd >> 8) & 0xFF;
-	buf4[2]=(uint8_t)(RegAdd & 0xFF);
-	buf4[3]=RegData;
-	E2PStatus = EEPROM_HardSPI_SendByte(buf4, 4);
+	ucLen = EEPROM_SPI_BuildHeader(buf, CMD_WRITE, RegAdd);
+	buf[ucLen++] = RegData;
+	E2PStatus = EEPROM_HardSPI_SendByte(buf, ucLen);
 	EEP_SPI_CS_HIGH();
+	EEPROM_SPI_WriteCycleStarted();
 
 	return E2PStatus;
 }
@@ -147,28 +232,24 @@ HAL_StatusTypeDef EEPROM_HardSPI_WriteByte(uint16_t RegAdd, uint8_t RegData)
 	* @retval HAL_StatusTypeDef enum, HAL_OK in case of successful operation
   */
 //================================================================================
-HAL_StatusTypeDef EEPROM_HardSPI_ReadByte(uint16_t ReadAddr, uint8_t* pData)	
+HAL_StatusTypeDef EEPROM_HardSPI_ReadByte(uint32_t ReadAddr, uint8_t* pData)	
 //=================================================================================
 {
-  uint8_t header[3];
+  uint8_t header[EEP_HEADER_MAX];
+	uint8_t ucLen;
 	HAL_StatusTypeDef E2PStatus = HAL_ERROR;
 	
-  header[0] = CMD_READ;    				 // Send "Read from Memory" instruction
-  header[1] = ReadAddr >> 8;  		 // Send 16-bit address
-  header[2] = ReadAddr;
+	if(EEPROM_SPI_WaitReady() != HAL_OK) return HAL_ERROR;
+
+	// "Read from Memory" instruction and address phase
+  ucLen = EEPROM_SPI_BuildHeader(header, CMD_READ, ReadAddr);
 
   // Select the EEPROM: Chip Select low
   EEP_SPI_CS_LOW();
 
 	// Send WriteAddr address byte to read from and Wait to Receive
-  if(EEPROM_HardSPI_SendByte(header, 3) == HAL_OK){	
-		for(uint8_t uCount = 0; uCount < 5; uCount++){
-			if(EEPROM_HardSPI_RecvByte(pData, 1) == HAL_OK){
-					E2PStatus = HAL_OK;
-					break;
-			}
-			BSP_Delay(1, NONE_BLOCKING);
-		}
+  if(EEPROM_HardSPI_SendByte(header, ucLen) == HAL_OK){	
+		E2PStatus = EEPROM_HardSPI_RecvByte(pData, 1);
 	}
 
   // Deselect the EEPROM: Chip Select high
@@ -192,8 +273,10 @@ HAL_StatusTypeDef EEPROM_HardSPI_WriteStatusRegister(uint8_t regval)
   command[0] = CMD_WRSR;
   command[1] = regval;
 
+	if(EEPROM_SPI_WaitReady() != HAL_OK) return HAL_ERROR;
+
   // Enable the write access to the EEPROM
-  if(EEPROM_HardSPI_WriteByte(CMD_WREN, 1) == HAL_OK)
+  if(EEPROM_HardSPI_SendCommand(CMD_WREN) == HAL_OK)
 	{
 		// Select the EEPROM: Chip Select low
 		EEP_SPI_CS_LOW();
@@ -203,209 +286,159 @@ HAL_StatusTypeDef EEPROM_HardSPI_WriteStatusRegister(uint8_t regval)
 		
 		// Deselect the EEPROM: Chip Select high
 		EEP_SPI_CS_HIGH();
+		EEPROM_SPI_WriteCycleStarted();
 	}
-	if(E2PStatus != HAL_OK) return E2PStatus;
-	
-  E2PStatus = EEPROM_HardSPI_WriteByte(CMD_WRDI, 1);
+
 	return E2PStatus;
 }
 
 /**
   * @brief  reads number of bytes from eeprom 
   * @param  pBuffer: pointer to the data for read out
-  * @param  WriteAddr: read address of eeprom (16bit address space)
-  * @param  NumByteToRead: number of bytes for read  
+  * @param  WriteAddr: read address of eeprom (32bit address space)
+  * @param  NumByteToRead: number of bytes for read, the whole array if needed
 	* @retval HAL_StatusTypeDef enum, HAL_OK in case of successful operation
   */
 //==============================================================================================================
-HAL_StatusTypeDef EEPROM_HardSPI_ReadBuffer(uint8_t* pBuffer, uint16_t ReadAddr, uint16_t NumByteToRead)
+HAL_StatusTypeDef EEPROM_HardSPI_ReadBuffer(uint8_t* pBuffer, uint32_t ReadAddr, uint32_t NumByteToRead)
 //==============================================================================================================
 {
-  uint8_t header[3];
 	HAL_StatusTypeDef E2PStatus = HAL_ERROR;
 	
-  header[0] = CMD_READ;    				 // Send "Read from Memory" instruction
-  header[1] = ReadAddr >> 8;  		 // Send 16-bit address
-  header[2] = ReadAddr;
+	if(NumByteToRead == 0 || pBuffer == NULL) return HAL_ERROR;
+
+#if (USE_HARDSPI_IT == 1)
+	if(NumByteToRead >= hEepSpiIT.Threshold && NumByteToRead <= 0xFFFF - EEP_HEADER_MAX)
+	{
+		uint8_t header[EEP_HEADER_MAX];
+		uint8_t ucLen;
+
+		if(EEPROM_SPI_WaitReady() != HAL_OK) return HAL_ERROR;
+
+		ucLen = EEPROM_SPI_BuildHeader(header, CMD_READ, ReadAddr);
+		if(EEPROM_SpiIT_Start(header, ucLen, NULL, pBuffer, (uint16_t)NumByteToRead, 0, NULL, NULL) != HAL_OK) return HAL_ERROR;
+		return EEPROM_SpiIT_Wait();
+	}
+#endif
+
+	E2PStatus = EEPROM_HardSPI_ReadStart(ReadAddr);
+	if(E2PStatus == HAL_OK) E2PStatus = EEPROM_HardSPI_ReadNext(pBuffer, NumByteToRead);
+	EEPROM_HardSPI_ReadStop();
+
+  return E2PStatus;
+}
+
+/**
+  * @brief  opens a continuous READ, the data is then clocked out in any number
+  *         of EEPROM_HardSPI_ReadNext pieces until EEPROM_HardSPI_ReadStop
+  * @param  ReadAddr: first address to read
+	* @retval HAL_StatusTypeDef enum, HAL_OK in case of successful operation
+  */
+//==============================================================================================================
+HAL_StatusTypeDef EEPROM_HardSPI_ReadStart(uint32_t ReadAddr)
+//==============================================================================================================
+{
+  uint8_t header[EEP_HEADER_MAX];
+	uint8_t ucLen;
+
+	if(EEPROM_SPI_WaitReady() != HAL_OK) return HAL_ERROR;
+
+	// "Read from Memory" instruction and address phase
+  ucLen = EEPROM_SPI_BuildHeader(header, CMD_READ, ReadAddr);
 
   // Select the EEPROM: Chip Select low
   EEP_SPI_CS_LOW();
 
-	// Send WriteAddr address byte to read from and Wait to Receive
-  if(EEPROM_HardSPI_SendByte(header, 3) == HAL_OK){	
-		for(uint8_t uCount = 0; uCount < 5; uCount++){
-			if(EEPROM_HardSPI_RecvByte(pBuffer, 1) == HAL_OK){
-					E2PStatus = HAL_OK;
-					break;
-			}
-			BSP_Delay(1, NONE_BLOCKING);
-		}
+	return EEPROM_HardSPI_SendByte(header, ucLen);
+}
+
+/**
+  * @brief  reads the next bytes of a READ opened by EEPROM_HardSPI_ReadStart
+  * @param  pBuffer: pointer to the data for read out
+  * @param  NumByteToRead: number of bytes for read
+	* @retval HAL_StatusTypeDef enum, HAL_OK in case of successful operation
+  */
+//==============================================================================================================
+HAL_StatusTypeDef EEPROM_HardSPI_ReadNext(uint8_t* pBuffer, uint32_t NumByteToRead)
+//==============================================================================================================
+{
+	HAL_StatusTypeDef E2PStatus = HAL_OK;
+	uint16_t uiChunk;
+
+	// HAL transfers stop at 64K-1 bytes, CS stays low so it remains one READ
+	while((E2PStatus == HAL_OK) && (NumByteToRead > 0))
+	{
+		uiChunk = (NumByteToRead > 0xFFFF) ? 0xFFFF : (uint16_t)NumByteToRead;
+		E2PStatus = EEPROM_HardSPI_RecvByte(pBuffer, uiChunk);
+		pBuffer += uiChunk;
+		NumByteToRead -= uiChunk;
 	}
 
+	return E2PStatus;
+}
+
+/**
+  * @brief  ends a READ opened by EEPROM_HardSPI_ReadStart
+	* @retval none
+  */
+//==============================================
+void EEPROM_HardSPI_ReadStop(void)
+//==============================================
+{
   // Deselect the EEPROM: Chip Select high
   EEP_SPI_CS_HIGH();
-
-  return E2PStatus;
 }
 
 /**
   * @brief  writes number of bytes in case they are page aligned 
   * @param  pBuffer: pointer to the data for write in
-  * @param  WriteAddr: write address of eeprom (16bit address space)
-  * @param  NumByteToWrite: number of bytes for write  
+  * @param  WriteAddr: write address of eeprom (32bit address space)
+  * @param  NumByteToWrite: number of bytes for write, up to the device page size
 	* @retval HAL_StatusTypeDef enum, HAL_OK in case of successful operation
   */
 //==============================================================================================================
-HAL_StatusTypeDef EEPROM_HardSPI_WritePage(uint8_t* pBuffer, uint16_t WriteAddr, uint16_t NumByteToWrite)
+HAL_StatusTypeDef EEPROM_HardSPI_WritePage(uint8_t* pBuffer, uint32_t WriteAddr, uint32_t NumByteToWrite)
 //==============================================================================================================	
 {
 	HAL_StatusTypeDef E2PStatus = HAL_ERROR;
-	uint32_t uwTimeout = BSP_GetTick();
-  uint8_t header[3];
+  uint8_t header[EEP_HEADER_MAX];
+	uint8_t ucLen;
 		
+	if(NumByteToWrite == 0 || NumByteToWrite > pEeprom->PageSize || pBuffer == NULL) return HAL_ERROR;
+
+	// The previous write cycle is awaited here, not after our own one
+	if(EEPROM_SPI_WaitReady() != HAL_OK) return HAL_ERROR;
+
   // Enable the write access to the EEPROM
-  if(EEPROM_HardSPI_WriteByte(CMD_WREN, 1) == HAL_OK)
+  if(EEPROM_HardSPI_SendCommand(CMD_WREN) == HAL_OK)
 	{
-    header[0] = CMD_WRITE;   				 // Send "Write to Memory" instruction
-    header[1] = WriteAddr >> 8; 		 // Send 16-bit address
-    header[2] = WriteAddr;
+		// "Write to Memory" instruction and address phase
+    ucLen = EEPROM_SPI_BuildHeader(header, CMD_WRITE, WriteAddr);
+
+#if (USE_HARDSPI_IT == 1)
+		// header and payload as one interrupt driven frame, the ISR raises CS
+		if(NumByteToWrite >= hEepSpiIT.Threshold)
+		{
+			if(EEPROM_SpiIT_Start(header, ucLen, pBuffer, NULL, (uint16_t)NumByteToWrite, 1, NULL, NULL) != HAL_OK) return HAL_ERROR;
+			return EEPROM_SpiIT_Wait();
+		}
+#endif
 
     // Select the EEPROM: Chip Select low
     EEP_SPI_CS_LOW();
 
-    EEPROM_HardSPI_SendByte((uint8_t*)header, 3);
-
-    // Make 5 attemtps to write the data
-    for (uint8_t uCount = 0; uCount < 5; uCount++) {
-       if(EEPROM_HardSPI_SendByte(pBuffer, NumByteToWrite) == HAL_OK){
-					E2PStatus = HAL_OK;
-					break;
-			}
-			BSP_Delay(5, NONE_BLOCKING);
-    }
+    if(EEPROM_HardSPI_SendByte((uint8_t*)header, ucLen) == HAL_OK){
+			E2PStatus = EEPROM_HardSPI_SendByte(pBuffer, (uint16_t)NumByteToWrite);
+		}
 
-    // Deselect the EEPROM: Chip Select high
+    // Deselect the EEPROM: Chip Select high, this starts the write cycle
     EEP_SPI_CS_HIGH();
-
-    // Wait the end of EEPROM writing
-    while((EEPROM_HardSPI_IsReady() != HAL_OK) && (BSP_GetTick() - uwTimeout < 50)) BSP_Delay(5, NONE_BLOCKING);
-		if(BSP_GetTick() - uwTimeout >= 50) return E2PStatus;
+		EEPROM_SPI_WriteCycleStarted();
 	}
 	
-	if(E2PStatus != HAL_OK) return E2PStatus;
-	
-  E2PStatus = EEPROM_HardSPI_WriteByte(CMD_WRDI, 1);
 	return E2PStatus;
 }
 
-/**
-  * @brief  writes any number of data to eeprom in PageWrite mode even if the buffer is not page aligned
-  * @param  pBuffer: pointer to the data for write in
-  * @param  WriteAddr: write address of eeprom (16bit address space)
-  * @param  NumByteToWrite: number of bytes for write  
-	* @retval HAL_StatusTypeDef enum, HAL_OK in case of successful operation
-  */
-//================================================================================================================
-HAL_StatusTypeDef EEPROM_HardSPI_WriteBuffer(uint8_t* pBuffer, uint16_t WriteAddr, uint16_t NumByteToWrite)
-//=================================================================================================================	
-{
-	HAL_StatusTypeDef E2PStatus = HAL_ERROR;
-  uint16_t NumOfPage = 0, NumOfSingle = 0, Addr = 0, count = 0, temp = 0;
-  uint16_t sEE_DataNum = 0;
-
-  Addr = WriteAddr % EEP_SPI_PAGESIZE;
-  count = EEP_SPI_PAGESIZE - Addr;
-  NumOfPage =  NumByteToWrite / EEP_SPI_PAGESIZE;
-  NumOfSingle = NumByteToWrite % EEP_SPI_PAGESIZE;
-
-  if(Addr == 0)
-	{ // WriteAddr is EEPROM_PAGESIZE aligned 
-      if(NumOfPage == 0)
-			{ // NumByteToWrite < EEPROM_PAGESIZE
-          sEE_DataNum = NumByteToWrite;
-          E2PStatus = EEPROM_HardSPI_WritePage(pBuffer, WriteAddr, sEE_DataNum);
-          if (E2PStatus != HAL_OK) return E2PStatus;
-
-      } 
-			else
-			{ // NumByteToWrite > EEPROM_PAGESIZE
-          while (NumOfPage--)
-					{
-              sEE_DataNum = EEP_SPI_PAGESIZE;
-              E2PStatus = EEPROM_HardSPI_WritePage(pBuffer, WriteAddr, sEE_DataNum);
-              if (E2PStatus != HAL_OK) return E2PStatus;
-
-              WriteAddr +=  EEP_SPI_PAGESIZE;
-              pBuffer += EEP_SPI_PAGESIZE;
-          }
-
-          sEE_DataNum = NumOfSingle;
-          E2PStatus = EEPROM_HardSPI_WritePage(pBuffer, WriteAddr, sEE_DataNum);
-
-          if (E2PStatus != HAL_OK) return E2PStatus;
-      }
-  }
-	else
-	{ // WriteAddr is not EEPROM_PAGESIZE aligned
-      if (NumOfPage == 0)
-			{ // NumByteToWrite < EEPROM_PAGESIZE
-          if (NumOfSingle > count)
-					{ // (NumByteToWrite + WriteAddr) > EEPROM_PAGESIZE
-              temp = NumOfSingle - count;
-              sEE_DataNum = count;
-              E2PStatus = EEPROM_HardSPI_WritePage(pBuffer, WriteAddr, sEE_DataNum);
-              if (E2PStatus != HAL_OK) return E2PStatus;
-
-              WriteAddr +=  count;
-              pBuffer += count;
-
-              sEE_DataNum = temp;
-              E2PStatus = EEPROM_HardSPI_WritePage(pBuffer, WriteAddr, sEE_DataNum);
-          } else
-					{
-              sEE_DataNum = NumByteToWrite;
-              E2PStatus = EEPROM_HardSPI_WritePage(pBuffer, WriteAddr, sEE_DataNum);
-          }
-          if (E2PStatus != HAL_OK) return E2PStatus;
-      }
-			else
-			{ //NumByteToWrite > EEPROM_PAGESIZE
-          NumByteToWrite -= count;
-          NumOfPage =  NumByteToWrite / EEP_SPI_PAGESIZE;
-          NumOfSingle = NumByteToWrite % EEP_SPI_PAGESIZE;
-
-          sEE_DataNum = count;
-
-          E2PStatus = EEPROM_HardSPI_WritePage(pBuffer, WriteAddr, sEE_DataNum);
-          if (E2PStatus != HAL_OK) return E2PStatus;
-
-          WriteAddr +=  count;
-          pBuffer += count;
-
-          while (NumOfPage--)
-					{
-              sEE_DataNum = EEP_SPI_PAGESIZE;
-
-							E2PStatus = EEPROM_HardSPI_WritePage(pBuffer, WriteAddr, sEE_DataNum);
-							if (E2PStatus != HAL_OK) return E2PStatus;
-
-              WriteAddr +=  EEP_SPI_PAGESIZE;
-              pBuffer += EEP_SPI_PAGESIZE;
-          }
-
-          if (NumOfSingle != 0)
-					{
-              sEE_DataNum = NumOfSingle;
-
-              E2PStatus = EEPROM_HardSPI_WritePage(pBuffer, WriteAddr, sEE_DataNum);
-							if (E2PStatus != HAL_OK) return E2PStatus;
-          }
-      }
-  }
-
-  return HAL_OK;
-}
-
 
 //=======================================================================================
 //====================== Functions for Software based SPI ===============================
@@ -423,12 +456,16 @@ HAL_StatusTypeDef EEPROM_SoftSPI_Init(void)
 	EEP_SPI_CS_GPIO_CLK_ENABLE();
 	EEP_SPI_SCK_GPIO_CLK_ENABLE();
 	
+	// chip select of the selected device, other chips are inited after selecting them
+	EEP_SPI_CS_HIGH();
+
+#ifndef BSP_EEPROM_SIM
 	GPIO_InitTypeDef GPIO_InitStruct;
 
-  GPIO_InitStruct.Pin = EEP_CS_Pin;
+  GPIO_InitStruct.Pin = pEeprom->CsPin;
   GPIO_InitStruct.Mode = GPIO_MODE_OUTPUT_PP;
   GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_LOW;
-  HAL_GPIO_Init(EEP_CS_GPIO_Port, &GPIO_InitStruct);
+  HAL_GPIO_Init(pEeprom->CsPort, &GPIO_InitStruct);
 	
   GPIO_InitStruct.Pin = EEP_CLK_Pin|EEP_MOSI_Pin;
   GPIO_InitStruct.Mode = GPIO_MODE_OUTPUT_PP;
@@ -439,7 +476,27 @@ HAL_StatusTypeDef EEPROM_SoftSPI_Init(void)
   GPIO_InitStruct.Mode = GPIO_MODE_INPUT;
   GPIO_InitStruct.Pull = GPIO_NOPULL;
   HAL_GPIO_Init(EEP_MISO_GPIO_Port, &GPIO_InitStruct);	
+#endif
 	
+	return EEPROM_SoftSPI_SetClock(pEeprom->ClkStep);
+}
+
+static const uint8_t ucSoftSPIClkDelay[EEP_CLK_STEPS] = { 0, 1, 2, 4, 8, 16, 32, 50 };
+
+/**
+  * @brief  selects the bit-bang half period
+  * @param  ucStep: clock step, 0 = no delay ... 7 = 50 NOP loops per half period
+	* @retval HAL_StatusTypeDef enum, HAL_OK in case of successful operation
+  */
+//===========================================================
+HAL_StatusTypeDef EEPROM_SoftSPI_SetClock(uint8_t ucStep)
+//===========================================================
+{
+	if(ucStep >= EEP_CLK_STEPS) return HAL_ERROR;
+
+	pEeprom->ClkDelay = ucSoftSPIClkDelay[ucStep];
+	pEeprom->ClkStep = ucStep;
+
 	return HAL_OK;
 }
 
@@ -506,6 +563,24 @@ __STATIC_INLINE uint8_t EEPROM_SoftSPI_RecvByte(void)
   return temp;
 }
 
+/**
+  * @brief  sends instruction and address phase of a memory access
+  * @param  ucCmd: CMD_READ or CMD_WRITE
+  * @param  Addr: memory address
+	* @retval none
+  */
+//=========================================================================
+static void EEPROM_SoftSPI_SendHeader(uint8_t ucCmd, uint32_t Addr)
+//=========================================================================
+{
+	uint8_t header[EEP_HEADER_MAX];
+	uint8_t ucLen = EEPROM_SPI_BuildHeader(header, ucCmd, Addr);
+
+	for(uint8_t i = 0; i < ucLen; i++){
+		EEPROM_SoftSPI_SendByte(header[i]);
+	}
+}
+
 /**
   * @brief  it checks if spi interface is not busy
 	* @retval HAL_StatusTypeDef enum, HAL_OK in case of successful operation
@@ -514,7 +589,7 @@ __STATIC_INLINE uint8_t EEPROM_SoftSPI_RecvByte(void)
 HAL_StatusTypeDef EEPROM_SoftSPI_IsReady(void)
 //========================================================
 {
-	uint32_t tw = HAL_GetTick();
+	BSP_DeadlineTypeDef deadline = BSP_Deadline_After(WRITE_TIMEOUT_US);
 	uint8_t ucByte;
 
 	EEP_SPI_CS_LOW();
@@ -524,13 +599,46 @@ HAL_StatusTypeDef EEPROM_SoftSPI_IsReady(void)
 	{
 		ucByte = EEPROM_SoftSPI_RecvByte();
 		
-	} while((bitRead(ucByte, BIT_WIP) == 1) && (HAL_GetTick() < tw + WRITE_TIMEOUT_MS));
+	} while((bitRead(ucByte, BIT_WIP) == 1) && !BSP_Deadline_Expired(deadline));
 	
 	EEP_SPI_CS_HIGH();
 	
 	EEP_SEQ_DELAY(20);
 	
-	if(HAL_GetTick() >= tw + WRITE_TIMEOUT_MS) return HAL_ERROR;
+	if(bitRead(ucByte, BIT_WIP) == 1) return HAL_ERROR;
+
+	return HAL_OK;
+}
+
+/**
+  * @brief  reads the status register once, in a single short RDSR frame
+  * @param  pStatus: pointer to status variable
+	* @retval HAL_StatusTypeDef enum, HAL_OK in case of successful operation
+  */
+//===========================================================
+HAL_StatusTypeDef EEPROM_SoftSPI_ReadStatus(uint8_t* pStatus)
+//===========================================================
+{
+	EEP_SPI_CS_LOW();
+	EEPROM_SoftSPI_SendByte(CMD_RDSR);
+	*pStatus = EEPROM_SoftSPI_RecvByte();
+	EEP_SPI_CS_HIGH();
+
+	return HAL_OK;
+}
+
+/**
+  * @brief  sends a single byte instruction (WREN, WRDI) in its own CS frame
+  * @param  ucCmd: instruction code
+	* @retval HAL_StatusTypeDef enum, HAL_OK in case of successful operation
+  */
+//===========================================================
+HAL_StatusTypeDef EEPROM_SoftSPI_SendCommand(uint8_t ucCmd)
+//===========================================================
+{
+	EEP_SPI_CS_LOW();
+	EEPROM_SoftSPI_SendByte(ucCmd);
+	EEP_SPI_CS_HIGH();
 
 	return HAL_OK;
 }
@@ -542,12 +650,10 @@ HAL_StatusTypeDef EEPROM_SoftSPI_IsReady(void)
 	* @retval HAL_StatusTypeDef enum, HAL_OK in case of successful operation
   */
 //=================================================================================
-HAL_StatusTypeDef EEPROM_SoftSPI_WriteByte(uint16_t RegAdd, uint8_t RegData)
+HAL_StatusTypeDef EEPROM_SoftSPI_WriteByte(uint32_t RegAdd, uint8_t RegData)
 //=================================================================================	
 {
-	if(EEPROM_SoftSPI_IsReady() != HAL_OK){
-		if(EEPROM_SoftSPI_IsReady() != HAL_OK) return HAL_ERROR;
-	}
+	if(EEPROM_SPI_WaitReady() != HAL_OK) return HAL_ERROR;
 	
 	EEP_SPI_CS_LOW();
 	EEPROM_SoftSPI_SendByte(CMD_WREN);
@@ -556,17 +662,10 @@ HAL_StatusTypeDef EEPROM_SoftSPI_WriteByte(uint16_t RegAdd, uint8_t RegData)
 	EEP_SEQ_DELAY(20);
 	
 	EEP_SPI_CS_LOW();
-	EEPROM_SoftSPI_SendByte(CMD_WRITE);
-	EEPROM_SoftSPI_SendByte((uint8_t)(RegAdd >> 8) & 0xFF);
-	EEPROM_SoftSPI_SendByte((uint8_t)RegAdd & 0xFF);
+	EEPROM_SoftSPI_SendHeader(CMD_WRITE, RegAdd);
 	EEPROM_SoftSPI_SendByte(RegData);
 	EEP_SPI_CS_HIGH();
-
-	EEP_SEQ_DELAY(20);
-	
-	EEP_SPI_CS_LOW();
-	EEPROM_SoftSPI_SendByte(CMD_WRDI);
-	EEP_SPI_CS_HIGH();
+	EEPROM_SPI_WriteCycleStarted();
 
 	EEP_SEQ_DELAY(20);
 	
@@ -580,13 +679,13 @@ HAL_StatusTypeDef EEPROM_SoftSPI_WriteByte(uint16_t RegAdd, uint8_t RegData)
 	* @retval HAL_StatusTypeDef enum, HAL_OK in case of successful operation
   */
 //===============================================================================
-HAL_StatusTypeDef EEPROM_SoftSPI_ReadByte(uint16_t RegAdd, uint8_t* pData)
+HAL_StatusTypeDef EEPROM_SoftSPI_ReadByte(uint32_t RegAdd, uint8_t* pData)
 //===============================================================================	
 {
+	if(EEPROM_SPI_WaitReady() != HAL_OK) return HAL_ERROR;
+
 	EEP_SPI_CS_LOW();
-	EEPROM_SoftSPI_SendByte(CMD_READ);
-	EEPROM_SoftSPI_SendByte((uint8_t)(RegAdd >> 8) & 0xFF);
-	EEPROM_SoftSPI_SendByte((uint8_t)RegAdd & 0xFF);
+	EEPROM_SoftSPI_SendHeader(CMD_READ, RegAdd);
 	*pData = EEPROM_SoftSPI_RecvByte();
 	EEP_SPI_CS_HIGH();
 
@@ -606,9 +705,7 @@ HAL_StatusTypeDef EEPROM_SoftSPI_WriteStatusRegister(uint8_t regval)
 {
 	HAL_StatusTypeDef E2PStatus = HAL_OK;
 
-	if(EEPROM_SoftSPI_IsReady() != HAL_OK){
-		if(EEPROM_SoftSPI_IsReady() != HAL_OK) return HAL_ERROR;
-	}
+	if(EEPROM_SPI_WaitReady() != HAL_OK) return HAL_ERROR;
 	
 	EEP_SPI_CS_LOW();
 	EEPROM_SoftSPI_SendByte(CMD_WREN);
@@ -620,12 +717,7 @@ HAL_StatusTypeDef EEPROM_SoftSPI_WriteStatusRegister(uint8_t regval)
 	EEPROM_SoftSPI_SendByte(CMD_WRSR);
 	EEPROM_SoftSPI_SendByte(regval);
 	EEP_SPI_CS_HIGH();
-
-	EEP_SEQ_DELAY(20);
-	
-	EEP_SPI_CS_LOW();
-	EEPROM_SoftSPI_SendByte(CMD_WRDI);
-	EEP_SPI_CS_HIGH();
+	EEPROM_SPI_WriteCycleStarted();
 
 	EEP_SEQ_DELAY(20);
 	
@@ -635,52 +727,93 @@ HAL_StatusTypeDef EEPROM_SoftSPI_WriteStatusRegister(uint8_t regval)
 /**
   * @brief  reads number of bytes from eeprom 
   * @param  pBuffer: pointer to the data for read out
-  * @param  WriteAddr: read address of eeprom (16bit address space)
-  * @param  NumByteToRead: number of bytes for read  
+  * @param  WriteAddr: read address of eeprom (32bit address space)
+  * @param  NumByteToRead: number of bytes for read, the whole array if needed
 	* @retval HAL_StatusTypeDef enum, HAL_OK in case of successful operation
   */
 //==============================================================================================================
-HAL_StatusTypeDef EEPROM_SoftSPI_ReadBuffer(uint8_t* pBuffer, uint16_t ReadAddr, uint16_t NumByteToRead)
+HAL_StatusTypeDef EEPROM_SoftSPI_ReadBuffer(uint8_t* pBuffer, uint32_t ReadAddr, uint32_t NumByteToRead)
 //==============================================================================================================
 {
 	HAL_StatusTypeDef E2PStatus = HAL_OK;
 	
 	if(NumByteToRead == 0 || pBuffer == NULL) return HAL_ERROR;
 	
+	E2PStatus = EEPROM_SoftSPI_ReadStart(ReadAddr);
+	if(E2PStatus == HAL_OK) E2PStatus = EEPROM_SoftSPI_ReadNext(pBuffer, NumByteToRead);
+	EEPROM_SoftSPI_ReadStop();
+
+  return E2PStatus;
+}
+
+/**
+  * @brief  opens a continuous READ, the data is then clocked out in any number
+  *         of EEPROM_SoftSPI_ReadNext pieces until EEPROM_SoftSPI_ReadStop
+  * @param  ReadAddr: first address to read
+	* @retval HAL_StatusTypeDef enum, HAL_OK in case of successful operation
+  */
+//==============================================================================================================
+HAL_StatusTypeDef EEPROM_SoftSPI_ReadStart(uint32_t ReadAddr)
+//==============================================================================================================
+{
+	if(EEPROM_SPI_WaitReady() != HAL_OK) return HAL_ERROR;
+
 	EEP_SPI_CS_LOW();
-	EEPROM_SoftSPI_SendByte(CMD_READ);
-	EEPROM_SoftSPI_SendByte((uint8_t)(ReadAddr >> 8) & 0xFF);
-	EEPROM_SoftSPI_SendByte((uint8_t)(ReadAddr & 0xFF));
-	
-	for(uint16_t uCount = 0; uCount < NumByteToRead; uCount++, pBuffer++){
+	EEPROM_SoftSPI_SendHeader(CMD_READ, ReadAddr);
+
+	return HAL_OK;
+}
+
+/**
+  * @brief  reads the next bytes of a READ opened by EEPROM_SoftSPI_ReadStart
+  * @param  pBuffer: pointer to the data for read out
+  * @param  NumByteToRead: number of bytes for read
+	* @retval HAL_StatusTypeDef enum, HAL_OK in case of successful operation
+  */
+//==============================================================================================================
+HAL_StatusTypeDef EEPROM_SoftSPI_ReadNext(uint8_t* pBuffer, uint32_t NumByteToRead)
+//==============================================================================================================
+{
+#if (USE_SOFTSPI_WAVE == 1)
+	return EEPROM_Wave_Transfer(NULL, pBuffer, NumByteToRead);
+#else
+	for(uint32_t uCount = 0; uCount < NumByteToRead; uCount++, pBuffer++){
 		*pBuffer = EEPROM_SoftSPI_RecvByte();
 	}
-	
+
+	return HAL_OK;
+#endif
+}
+
+/**
+  * @brief  ends a READ opened by EEPROM_SoftSPI_ReadStart
+	* @retval none
+  */
+//==============================================
+void EEPROM_SoftSPI_ReadStop(void)
+//==============================================
+{
 	EEP_SPI_CS_HIGH();
 
 	EEP_SEQ_DELAY(20);
-
-  return E2PStatus;
 }
 
 /**
   * @brief  writes number of bytes in case they are page aligned 
   * @param  pBuffer: pointer to the data for write in
-  * @param  WriteAddr: write address of eeprom (16bit address space)
-  * @param  NumByteToWrite: number of bytes for write  
+  * @param  WriteAddr: write address of eeprom (32bit address space)
+  * @param  NumByteToWrite: number of bytes for write, up to the device page size
 	* @retval HAL_StatusTypeDef enum, HAL_OK in case of successful operation
   */
 //==============================================================================================================
-HAL_StatusTypeDef EEPROM_SoftSPI_WritePage(uint8_t* pBuffer, uint16_t WriteAddr, uint16_t NumByteToWrite)
+HAL_StatusTypeDef EEPROM_SoftSPI_WritePage(uint8_t* pBuffer, uint32_t WriteAddr, uint32_t NumByteToWrite)
 //==============================================================================================================	
 {
 	HAL_StatusTypeDef E2PStatus = HAL_OK;
 	
-	if(NumByteToWrite == 0 || pBuffer == NULL) return HAL_ERROR;
+	if(NumByteToWrite == 0 || NumByteToWrite > pEeprom->PageSize || pBuffer == NULL) return HAL_ERROR;
 	
-	if(EEPROM_SoftSPI_IsReady() != HAL_OK){
-		if(EEPROM_SoftSPI_IsReady() != HAL_OK) return HAL_ERROR;
-	}
+	if(EEPROM_SPI_WaitReady() != HAL_OK) return HAL_ERROR;
 	
 	EEP_SPI_CS_LOW();
 	EEPROM_SoftSPI_SendByte(CMD_WREN);
@@ -689,140 +822,463 @@ HAL_StatusTypeDef EEPROM_SoftSPI_WritePage(uint8_t* pBuffer, uint16_t WriteAddr,
 	EEP_SEQ_DELAY(20);
 	
 	EEP_SPI_CS_LOW();
-	EEPROM_SoftSPI_SendByte(CMD_WRITE);
-	EEPROM_SoftSPI_SendByte((uint8_t)(WriteAddr >> 8) & 0xFF);
-	EEPROM_SoftSPI_SendByte((uint8_t)(WriteAddr & 0xFF));
-	for(uint16_t uCount = 0; uCount < NumByteToWrite; uCount++, pBuffer++){
+	EEPROM_SoftSPI_SendHeader(CMD_WRITE, WriteAddr);
+#if (USE_SOFTSPI_WAVE == 1)
+	E2PStatus = EEPROM_Wave_Transfer(pBuffer, NULL, NumByteToWrite);
+#else
+	for(uint32_t uCount = 0; uCount < NumByteToWrite; uCount++, pBuffer++){
 		EEPROM_SoftSPI_SendByte(*pBuffer);
 	}
+#endif
 	EEP_SPI_CS_HIGH();
+	EEPROM_SPI_WriteCycleStarted();
 
 	EEP_SEQ_DELAY(20);	
 	
-	EEP_SPI_CS_LOW();
-	EEPROM_SoftSPI_SendByte(CMD_WRDI);
-	EEP_SPI_CS_HIGH();
-	
 	return E2PStatus;
 }
 
-/**
-  * @brief  writes any number of data to eeprom in PageWrite mode even if the buffer is not page aligned
-  * @param  pBuffer: pointer to the data for write in
-  * @param  WriteAddr: write address of eeprom (16bit address space)
-  * @param  NumByteToWrite: number of bytes for write  
+#endif   
+
+
+//=======================================================================================
+//=============================== Page chunked writes ===================================
+//=======================================================================================
+
+/**
+  * @brief  writes any number of data to eeprom in PageWrite mode even if the buffer is not page aligned
+  * @param  pBuffer: pointer to the data for write in
+  * @param  WriteAddr: write address of eeprom (32bit address space)
+  * @param  NumByteToWrite: number of bytes for write  
 	* @retval HAL_StatusTypeDef enum, HAL_OK in case of successful operation
   */
 //================================================================================================================
-HAL_StatusTypeDef EEPROM_SoftSPI_WriteBuffer(uint8_t* pBuffer, uint16_t WriteAddr, uint16_t NumByteToWrite)
-//=================================================================================================================	
+HAL_StatusTypeDef EEPROM_SPI_WriteBuffer(uint8_t* pBuffer, uint32_t WriteAddr, uint32_t NumByteToWrite)
+//================================================================================================================
 {
-	HAL_StatusTypeDef E2PStatus = HAL_ERROR;
-	
-  uint16_t NumOfPage = 0, NumOfSingle = 0, Addr = 0, count = 0, temp = 0;
-  uint16_t sEE_DataNum = 0;
+	HAL_StatusTypeDef E2PStatus = HAL_OK;
+	EEP_ChunkPlanTypeDef plan;
 
-  Addr = WriteAddr % EEP_SPI_PAGESIZE;
-  count = EEP_SPI_PAGESIZE - Addr;
-  NumOfPage =  NumByteToWrite / EEP_SPI_PAGESIZE;
-  NumOfSingle = NumByteToWrite % EEP_SPI_PAGESIZE;
+	if(NumByteToWrite == 0 || pBuffer == NULL) return HAL_ERROR;
 
-	if(EEPROM_SoftSPI_IsReady() != HAL_OK){
-		if(EEPROM_SoftSPI_IsReady() != HAL_OK) return HAL_ERROR;
+	EEPROM_SPI_PlanInit(&plan, WriteAddr, NumByteToWrite, pEeprom->PageSize);
+	while((E2PStatus == HAL_OK) && EEPROM_SPI_PlanNext(&plan))
+	{
+		E2PStatus = EEPROM_SPI_WritePage(&pBuffer[plan.Offset], plan.Addr, plan.Len);
 	}
-		
-  if(Addr == 0)
-	{ // WriteAddr is EEPROM_PAGESIZE aligned 
-      if(NumOfPage == 0)
-			{ // NumByteToWrite < EEPROM_PAGESIZE
-          sEE_DataNum = NumByteToWrite;
-          E2PStatus = EEPROM_SoftSPI_WritePage(pBuffer, WriteAddr, sEE_DataNum);
-          if (E2PStatus != HAL_OK) return E2PStatus;
-
-      } 
-			else
-			{ // NumByteToWrite > EEPROM_PAGESIZE
-          while (NumOfPage--)
-					{
-              sEE_DataNum = EEP_SPI_PAGESIZE;
-              E2PStatus = EEPROM_SoftSPI_WritePage(pBuffer, WriteAddr, sEE_DataNum);
-              if (E2PStatus != HAL_OK) return E2PStatus;
-
-              WriteAddr +=  EEP_SPI_PAGESIZE;
-              pBuffer += EEP_SPI_PAGESIZE;
-          }
-
-          sEE_DataNum = NumOfSingle;
-          E2PStatus = EEPROM_SoftSPI_WritePage(pBuffer, WriteAddr, sEE_DataNum);
-
-          if (E2PStatus != HAL_OK) return E2PStatus;
-      }
-  }
-	else
-	{ // WriteAddr is not EEPROM_PAGESIZE aligned
-      if (NumOfPage == 0)
-			{ // NumByteToWrite < EEPROM_PAGESIZE
-          if (NumOfSingle > count)
-					{ // (NumByteToWrite + WriteAddr) > EEPROM_PAGESIZE
-              temp = NumOfSingle - count;
-              sEE_DataNum = count;
-              E2PStatus = EEPROM_SoftSPI_WritePage(pBuffer, WriteAddr, sEE_DataNum);
-              if (E2PStatus != HAL_OK) return E2PStatus;
-
-              WriteAddr +=  count;
-              pBuffer += count;
-
-              sEE_DataNum = temp;
-              E2PStatus = EEPROM_SoftSPI_WritePage(pBuffer, WriteAddr, sEE_DataNum);
-          } else
-					{
-              sEE_DataNum = NumByteToWrite;
-              E2PStatus = EEPROM_SoftSPI_WritePage(pBuffer, WriteAddr, sEE_DataNum);
-          }
-          if (E2PStatus != HAL_OK) return E2PStatus;
-      }
-			else
-			{ //NumByteToWrite > EEPROM_PAGESIZE
-          NumByteToWrite -= count;
-          NumOfPage =  NumByteToWrite / EEP_SPI_PAGESIZE;
-          NumOfSingle = NumByteToWrite % EEP_SPI_PAGESIZE;
-
-          sEE_DataNum = count;
-
-          E2PStatus = EEPROM_SoftSPI_WritePage(pBuffer, WriteAddr, sEE_DataNum);
-          if (E2PStatus != HAL_OK) return E2PStatus;
-
-          WriteAddr +=  count;
-          pBuffer += count;
-
-          while (NumOfPage--)
-					{
-              sEE_DataNum = EEP_SPI_PAGESIZE;
-
-							E2PStatus = EEPROM_SoftSPI_WritePage(pBuffer, WriteAddr, sEE_DataNum);
-							if (E2PStatus != HAL_OK) return E2PStatus;
-
-              WriteAddr +=  EEP_SPI_PAGESIZE;
-              pBuffer += EEP_SPI_PAGESIZE;
-          }
-
-          if (NumOfSingle != 0)
-					{
-              sEE_DataNum = NumOfSingle;
-
-              E2PStatus = EEPROM_SoftSPI_WritePage(pBuffer, WriteAddr, sEE_DataNum);
-							if (E2PStatus != HAL_OK) return E2PStatus;
-          }
-      }
-  }
 
-  return HAL_OK;
+	return E2PStatus;
 }
 
-#endif   
 
+//=======================================================================================
+//====================== Write cycle tracking and tWC estimation ========================
+//=======================================================================================
+
+/**
+  * @brief  marks the start of an internal write cycle, call it right after the
+  *         CS rising edge that terminates a WRITE or WRSR instruction
+	* @retval none
+  */
+//==============================================
+void EEPROM_SPI_WriteCycleStarted(void)
+//==============================================
+{
+	pEeprom->WriteStartUs = BSP_GetMicros();
+	pEeprom->WriteBusy = 1;
+	pEeprom->LastBusyUs = 0;
+	pEeprom->WriteCycles++;
+}
+
+/**
+  * @brief  folds one observed write cycle time into the tWC estimate
+  * @param  iSample: observed cycle time in microseconds
+	* @retval none
+  */
+//==============================================
+static void EEPROM_SPI_LearnTwc(int32_t iSample)
+//==============================================
+{
+	int32_t iErr;
+
+	if(iSample < 0) iSample = 0;
+	if(iSample > (int32_t)pEeprom->TwcMaxUs) iSample = (int32_t)pEeprom->TwcMaxUs;
+
+	iErr = iSample - (int32_t)pEeprom->TwcEstUs;
+	pEeprom->TwcEstUs = (uint32_t)((int32_t)pEeprom->TwcEstUs + iErr / EEP_TWC_EST_GAIN);
+
+	if(iErr < 0) iErr = -iErr;
+	pEeprom->TwcDevUs = (uint32_t)((int32_t)pEeprom->TwcDevUs + (iErr - (int32_t)pEeprom->TwcDevUs) / EEP_TWC_DEV_GAIN);
+	if(pEeprom->TwcDevUs < EEP_TWC_POLL_STEP_US) pEeprom->TwcDevUs = EEP_TWC_POLL_STEP_US;
+}
+
+/**
+  * @brief  cycle time at which polling WIP starts to be worth it
+	* @retval microseconds after the start of the write cycle
+  */
+//==============================================
+static uint32_t EEPROM_SPI_FirstPollUs(void)
+//==============================================
+{
+	return (pEeprom->TwcEstUs > pEeprom->TwcDevUs) ? (pEeprom->TwcEstUs - pEeprom->TwcDevUs) : 0;
+}
+
+/**
+  * @brief  idles until a deadline as selected by the device wait mode
+  * @param  deadline: absolute time stamp to wait for
+	* @retval none
+  */
+//==============================================
+static void EEPROM_SPI_WaitUntil(BSP_DeadlineTypeDef deadline)
+//==============================================
+{
+	uint32_t uwStart = BSP_GetMicros();
+
+	if(pEeprom->WaitMode == EEP_WAIT_SLEEP){
+		BSP_Timebase_SleepUntil(deadline);
+		pEeprom->WaitSleepUs += BSP_GetMicros() - uwStart;
+	}
+	else{
+		BSP_DelayUs(BSP_Deadline_Remaining(deadline), NONE_BLOCKING);
+		pEeprom->WaitAwakeUs += BSP_GetMicros() - uwStart;
+	}
+}
+
+/**
+  * @brief  waits for the pending write cycle, if any: idles until just before
+  *         the predicted completion, then polls WIP every EEP_TWC_POLL_STEP_US.
+  *         EEP_WAIT_SLEEP spends the same idle times in sleep instead of a busy
+  *         delay; polling early in both modes keeps the estimate able to drop.
+	* @retval HAL_StatusTypeDef enum, HAL_OK in case of successful operation
+  */
+//==============================================
+HAL_StatusTypeDef EEPROM_SPI_WaitReady(void)
+//==============================================
+{
+	BSP_DeadlineTypeDef deadline;
+	uint32_t uwFirstPoll, uwElapsed, uwLastBusy = 0, uwPolls = 0;
+	uint8_t ucStatus = 0;
+
+	if(pEeprom->WriteBusy == 0) return HAL_OK;
+
+	// Idle until the first poll is worth doing
+	uwFirstPoll = EEPROM_SPI_FirstPollUs();
+	EEPROM_SPI_WaitUntil(pEeprom->WriteStartUs + uwFirstPoll);
+
+	// Then poll with short RDSR frames, leaving the bus free in between
+	deadline = pEeprom->WriteStartUs + WRITE_TIMEOUT_US;
+	for(;;)
+	{
+		if(EEPROM_SPI_ReadStatus(&ucStatus) != HAL_OK) return HAL_ERROR;
+		uwElapsed = BSP_GetMicros() - pEeprom->WriteStartUs;
+		uwPolls++;
+
+		if(bitRead(ucStatus, BIT_WIP) == 0) break;
+		if(BSP_Deadline_Expired(deadline)){
+			pEeprom->StatusPolls += uwPolls;
+			return HAL_TIMEOUT;
+		}
+
+		uwLastBusy = uwElapsed;
+		EEPROM_SPI_WaitUntil(BSP_Deadline_After(EEP_TWC_POLL_STEP_US));
+	}
+
+	pEeprom->WriteBusy = 0;
+	pEeprom->StatusPolls += uwPolls;
+
+	// Completion lies between the last busy poll and this one. If the very first
+	// poll already saw it done we only know an upper bound, so nudge the estimate
+	// down, unless the caller came back late and the sample says nothing at all.
+	if(uwPolls > 1){
+		EEPROM_SPI_LearnTwc((int32_t)((uwLastBusy + uwElapsed) / 2));
+	}
+	else if(uwElapsed <= uwFirstPoll + 2 * EEP_TWC_POLL_STEP_US){
+		EEPROM_SPI_LearnTwc((int32_t)uwElapsed - (int32_t)EEP_TWC_POLL_STEP_US);
+	}
+
+	return HAL_OK;
+}
+
+/**
+  * @brief  non-blocking variant of EEPROM_SPI_WaitReady, it never idles and only
+  *         spends an RDSR once the predicted tWC is near
+	* @retval HAL_OK when ready, HAL_BUSY while the write cycle runs, HAL_TIMEOUT/HAL_ERROR on failure
+  */
+//==============================================
+HAL_StatusTypeDef EEPROM_SPI_PollReady(void)
+//==============================================
+{
+	uint32_t uwElapsed;
+	uint8_t ucStatus = 0;
+
+	if(pEeprom->WriteBusy == 0) return HAL_OK;
+
+	uwElapsed = BSP_GetMicros() - pEeprom->WriteStartUs;
+	if(uwElapsed < EEPROM_SPI_FirstPollUs()) return HAL_BUSY;
+
+	if(EEPROM_SPI_ReadStatus(&ucStatus) != HAL_OK) return HAL_ERROR;
+	uwElapsed = BSP_GetMicros() - pEeprom->WriteStartUs;
+	pEeprom->StatusPolls++;
+
+	if(bitRead(ucStatus, BIT_WIP) != 0){
+		if(uwElapsed >= WRITE_TIMEOUT_US) return HAL_TIMEOUT;
+		pEeprom->LastBusyUs = uwElapsed;
+		return HAL_BUSY;
+	}
+
+	pEeprom->WriteBusy = 0;
+
+	// Other chips decide when we get polled, so only a tight bracket is a usable sample
+	if(pEeprom->LastBusyUs != 0){
+		if(uwElapsed - pEeprom->LastBusyUs <= 2 * EEP_TWC_POLL_STEP_US){
+			EEPROM_SPI_LearnTwc((int32_t)((pEeprom->LastBusyUs + uwElapsed) / 2));
+		}
+	}
+	else if(uwElapsed <= EEPROM_SPI_FirstPollUs() + 2 * EEP_TWC_POLL_STEP_US){
+		EEPROM_SPI_LearnTwc((int32_t)uwElapsed - (int32_t)EEP_TWC_POLL_STEP_US);
+	}
+
+	return HAL_OK;
+}
+
+
+//=======================================================================================
+//=========================== Multi chip write interleaving =============================
+//=======================================================================================
+
+/**
+  * @brief  makes a device the target of all following EEPROM_SPI_ calls, each
+  *         device keeps its own chip select, clock step and write cycle state
+  * @param  pDevice: device handle, the chips share SCK/MOSI/MISO
+	* @retval HAL_StatusTypeDef enum, HAL_OK in case of successful operation
+  */
+//===========================================================
+HAL_StatusTypeDef EEPROM_SPI_Select(EEP_DeviceTypeDef* pDevice)
+//===========================================================
+{
+	if(pDevice == NULL) return HAL_ERROR;
+	if(pDevice == pEeprom) return HAL_OK;
+
+	// the bus clock goes with the device, it may have calibrated differently
+	if(pDevice->ClkStep != pEeprom->ClkStep){
+		pEeprom = pDevice;
+		return EEPROM_SPI_SetClock(pDevice->ClkStep);
+	}
+
+	pEeprom = pDevice;
+	return HAL_OK;
+}
+
+/**
+  * @brief  writes several buffers, each to its own chip, overlapping their write
+  *         cycles: while one chip is programming a page the next one is loaded.
+  *         Jobs for the same chip run one after another, so a striped volume just
+  *         passes one job per chip. Write cycles may still run on return.
+  * @param  pJobs: job list, updated in place while it progresses
+  * @param  ucCount: number of jobs
+	* @retval HAL_StatusTypeDef enum, HAL_OK in case of successful operation
+  */
+//==================================================================================
+HAL_StatusTypeDef EEPROM_SPI_MultiWrite(EEP_WriteJobTypeDef* pJobs, uint8_t ucCount)
+//==================================================================================
+{
+	HAL_StatusTypeDef E2PStatus = HAL_OK;
+	EEP_DeviceTypeDef* pSaved = pEeprom;
+	EEP_WriteJobTypeDef* pJob;
+	BSP_DeadlineTypeDef wake, due;
+	uint32_t uwChunk;
+	uint8_t ucPending, ucProgress, ucClaimed;
+
+	do
+	{
+		ucPending = 0;
+		ucProgress = 0;
+		wake = BSP_Deadline_After(WRITE_TIMEOUT_US);
+
+		for(uint8_t i = 0; (i < ucCount) && (E2PStatus == HAL_OK); i++)
+		{
+			pJob = &pJobs[i];
+			if(pJob->NumByteToWrite == 0) continue;
+			ucPending = 1;
+
+			// an earlier unfinished job owns the chip
+			ucClaimed = 0;
+			for(uint8_t j = 0; j < i; j++){
+				if((pJobs[j].pDevice == pJob->pDevice) && (pJobs[j].NumByteToWrite != 0)) ucClaimed = 1;
+			}
+			if(ucClaimed) continue;
+
+			E2PStatus = EEPROM_SPI_Select(pJob->pDevice);
+			if(E2PStatus == HAL_OK) E2PStatus = EEPROM_SPI_PollReady();
+
+			if(E2PStatus == HAL_BUSY)
+			{
+				// remember the soonest moment any chip is worth polling again
+				due = pEeprom->WriteStartUs + EEPROM_SPI_FirstPollUs();
+				if(BSP_Deadline_Expired(due)) due = BSP_Deadline_After(EEP_TWC_POLL_STEP_US);
+				if((int32_t)(due - wake) < 0) wake = due;
+				E2PStatus = HAL_OK;
+				continue;
+			}
+			if(E2PStatus != HAL_OK) break;
+
+			uwChunk = EEP_CHUNK_LEN(pJob->WriteAddr, pJob->NumByteToWrite, pEeprom->PageSize);
+
+			E2PStatus = EEPROM_SPI_WritePage(pJob->pBuffer, pJob->WriteAddr, uwChunk);
+			pJob->pBuffer += uwChunk;
+			pJob->WriteAddr += uwChunk;
+			pJob->NumByteToWrite -= uwChunk;
+			ucProgress = 1;
+		}
+
+		// every pending chip is inside its write cycle, the bus has nothing to do
+		if(ucPending && !ucProgress && (E2PStatus == HAL_OK)) EEPROM_SPI_WaitUntil(wake);
+
+	} while(ucPending && (E2PStatus == HAL_OK));
+
+	if(EEPROM_SPI_Select(pSaved) != HAL_OK) E2PStatus = HAL_ERROR;
+	return E2PStatus;
+}
+
+
+//=======================================================================================
+//=================================== Data integrity ====================================
+//=======================================================================================
+
+/**
+  * @brief  CRC-16/CCITT (poly 0x1021), can be run piecewise over a stream
+  * @param  uiCrc: 0xFFFF for a new stream, else the previous result
+  * @param  pData: data to run over
+  * @param  uwLen: number of bytes
+	* @retval updated crc
+  */
+//====================================================================================
+uint16_t EEPROM_SPI_Crc16(uint16_t uiCrc, const uint8_t* pData, uint32_t uwLen)
+//====================================================================================
+{
+	while(uwLen--)
+	{
+		uiCrc ^= (uint16_t)(*pData++) << 8;
+		for(uint8_t i = 0; i < 8; i++){
+			uiCrc = (uiCrc & 0x8000) ? (uint16_t)((uiCrc << 1) ^ 0x1021) : (uint16_t)(uiCrc << 1);
+		}
+	}
+
+	return uiCrc;
+}
+
+//=======================================================================================
+//=============================== Bus clock calibration =================================
+//=======================================================================================
+
+/**
+  * @brief  bit transitions of a buffer as it is shifted out MSB first, a window
+  *         without them reads the same at any clock and cannot show errors
+  * @param  pBuf: data
+  * @param  uiLen: bytes
+	* @retval number of 0/1 edges
+  */
+//========================================================================
+static uint16_t EEPROM_SPI_CalEdges(const uint8_t* pBuf, uint16_t uiLen)
+//========================================================================
+{
+	uint16_t uiEdges = 0;
+	uint8_t ucDiff;
+
+	for(uint16_t i = 0; i < uiLen; i++)
+	{
+		if(i > 0 && ((pBuf[i - 1] ^ (pBuf[i] >> 7)) & 0x01)) uiEdges++;
+		for(ucDiff = (uint8_t)((pBuf[i] ^ (pBuf[i] >> 1)) & 0x7F); ucDiff != 0; ucDiff &= (uint8_t)(ucDiff - 1)) uiEdges++;
+	}
+
+	return uiEdges;
+}
+
+/**
+  * @brief  reads the reference window and the status register back at the current clock
+  * @param  uwAddr: address of the reference window
+  * @param  pRef: expected window content
+  * @param  uiLen: window length, up to EEP_CAL_PAGE_MAX
+  * @param  ucRefStatus: expected status register
+	* @retval HAL_OK if both match
+  */
+//========================================================================================================================
+static HAL_StatusTypeDef EEPROM_SPI_CalVerify(uint32_t uwAddr, const uint8_t* pRef, uint16_t uiLen, uint8_t ucRefStatus)
+//========================================================================================================================
+{
+	uint8_t ucBuf[EEP_CAL_PAGE_MAX];
+	uint8_t ucStatus = 0;
+
+	if(EEPROM_SPI_ReadBuffer(ucBuf, uwAddr, uiLen) != HAL_OK) return HAL_ERROR;
+	if(memcmp(ucBuf, pRef, uiLen) != 0) return HAL_ERROR;
+	if(EEPROM_SPI_ReadStatus(&ucStatus) != HAL_OK) return HAL_ERROR;
+	if(ucStatus != ucRefStatus) return HAL_ERROR;
+
+	return HAL_OK;
+}
+
+/**
+  * @brief  finds the fastest bus clock that reads back a reference window
+  *         EEP_CAL_VERIFY_COUNT times in a row, backs off EEP_CAL_MARGIN_STEPS
+  *         and keeps the result in the device. Nothing is written: the
+  *         reference is the page of the first EEP_CAL_SCAN_PAGES with the most
+  *         bit edges as read at the slowest clock, together with the status
+  *         register. A part without such data, e.g. a blank one, keeps the
+  *         slowest clock until the next calibration finds some.
+	* @retval HAL_StatusTypeDef enum, HAL_OK in case of successful operation
+  */
+//=================================================
+HAL_StatusTypeDef EEPROM_SPI_CalibrateClock(void)
+//=================================================
+{
+	uint8_t ucRef[EEP_CAL_PAGE_MAX], ucBuf[EEP_CAL_PAGE_MAX];
+	uint16_t uiLen = (pEeprom->PageSize < EEP_CAL_PAGE_MAX) ? pEeprom->PageSize : EEP_CAL_PAGE_MAX;
+	uint16_t uiEdges, uiBest = 0;
+	uint32_t uwAddr = 0, uwPages;
+	uint8_t ucRefStatus = 0;
+	uint8_t ucStep, ucPass;
+
+	// Reference readback at the slowest (known good) clock
+	EEPROM_SPI_SetClock(EEP_CLK_STEPS - 1);
+	if(EEPROM_SPI_WaitReady() != HAL_OK) return HAL_ERROR;
+	if(EEPROM_SPI_ReadStatus(&ucRefStatus) != HAL_OK) return HAL_ERROR;
+
+	uwPages = pEeprom->Capacity / uiLen;
+	if(uwPages > EEP_CAL_SCAN_PAGES) uwPages = EEP_CAL_SCAN_PAGES;
+	for(uint32_t p = 0; p < uwPages; p++)
+	{
+		if(EEPROM_SPI_ReadBuffer(ucBuf, p * uiLen, uiLen) != HAL_OK) return HAL_ERROR;
+		uiEdges = EEPROM_SPI_CalEdges(ucBuf, uiLen);
+		if(uiEdges > uiBest){
+			uiBest = uiEdges;
+			uwAddr = p * uiLen;
+			memcpy(ucRef, ucBuf, uiLen);
+		}
+	}
+
+	if(uiBest < EEP_CAL_MIN_EDGES){
+		EEP_LOG("EEPROM clock calibration: no data to check against, step %d kept\r\n", EEP_CLK_STEPS - 1);
+		return HAL_OK;
+	}
+	if(EEPROM_SPI_CalVerify(uwAddr, ucRef, uiLen, ucRefStatus) != HAL_OK) return HAL_ERROR;
+
+	// Sweep from the fastest clock down, the first step that holds wins
+	for(ucStep = 0; ucStep < EEP_CLK_STEPS - 1; ucStep++)
+	{
+		EEPROM_SPI_SetClock(ucStep);
+		for(ucPass = 0; ucPass < EEP_CAL_VERIFY_COUNT; ucPass++){
+			if(EEPROM_SPI_CalVerify(uwAddr, ucRef, uiLen, ucRefStatus) != HAL_OK) break;
+		}
+		if(ucPass == EEP_CAL_VERIFY_COUNT) break;
+	}
+
+	ucStep += EEP_CAL_MARGIN_STEPS;
+	if(ucStep > EEP_CLK_STEPS - 1) ucStep = EEP_CLK_STEPS - 1;
+
+	EEP_LOG("EEPROM clock calibrated to step %d\r\n", ucStep);
+	return EEPROM_SPI_SetClock(ucStep);
+}
 
-#include "string.h"
 #include "stdlib.h"	
 
 #define READ_WRITE_NUM 						 	(uint8_t)40
@@ -942,6 +1398,317 @@ HAL_StatusTypeDef EEPROM_SPI_MultipleReadWriteTest(uint8_t eraseFlag)
 	return E2PStatus;
 }
 
+/**
+  * @brief  runs one benchmark pass of EEP_BENCH_PAGES page writes
+  * @param  mode: write cycle wait mode under test
+  * @param  pBuf: one page of pattern data
+	* @retval HAL_StatusTypeDef enum, HAL_OK in case of successful operation
+  */
+//=====================================================================================
+static HAL_StatusTypeDef EEPROM_SPI_BenchmarkPass(EEP_WaitModeTypeDef mode, uint8_t* pBuf)
+//=====================================================================================
+{
+	HAL_StatusTypeDef E2PStatus = HAL_OK;
+	uint32_t uwStart, uwTotal, uwPolls, uwSleep, uwAwake, uwActive, uwEnergy;
+
+	pEeprom->WaitMode = mode;
+	pEeprom->StatusPolls = 0;
+	pEeprom->WaitSleepUs = 0;
+	pEeprom->WaitAwakeUs = 0;
+
+	uwStart = BSP_GetMicros();
+	for(uint16_t i = 0; (i < EEP_BENCH_PAGES) && (E2PStatus == HAL_OK); i++){
+		E2PStatus = EEPROM_SPI_WritePage(pBuf, READ_WRITE_ADDRESS + i * EEP_SPI_PAGESIZE, EEP_SPI_PAGESIZE);
+	}
+	if(E2PStatus == HAL_OK) E2PStatus = EEPROM_SPI_WaitReady();
+	uwTotal = BSP_GetMicros() - uwStart;
+
+	uwPolls = pEeprom->StatusPolls;
+	uwSleep = pEeprom->WaitSleepUs;
+	uwAwake = pEeprom->WaitAwakeUs;
+	uwActive = uwTotal - uwSleep;
+
+	// nJ = mV * uA * us / 1e6, pre-scaled so it stays within 32bit
+	uwEnergy = (EEP_BENCH_VDD_MV / 10) * ((EEP_BENCH_RUN_UA / 100) * (uwActive / EEP_BENCH_PAGES) +
+						 (EEP_BENCH_SLEEP_UA / 100) * (uwSleep / EEP_BENCH_PAGES)) / 1000;
+
+	EEP_LOG("%s: %lu us/page, %lu.%02lu RDSR/page, tWC est %lu us\r\n",
+					(mode == EEP_WAIT_SLEEP) ? "SLEEP" : "POLL ",
+					(unsigned long)(uwTotal / EEP_BENCH_PAGES), (unsigned long)(uwPolls / EEP_BENCH_PAGES),
+					(unsigned long)((uwPolls * 100 / EEP_BENCH_PAGES) % 100), (unsigned long)pEeprom->TwcEstUs);
+	EEP_LOG("       sleep %lu us, awake wait %lu us, wakeup latency %lu us, ~%lu nJ/page\r\n\r\n",
+					(unsigned long)uwSleep, (unsigned long)uwAwake,
+					(unsigned long)BSP_Timebase_GetWakeLatency(), (unsigned long)uwEnergy);
+
+	return E2PStatus;
+}
+
+/**
+  * @brief  benchmarks page writes with the polled and the sleeping wait strategies
+	* @retval HAL_StatusTypeDef enum, HAL_OK in case of successful operation
+  */
+//===================================================================
+HAL_StatusTypeDef EEPROM_SPI_BenchmarkTest(void)
+//===================================================================
+{
+	HAL_StatusTypeDef E2PStatus = HAL_ERROR;
+	EEP_WaitModeTypeDef savedMode = pEeprom->WaitMode;
+	uint8_t ucBuf[EEP_SPI_PAGESIZE];
+
+	EEPROM_SPI_Init();
+
+	if(EEPROM_SPI_IsReady() == HAL_OK)
+	{
+		EEP_LOG("EEPROM Write Cycle Benchmark, %d pages :\r\n\r\n", EEP_BENCH_PAGES);
+		memset(ucBuf, 0x5A, sizeof(ucBuf));
+
+		// Each mode starts from an untrained estimator, its first pass shows the learning
+		E2PStatus = HAL_OK;
+		for(uint8_t ucMode = EEP_WAIT_POLL; (ucMode <= EEP_WAIT_SLEEP) && (E2PStatus == HAL_OK); ucMode++)
+		{
+			pEeprom->TwcEstUs = pEeprom->TwcMaxUs;
+			pEeprom->TwcDevUs = pEeprom->TwcMaxUs / 2;
+			E2PStatus = EEPROM_SPI_BenchmarkPass((EEP_WaitModeTypeDef)ucMode, ucBuf);
+			if(E2PStatus == HAL_OK) E2PStatus = EEPROM_SPI_BenchmarkPass((EEP_WaitModeTypeDef)ucMode, ucBuf);
+		}
+#if (USE_HARDSPI_IT == 1)
+		if(E2PStatus == HAL_OK) E2PStatus = EEPROM_SpiIT_Benchmark();
+#endif
+	}
+
+	pEeprom->WaitMode = savedMode;
+	return E2PStatus;
+}
+
+/**
+  * @brief  benchmarks interleaved page writes on 1..ucCount chips, the aggregate
+  *         time per page should drop close to 1/n of the single chip figure.
+  *         Every chip gets its own data on each pass and is read back, so a
+  *         page that went to the wrong chip select fails the test
+  * @param  pDevices: device handles, one per chip select
+  * @param  ucCount: number of devices, up to EEP_MAX_DEVICES
+	* @retval HAL_StatusTypeDef enum, HAL_OK in case of successful operation
+  */
+//==========================================================================================
+HAL_StatusTypeDef EEPROM_SPI_InterleaveTest(EEP_DeviceTypeDef* pDevices[], uint8_t ucCount)
+//==========================================================================================
+{
+	HAL_StatusTypeDef E2PStatus = HAL_OK;
+	EEP_DeviceTypeDef* pSaved = pEeprom;
+	EEP_WriteJobTypeDef jobs[EEP_MAX_DEVICES];
+	uint8_t ucBuf[EEP_MAX_DEVICES][EEP_SPI_PAGESIZE];
+	uint8_t ucBack[EEP_SPI_PAGESIZE];
+	uint32_t uwStart, uwTotal, uwSingle = 0;
+
+	if(ucCount == 0 || ucCount > EEP_MAX_DEVICES) return HAL_ERROR;
+
+	EEP_LOG("EEPROM Interleaved Write Benchmark, %d pages per chip :\r\n\r\n", EEP_BENCH_PAGES);
+
+	for(uint8_t n = 1; (n <= ucCount) && (E2PStatus == HAL_OK); n++)
+	{
+		uwStart = BSP_GetMicros();
+		for(uint16_t i = 0; (i < EEP_BENCH_PAGES) && (E2PStatus == HAL_OK); i++)
+		{
+			for(uint8_t d = 0; d < n; d++){
+				for(uint16_t j = 0; j < EEP_SPI_PAGESIZE; j++) ucBuf[d][j] = (uint8_t)(n * 61 + d * 37 + i * 11 + j);
+				jobs[d].pDevice = pDevices[d];
+				jobs[d].pBuffer = ucBuf[d];
+				jobs[d].WriteAddr = READ_WRITE_ADDRESS + i * pDevices[d]->PageSize;
+				jobs[d].NumByteToWrite = EEP_SPI_PAGESIZE;
+			}
+			E2PStatus = EEPROM_SPI_MultiWrite(jobs, n);
+		}
+
+		// include the last write cycles of every chip
+		for(uint8_t d = 0; (d < n) && (E2PStatus == HAL_OK); d++){
+			E2PStatus = EEPROM_SPI_Select(pDevices[d]);
+			if(E2PStatus == HAL_OK) E2PStatus = EEPROM_SPI_WaitReady();
+		}
+		uwTotal = (BSP_GetMicros() - uwStart) / (EEP_BENCH_PAGES * n);
+		if(uwTotal == 0) uwTotal = 1;
+		if(n == 1) uwSingle = uwTotal;
+
+		for(uint8_t d = 0; (d < n) && (E2PStatus == HAL_OK); d++)
+		{
+			E2PStatus = EEPROM_SPI_Select(pDevices[d]);
+			for(uint16_t i = 0; (i < EEP_BENCH_PAGES) && (E2PStatus == HAL_OK); i++)
+			{
+				E2PStatus = EEPROM_SPI_ReadBuffer(ucBack, READ_WRITE_ADDRESS + i * pDevices[d]->PageSize, EEP_SPI_PAGESIZE);
+				for(uint16_t j = 0; (j < EEP_SPI_PAGESIZE) && (E2PStatus == HAL_OK); j++){
+					if(ucBack[j] != (uint8_t)(n * 61 + d * 37 + i * 11 + j)) E2PStatus = HAL_ERROR;
+				}
+			}
+		}
+
+		EEP_LOG("%d chip(s): %lu us/page aggregate, speedup x%lu.%02lu %s\r\n", n, (unsigned long)uwTotal,
+						(unsigned long)(uwSingle / uwTotal), (unsigned long)((uwSingle * 100 / uwTotal) % 100),
+						(E2PStatus == HAL_OK) ? "Passed" : "Failed");
+	}
+
+	if(EEPROM_SPI_Select(pSaved) != HAL_OK) E2PStatus = HAL_ERROR;
+	return E2PStatus;
+}
+
+//=======================================================================================
+//=============================== Bus probe and detection ===============================
+//=======================================================================================
+
+/**
+  * @brief  reads SO with the internal pull set one way, the chip being deselected.
+  *         The pull configuration is restored afterwards.
+  * @param  uwPull: GPIO_PULLUP or GPIO_PULLDOWN
+	* @retval level seen on SO
+  */
+//====================================================
+static uint8_t EEPROM_SPI_SampleSO(uint32_t uwPull)
+//====================================================
+{
+#ifdef BSP_EEPROM_SIM
+	return EEPROM_Sim_SampleSO(uwPull == GPIO_PULLUP);
+#else
+	uint32_t uwSavedPull = EEP_MISO_GPIO_Port->PUPDR;
+	uint32_t uwPos = 0;
+	uint8_t ucLevel;
+
+	while(((EEP_MISO_Pin >> uwPos) & 1U) == 0) uwPos++;
+
+	MODIFY_REG(EEP_MISO_GPIO_Port->PUPDR, GPIO_PUPDR_PUPDR0 << (uwPos * 2), uwPull << (uwPos * 2));
+	BSP_DelayUs(EEP_PROBE_SETTLE_US, BLOCKING);
+
+	ucLevel = (HAL_GPIO_ReadPin(EEP_MISO_GPIO_Port, EEP_MISO_Pin) == GPIO_PIN_SET) ? 1 : 0;
+	EEP_MISO_GPIO_Port->PUPDR = uwSavedPull;
+
+	return ucLevel;
+#endif
+}
+
+/**
+  * @brief  fast presence check of the selected chip, a few hundred microseconds
+  *         at most. SO must float while CS is high (a line that ignores the
+  *         internal pulls is stuck or shorted), then the volatile WEL bit must
+  *         follow a WREN / WRDI round trip with the reserved bits reading 0.
+	* @retval HAL_OK if a chip answers, HAL_ERROR otherwise
+  */
+//==============================================
+HAL_StatusTypeDef EEPROM_SPI_Probe(void)
+//==============================================
+{
+	BSP_DeadlineTypeDef deadline;
+	uint8_t ucHigh, ucLow, ucStatus;
+
+	EEP_SPI_CS_HIGH();
+	ucHigh = EEPROM_SPI_SampleSO(GPIO_PULLUP);
+	ucLow = EEPROM_SPI_SampleSO(GPIO_PULLDOWN);
+
+	if(ucHigh == 0 || ucLow == 1){
+		EEP_LOG("EEPROM probe: SO stuck %s\r\n", (ucHigh == 0) ? "low" : "high");
+		return HAL_ERROR;
+	}
+
+	// a write cycle still running from before the reset ignores WREN, let it finish first
+	deadline = BSP_Deadline_After(pEeprom->TwcMaxUs);
+	for(;;)
+	{
+		if(EEPROM_SPI_ReadStatus(&ucStatus) != HAL_OK) return HAL_ERROR;
+		if(bitRead(ucStatus, BIT_WIP) == 0 || BSP_Deadline_Expired(deadline)) break;
+		EEPROM_SPI_WaitUntil(BSP_Deadline_After(EEP_TWC_POLL_STEP_US));
+	}
+
+	if(EEPROM_SPI_SendCommand(CMD_WREN) != HAL_OK || EEPROM_SPI_ReadStatus(&ucStatus) != HAL_OK) return HAL_ERROR;
+	if(bitRead(ucStatus, BIT_WEL) != 1 || (ucStatus & 0x70) != 0) return HAL_ERROR;
+
+	if(EEPROM_SPI_SendCommand(CMD_WRDI) != HAL_OK || EEPROM_SPI_ReadStatus(&ucStatus) != HAL_OK) return HAL_ERROR;
+	if(bitRead(ucStatus, BIT_WEL) != 0 || (ucStatus & 0x70) != 0) return HAL_ERROR;
+
+	return HAL_OK;
+}
+
+/**
+  * @brief  finds the capacity of the selected chip by address wraparound, with
+  *         reads only: EEP_DETECT_WINDOWS windows spread over the candidate size
+  *         must read the same at the alias. Blank windows say nothing, so
+  *         fewer than EEP_DETECT_EVIDENCE windows holding data leave it open
+  * @param  pDevice: selected device, Capacity and PageSize are filled in
+  * @param  pUncertain: 1 if the array could not tell and the size was kept
+	* @retval HAL_StatusTypeDef enum, HAL_OK in case of successful operation
+  */
+//===============================================================================================
+static HAL_StatusTypeDef EEPROM_SPI_DetectSize(EEP_DeviceTypeDef* pDevice, uint8_t* pUncertain)
+//===============================================================================================
+{
+	uint8_t ucLow[EEP_PROBE_SIG_LEN], ucHigh[EEP_PROBE_SIG_LEN];
+	uint32_t uwMin, uwMax, uwCap, uwAt;
+	uint8_t w, ucEvidence;
+
+	// 25xx010..040, 25xx080..512, 25xxM01..M02
+	switch(pDevice->AddrBytes){
+		case 1: 	uwMin = 128; 		uwMax = 512; 			break;
+		case 2: 	uwMin = 1024; 	uwMax = 65536; 		break;
+		case 3: 	uwMin = 131072; uwMax = 262144; 	break;
+		default: 	return HAL_OK;
+	}
+
+	*pUncertain = 1;
+	for(uwCap = uwMin; uwCap < uwMax; uwCap <<= 1)
+	{
+		ucEvidence = 0;
+		for(w = 0; w < EEP_DETECT_WINDOWS; w++)
+		{
+			uwAt = w * (uwCap / EEP_DETECT_WINDOWS);
+			if(EEPROM_SPI_ReadBuffer(ucLow, uwAt, sizeof(ucLow)) != HAL_OK) return HAL_ERROR;
+			if(EEPROM_SPI_ReadBuffer(ucHigh, uwCap + uwAt, sizeof(ucHigh)) != HAL_OK) return HAL_ERROR;
+			if(memcmp(ucLow, ucHigh, sizeof(ucLow)) != 0) break;
+
+			for(uint8_t i = 1; i < sizeof(ucLow); i++){
+				if(ucLow[i] != ucLow[0]){ ucEvidence++; break; }
+			}
+		}
+		if(w < EEP_DETECT_WINDOWS) continue;
+
+		// the same at every window: a wrap, or a copy in blank surroundings
+		if(ucEvidence < EEP_DETECT_EVIDENCE) return HAL_OK;
+		break;
+	}
+
+	*pUncertain = 0;
+	pDevice->Capacity = uwCap;
+	pDevice->PageSize = (uwCap <= 512) ? 8 : (uwCap <= 8192) ? 32 : (uwCap <= 32768) ? 64 : (uwCap <= 65536) ? 128 : 256;
+
+	return HAL_OK;
+}
+
+/**
+  * @brief  probes a chip and fills in its size. Parts only decode the address bits
+  *         they have, so the first power of two that aliases address 0 is the
+  *         capacity. Only reads are issued, nothing is written at boot. The
+  *         search stays within the family of the configured address width; a
+  *         blank array, or one with too little data to tell a wrap from a copy,
+  *         is reported uncertain and keeps the configured size. The selected
+  *         device is left as it was.
+  * @param  pDevice: device to detect, AddrBytes must already be set
+	* @retval HAL_StatusTypeDef enum, HAL_OK in case of successful operation
+  */
+//===============================================================
+HAL_StatusTypeDef BSP_EEPROM_Detect(EEP_DeviceTypeDef* pDevice)
+//===============================================================
+{
+	HAL_StatusTypeDef E2PStatus;
+	EEP_DeviceTypeDef* pSaved = pEeprom;
+	uint32_t uwStart = BSP_GetMicros();
+	uint8_t ucUncertain = 0;
+
+	E2PStatus = EEPROM_SPI_Select(pDevice);
+	if(E2PStatus == HAL_OK) E2PStatus = EEPROM_SPI_Probe();
+	if(E2PStatus == HAL_OK) E2PStatus = EEPROM_SPI_DetectSize(pDevice, &ucUncertain);
+	if(EEPROM_SPI_Select(pSaved) != HAL_OK) E2PStatus = HAL_ERROR;
+	if(E2PStatus != HAL_OK) return E2PStatus;
+
+	EEP_LOG("EEPROM detected in %lu us: %lu bytes%s, %u byte pages\r\n", (unsigned long)(BSP_GetMicros() - uwStart),
+					(unsigned long)pDevice->Capacity, ucUncertain ? " (uncertain, as configured)" : "", pDevice->PageSize);
+
+	return HAL_OK;
+}
+
 /**
   * @brief  check if spi interface is functional
 	* @retval value 1 in case of successful operation
@@ -952,42 +1719,219 @@ uint8_t BSP_EEPROM_IsConnected(void)
 {
 	EEPROM_SPI_Init();	
 	
-	for(uint8_t uCount = 0; uCount < 5; uCount++)
-	{
-		if(EEPROM_SPI_IsReady() == HAL_OK) return 1;
-		HAL_Delay(50);
-	}
-	return 0;
+	return (EEPROM_SPI_Probe() == HAL_OK) ? 1 : 0;
 }
 
 /**
   * @brief  Writes multiple bytes to eeprom
-  * @param  reg_address: eeprom register address starts from 0x0000
+  * @param  reg_address: eeprom register address starts from 0x00000000
   * @param  data_buf: pointer to a user defined buffer for data to be copied
   * @param  length: number of bytes to be written statring from reg_address
 	* @retval HAL_StatusTypeDef enum, HAL_OK in case of successful operation
   */
 //=============================================================================================
-HAL_StatusTypeDef BSP_EEPROM_Write(uint16_t reg_address, uint8_t data_buf[], uint16_t length)
+HAL_StatusTypeDef BSP_EEPROM_Write(uint32_t reg_address, uint8_t data_buf[], uint32_t length)
 //=============================================================================================
 {
+#if (USE_FLASH_EEPROM == 1)
+	return BSP_EEPROM_Flash_Write(reg_address, data_buf, length);
+#else
 	HAL_StatusTypeDef E2PStatus = HAL_ERROR;
+
+	if(reg_address >= pEeprom->Capacity || length > pEeprom->Capacity - reg_address) return HAL_ERROR;
 	E2PStatus = EEPROM_SPI_WriteBuffer(data_buf, reg_address, length);		
 	return E2PStatus;	
+#endif
 }
 
 /**
   * @brief  Reads multiple bytes from eeprom
-  * @param  reg_address: eeprom register address starts from 0x0000
+  * @param  reg_address: eeprom register address starts from 0x00000000
   * @param  data_buf: pointer to a user defined buffer for data to be copied
-  * @param  length: number of bytes to be restored statring from reg_address
+  * @param  length: number of bytes to be restored statring from reg_address,
+  *         a full array dump is issued as one continuous READ
 	* @retval HAL_StatusTypeDef enum, HAL_OK in case of successful operation
   */
 //============================================================================================
-HAL_StatusTypeDef BSP_EEPROM_Read(uint16_t reg_address, uint8_t data_buf[], uint16_t length)
+HAL_StatusTypeDef BSP_EEPROM_Read(uint32_t reg_address, uint8_t data_buf[], uint32_t length)
 //============================================================================================
 {
+#if (USE_FLASH_EEPROM == 1)
+	return BSP_EEPROM_Flash_Read(reg_address, data_buf, length);
+#else
 	HAL_StatusTypeDef E2PStatus = HAL_ERROR;
+
+	if(reg_address >= pEeprom->Capacity || length > pEeprom->Capacity - reg_address) return HAL_ERROR;
 	E2PStatus = EEPROM_SPI_ReadBuffer(data_buf, reg_address, length);			
 	return E2PStatus;
+#endif
+}
+
+/**
+  * @brief  Fills a range with a constant, e.g. 0xFF for a factory reset. The range
+  *         is checked EEP_FILL_WINDOW pages at a time with one sequential READ and
+  *         only pages that do not already hold the pattern are programmed, whole
+  *         page at once. Pages larger than EEP_FILL_PAGE_MAX are checked and
+  *         programmed in pieces of that size, only the pieces that differ. The
+  *         last write cycle is left running, the next access waits for it.
+  * @param  reg_address: eeprom register address starts from 0x00000000
+  * @param  length: number of bytes to be filled statring from reg_address
+  * @param  pattern: value every byte gets
+	* @retval HAL_StatusTypeDef enum, HAL_OK in case of successful operation
+  */
+//=========================================================================================
+HAL_StatusTypeDef BSP_EEPROM_Fill(uint32_t reg_address, uint32_t length, uint8_t pattern)
+//=========================================================================================
+{
+	HAL_StatusTypeDef E2PStatus = HAL_OK;
+	uint8_t ucPage[EEP_FILL_PAGE_MAX];
+
+	if(length == 0) return HAL_ERROR;
+
+#if (USE_FLASH_EEPROM == 1)
+	uint32_t uwStep;
+
+	memset(ucPage, pattern, sizeof(ucPage));
+	for(uint32_t i = 0; (i < length) && (E2PStatus == HAL_OK); i += uwStep){
+		uwStep = (length - i < sizeof(ucPage)) ? (length - i) : sizeof(ucPage);
+		E2PStatus = BSP_EEPROM_Flash_Write(reg_address + i, ucPage, uwStep);
+	}
+#else
+	EEP_ChunkPlanTypeDef plan;
+	uint32_t uwMask[EEP_FILL_WINDOW / 32];
+	uint32_t uwBase, uwCovered, uwStep, n;
+	uint32_t uwPieces = (pEeprom->PageSize + sizeof(ucPage) - 1) / sizeof(ucPage);
+
+	if(reg_address >= pEeprom->Capacity || length > pEeprom->Capacity - reg_address) return HAL_ERROR;
+	if(uwPieces > EEP_FILL_WINDOW) return HAL_ERROR;
+
+	for(uint32_t uwDone = 0; (uwDone < length) && (E2PStatus == HAL_OK); uwDone += uwCovered)
+	{
+		uwBase = reg_address + uwDone;
+		memset(uwMask, 0, sizeof(uwMask));
+
+		// check pass: one READ over the window, a piece is marked when any byte differs
+		EEPROM_SPI_PlanInit(&plan, uwBase, length - uwDone, pEeprom->PageSize);
+		E2PStatus = EEPROM_SPI_ReadStart(uwBase);
+		for(n = 0; (E2PStatus == HAL_OK) && (n + uwPieces <= EEP_FILL_WINDOW) && EEPROM_SPI_PlanNext(&plan); )
+		{
+			for(uint32_t uwOff = 0; (uwOff < plan.Len) && (E2PStatus == HAL_OK); uwOff += uwStep, n++)
+			{
+				uwStep = (plan.Len - uwOff < sizeof(ucPage)) ? (plan.Len - uwOff) : sizeof(ucPage);
+				E2PStatus = EEPROM_SPI_ReadNext(ucPage, uwStep);
+				for(uint32_t i = 0; i < uwStep; i++){
+					if(ucPage[i] != pattern){
+						uwMask[n / 32] |= (1UL << (n % 32));
+						break;
+					}
+				}
+			}
+		}
+		EEPROM_SPI_ReadStop();
+		uwCovered = plan.Offset + plan.Len;
+
+		// program pass over the marked pieces only
+		memset(ucPage, pattern, sizeof(ucPage));
+		EEPROM_SPI_PlanInit(&plan, uwBase, uwCovered, pEeprom->PageSize);
+		for(n = 0; (E2PStatus == HAL_OK) && EEPROM_SPI_PlanNext(&plan); )
+		{
+			for(uint32_t uwOff = 0; (uwOff < plan.Len) && (E2PStatus == HAL_OK); uwOff += uwStep, n++)
+			{
+				uwStep = (plan.Len - uwOff < sizeof(ucPage)) ? (plan.Len - uwOff) : sizeof(ucPage);
+				if(uwMask[n / 32] & (1UL << (n % 32))) E2PStatus = EEPROM_SPI_WritePage(ucPage, plan.Addr + uwOff, uwStep);
+			}
+		}
+	}
+#endif
+
+	return E2PStatus;
+}
+
+/**
+  * @brief  CRC-16 (EEPROM_SPI_Crc16, init 0xFFFF) of a stored range. The range is
+  *         read with one continuous READ and folded in EEP_VERIFY_CHUNK steps, so
+  *         it needs no buffer of the range size.
+  * @param  reg_address: eeprom register address starts from 0x00000000
+  * @param  length: number of bytes statring from reg_address
+  * @param  pCrc: result
+	* @retval HAL_StatusTypeDef enum, HAL_OK in case of successful operation
+  */
+//=====================================================================================
+HAL_StatusTypeDef BSP_EEPROM_Crc(uint32_t reg_address, uint32_t length, uint16_t* pCrc)
+//=====================================================================================
+{
+	HAL_StatusTypeDef E2PStatus = HAL_OK;
+	uint8_t ucChunk[EEP_VERIFY_CHUNK];
+	uint16_t uiCrc = 0xFFFF;
+	uint32_t uwStep;
+
+	if(pCrc == NULL) return HAL_ERROR;
+
+#if (USE_FLASH_EEPROM == 1)
+	for(uint32_t i = 0; (i < length) && (E2PStatus == HAL_OK); i += uwStep){
+		uwStep = (length - i < sizeof(ucChunk)) ? (length - i) : sizeof(ucChunk);
+		E2PStatus = BSP_EEPROM_Flash_Read(reg_address + i, ucChunk, uwStep);
+		uiCrc = EEPROM_SPI_Crc16(uiCrc, ucChunk, uwStep);
+	}
+#else
+	if(length == 0 || reg_address >= pEeprom->Capacity || length > pEeprom->Capacity - reg_address) return HAL_ERROR;
+
+	E2PStatus = EEPROM_SPI_ReadStart(reg_address);
+	for(uint32_t i = 0; (i < length) && (E2PStatus == HAL_OK); i += uwStep){
+		uwStep = (length - i < sizeof(ucChunk)) ? (length - i) : sizeof(ucChunk);
+		E2PStatus = EEPROM_SPI_ReadNext(ucChunk, uwStep);
+		uiCrc = EEPROM_SPI_Crc16(uiCrc, ucChunk, uwStep);
+	}
+	EEPROM_SPI_ReadStop();
+#endif
+
+	*pCrc = uiCrc;
+	return E2PStatus;
+}
+
+/**
+  * @brief  BSP_EEPROM_Write followed by a verify pass. The CRC of the source is
+  *         computed page by page while each write cycle runs, then the range is
+  *         read back once through BSP_EEPROM_Crc; no readback buffer is needed.
+  * @param  reg_address: eeprom register address starts from 0x00000000
+  * @param  data_buf: pointer to a user defined buffer for data to be copied
+  * @param  length: number of bytes to be written statring from reg_address
+	* @retval HAL_OK if written and verified, HAL_ERROR on a mismatch or bus failure
+  */
+//=========================================================================================================
+HAL_StatusTypeDef BSP_EEPROM_WriteVerify(uint32_t reg_address, uint8_t data_buf[], uint32_t length)
+//=========================================================================================================
+{
+	HAL_StatusTypeDef E2PStatus = HAL_OK;
+	uint16_t uiSrcCrc = 0xFFFF, uiDevCrc;
+
+	if(data_buf == NULL || length == 0) return HAL_ERROR;
+
+#if (USE_FLASH_EEPROM == 1)
+	E2PStatus = BSP_EEPROM_Flash_Write(reg_address, data_buf, length);
+	uiSrcCrc = EEPROM_SPI_Crc16(uiSrcCrc, data_buf, length);
+#else
+	EEP_ChunkPlanTypeDef plan;
+
+	if(reg_address >= pEeprom->Capacity || length > pEeprom->Capacity - reg_address) return HAL_ERROR;
+
+	EEPROM_SPI_PlanInit(&plan, reg_address, length, pEeprom->PageSize);
+	while((E2PStatus == HAL_OK) && EEPROM_SPI_PlanNext(&plan))
+	{
+		E2PStatus = EEPROM_SPI_WritePage(&data_buf[plan.Offset], plan.Addr, plan.Len);
+		// the chip is busy programming this page meanwhile
+		uiSrcCrc = EEPROM_SPI_Crc16(uiSrcCrc, &data_buf[plan.Offset], plan.Len);
+	}
+#endif
+
+	if(E2PStatus == HAL_OK) E2PStatus = BSP_EEPROM_Crc(reg_address, length, &uiDevCrc);
+	if(E2PStatus != HAL_OK) return E2PStatus;
+
+	if(uiDevCrc != uiSrcCrc){
+		EEP_LOG("Verify failed at 0x%lX+%lu: crc 0x%04X, expected 0x%04X\r\n",
+						(unsigned long)reg_address, (unsigned long)length, uiDevCrc, uiSrcCrc);
+		return HAL_ERROR;
+	}
+
+	return HAL_OK;
 }
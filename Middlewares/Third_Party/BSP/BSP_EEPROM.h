@@ -19,6 +19,7 @@ extern "C"
 #endif
 
 #include "debugprobe.h"
+#include "BSP_Timebase.h"
 
 	
 #define EEP_DEBUG
@@ -31,26 +32,61 @@ extern "C"
 #endif	
 
 #define USE_SOFTWARE_SPI								 (1)
+#define USE_FLASH_EEPROM								 (0)			// 1: BSP_EEPROM_Read/Write served by BSP_EEPROM_Flash.c
+#define USE_SOFTSPI_WAVE								 (0)			// 1: soft SPI data phases clocked by TIM1 + DMA, see BSP_EEPROM_Wave.c
+#define USE_HARDSPI_IT									 (0)			// 1: larger hard SPI frames interrupt driven, see BSP_EEPROM_SpiIT.c
+
+#if (USE_SOFTSPI_WAVE == 1) && (USE_SOFTWARE_SPI != 1)
+#error USE_SOFTSPI_WAVE needs USE_SOFTWARE_SPI (1)
+#endif
+#if (USE_HARDSPI_IT == 1) && (USE_SOFTWARE_SPI != 0)
+#error USE_HARDSPI_IT needs USE_SOFTWARE_SPI (0)
+#endif
 	
+//#define BSP_EEPROM_SIM 												// host builds: the bit-bang pins drive the AT25 model of BSP_EEPROM_Sim.c
+//#define BSP_EEPROM_FUZZ 												// with BSP_EEPROM_SIM: LLVMFuzzerTestOneInput drives EEPROM_Sim_Fuzz
+
+#ifdef BSP_EEPROM_SIM
+#if (USE_SOFTWARE_SPI != 1) || !defined(BSP_TIMEBASE_VIRTUAL)
+#error BSP_EEPROM_SIM needs USE_SOFTWARE_SPI (1) and BSP_TIMEBASE_VIRTUAL
+#endif
+#include "BSP_EEPROM_Sim.h"
+#define EEP_SPI_CS_GPIO_CLK_ENABLE()
+#define EEP_SPI_CS_GPIO_CLK_DISABLE()
+#define EEP_SPI_SCK_GPIO_CLK_ENABLE()
+#define EEP_SPI_SCK_GPIO_CLK_DISABLE()
+#define EEP_SPI_CS_LOW()      					 EEPROM_Sim_SetCs(pEeprom->CsPin, 0)
+#define EEP_SPI_CS_HIGH()      					 EEPROM_Sim_SetCs(pEeprom->CsPin, 1)
+#define EEP_SPI_SI_LOW()      					 EEPROM_Sim_SetPin(EEP_SIM_PIN_SI, 0)
+#define EEP_SPI_SI_HIGH()      					 EEPROM_Sim_SetPin(EEP_SIM_PIN_SI, 1)
+#define EEP_SPI_CK_LOW()      					 EEPROM_Sim_SetPin(EEP_SIM_PIN_CK, 0)
+#define EEP_SPI_CK_HIGH()      					 EEPROM_Sim_SetPin(EEP_SIM_PIN_CK, 1)
+#define EEP_SPI_SO_IS_HIGH()      			 (EEPROM_Sim_GetSO() != 0)
+#else
 #define EEP_SPI_CS_GPIO_CLK_ENABLE()   	 __HAL_RCC_GPIOA_CLK_ENABLE()
 #define EEP_SPI_CS_GPIO_CLK_DISABLE()    __HAL_RCC_GPIOA_CLK_DISABLE()
 #define EEP_SPI_SCK_GPIO_CLK_ENABLE()    __HAL_RCC_GPIOA_CLK_ENABLE()
 #define EEP_SPI_SCK_GPIO_CLK_DISABLE()   __HAL_RCC_GPIOA_CLK_DISABLE()
-#define EEP_SPI_CS_LOW()      					 HAL_GPIO_WritePin(EEP_CS_GPIO_Port, EEP_CS_Pin, GPIO_PIN_RESET)
-#define EEP_SPI_CS_HIGH()      					 HAL_GPIO_WritePin(EEP_CS_GPIO_Port, EEP_CS_Pin, GPIO_PIN_SET)
+#define EEP_SPI_CS_LOW()      					 HAL_GPIO_WritePin(pEeprom->CsPort, pEeprom->CsPin, GPIO_PIN_RESET)
+#define EEP_SPI_CS_HIGH()      					 HAL_GPIO_WritePin(pEeprom->CsPort, pEeprom->CsPin, GPIO_PIN_SET)
 #define EEP_SPI_SI_LOW()      					 HAL_GPIO_WritePin(EEP_MOSI_GPIO_Port, EEP_MOSI_Pin, GPIO_PIN_RESET)
 #define EEP_SPI_SI_HIGH()      					 HAL_GPIO_WritePin(EEP_MOSI_GPIO_Port, EEP_MOSI_Pin, GPIO_PIN_SET)
 #define EEP_SPI_CK_LOW()      					 HAL_GPIO_WritePin(EEP_CLK_GPIO_Port, EEP_CLK_Pin, GPIO_PIN_RESET)
 #define EEP_SPI_CK_HIGH()      					 HAL_GPIO_WritePin(EEP_CLK_GPIO_Port, EEP_CLK_Pin, GPIO_PIN_SET)
 #define EEP_SPI_SO_IS_HIGH()      			 (HAL_GPIO_ReadPin(EEP_MISO_GPIO_Port, EEP_MISO_Pin) == GPIO_PIN_SET)
+#endif
 
 #define EEPROM_SPI_FLAG_TIMEOUT          ((uint32_t) 200)			                               
-#define WRITE_TIMEOUT_MS  			 				 (uint8_t)20 		// a write should only ever take 5 ms max
+#define EEPROM_SPI_FLAG_TIMEOUT_US       ((uint32_t) 1000)			// TXE/RXNE should never take that long
+#define WRITE_TIMEOUT_US  			 				 (uint32_t)20000 	// a write should only ever take 5 ms max
 
-#define EEP_CLK_DELAY(x)						 		 for(int i = 0 ; i < (50 * x) ; i++) __NOP()
+#define EEP_CLK_DELAY(x)						 		 for(uint32_t i = 0 ; i < (pEeprom->ClkDelay * x) ; i++) __NOP()
 #define EEP_SEQ_DELAY(x)						 		 for(int i = 0 ; i < (20 * x) ; i++) __NOP()
 
-#define	EEP_SPI_PAGESIZE								 (uint8_t)32
+#define	EEP_SPI_PAGESIZE								 (uint8_t)32 			// AT25160 defaults, larger parts override
+#define	EEP_SPI_CAPACITY								 (uint32_t)2048 	// Capacity/PageSize/AddrBytes in hEeprom
+#define	EEP_SPI_ADDRBYTES								 (uint8_t)2 			// e.g. 25xx1024: 131072, 256, 3
+#define EEP_HEADER_MAX									 (uint8_t)5 			// instruction + up to 4 address bytes
 #define CMD_WRSR  							 				 (uint8_t)0x01  // write status register
 #define CMD_WRITE 							 				 (uint8_t)0x02  // write to EEPROM
 #define CMD_READ  							 				 (uint8_t)0x03  // read from EEPROM
@@ -71,6 +107,97 @@ extern "C"
 
 #define EEP_RW_Delay										 (uint8_t)5
 
+#define EEP_TWC_MAX_US									 (uint32_t)5000 	// datasheet tWC, estimator starts from here
+#define EEP_TWC_POLL_STEP_US						 (uint32_t)25 		// RDSR spacing once the predicted tWC is reached
+#define EEP_TWC_EST_GAIN								 (int32_t)8 			// EWMA weight 1/8 for the tWC estimate
+#define EEP_TWC_DEV_GAIN								 (int32_t)4 			// EWMA weight 1/4 for its deviation
+
+#define EEP_BENCH_PAGES									 (uint16_t)16 		// pages written per benchmark pass
+#define EEP_BENCH_VDD_MV								 (uint32_t)3300 	// supply and typical STM32F030 currents at 24MHz,
+#define EEP_BENCH_RUN_UA								 (uint32_t)8000 	// used to estimate energy per page in the benchmark
+#define EEP_BENCH_SLEEP_UA							 (uint32_t)2500
+
+#define EEP_MAX_DEVICES									 (uint8_t)4 			// chip selects the interleave benchmark handles
+#define EEP_FILL_WINDOW									 (uint32_t)128 		// pages (pieces of larger ones) checked per READ by BSP_EEPROM_Fill
+#define EEP_FILL_PAGE_MAX								 (uint16_t)64 		// largest piece BSP_EEPROM_Fill programs in one WRITE
+#define EEP_VERIFY_CHUNK								 (uint32_t)16 		// bytes folded into the CRC per read step
+#define EEP_PROBE_SETTLE_US							 (uint32_t)5 			// SO settling time after a pull change
+#define EEP_PROBE_SIG_LEN								 (uint8_t)8 			// bytes per window of the wraparound search
+#define EEP_DETECT_WINDOWS							 (uint8_t)8 			// windows spread over each candidate size
+#define EEP_DETECT_EVIDENCE							 (uint8_t)2 			// windows holding data that make a wrap certain
+
+#define EEP_CLK_STEPS										 (uint8_t)8 			// clock settings, 0 is the fastest
+#define EEP_CLK_STEP_DEFAULT						 (uint8_t)(EEP_CLK_STEPS - 1)
+#define EEP_CAL_PAGE_MAX								 (uint16_t)64 		// reference window read back per step, one page at most
+#define EEP_CAL_SCAN_PAGES							 (uint8_t)16 			// windows searched for the reference with the most bit edges
+#define EEP_CAL_MIN_EDGES								 (uint16_t)32 		// bit transitions a reference needs to tell clocks apart
+#define EEP_CAL_VERIFY_COUNT						 (uint8_t)8 			// consecutive good readbacks needed per step
+#define EEP_CAL_MARGIN_STEPS						 (uint8_t)1 			// steps backed off from the fastest passing one
+
+typedef enum
+{
+	EEP_WAIT_POLL = 0,																					// stay active and poll WIP around the predicted tWC
+	EEP_WAIT_SLEEP																							// sleep (WFI) on a timer alarm, then check WIP once
+} EEP_WaitModeTypeDef;
+
+typedef struct
+{
+	GPIO_TypeDef* CsPort;																				// chip select of this device, shared SCK/MOSI/MISO
+	uint16_t CsPin;
+	EEP_WaitModeTypeDef WaitMode;																// how write cycles are waited for
+	uint8_t  ClkStep;																						// calibrated bus clock step, 0 is the fastest
+	uint32_t ClkDelay;																					// soft SPI half period in NOP loops, follows ClkStep
+	uint32_t Capacity;																					// array size in bytes
+	uint16_t PageSize;																					// write page size in bytes
+	uint8_t  AddrBytes;																					// address phase length, 1 to 4 bytes
+	uint32_t TwcMaxUs;																					// datasheet write cycle time
+	uint32_t TwcEstUs;																					// learned write cycle time
+	uint32_t TwcDevUs;																					// learned spread of the write cycle time
+	uint32_t WriteStartUs;																			// time stamp of the CS edge that started the cycle
+	uint8_t  WriteBusy;																					// a write cycle may still be running
+	uint32_t LastBusyUs;																				// cycle time of the last RDSR that saw WIP, 0 if none
+	uint32_t WriteCycles;																				// statistics: write cycles started
+	uint32_t StatusPolls;																				// statistics: RDSR frames spent on them
+	uint32_t WaitSleepUs;																				// statistics: time slept in write cycle waits
+	uint32_t WaitAwakeUs;																				// statistics: time spent awake in write cycle waits
+} EEP_DeviceTypeDef;
+
+// Default handle contents for an AT25160 behind the given chip select
+#define EEP_DEVICE_INIT(port, pin) 	{ 																\
+	.CsPort = (port), 																						\
+	.CsPin = (pin), 																							\
+	.WaitMode = EEP_WAIT_POLL, 																		\
+	.ClkStep = EEP_CLK_STEP_DEFAULT, 															\
+	.ClkDelay = 50, 																							\
+	.Capacity = EEP_SPI_CAPACITY, 																\
+	.PageSize = EEP_SPI_PAGESIZE, 																\
+	.AddrBytes = EEP_SPI_ADDRBYTES, 															\
+	.TwcMaxUs = EEP_TWC_MAX_US, 																	\
+	.TwcEstUs = EEP_TWC_MAX_US, 																	\
+	.TwcDevUs = EEP_TWC_MAX_US / 2, 															\
+}
+
+// Page chunk planner: bytes of an access at addr that fit before the next page
+// boundary. It is a constant expression for constant arguments (C and C++).
+#define EEP_CHUNK_LEN(addr, len, page) 	 (((len) < ((page) - ((addr) % (page)))) ? (len) : ((page) - ((addr) % (page))))
+
+typedef struct
+{
+	uint32_t Addr;																							// device address of the current chunk
+	uint32_t Offset;																						// position of the current chunk in the data
+	uint32_t Len;																								// bytes in the current chunk, never 0
+	uint32_t Remain;																						// bytes not planned yet
+	uint16_t PageSize;
+} EEP_ChunkPlanTypeDef;
+
+typedef struct
+{
+	EEP_DeviceTypeDef* pDevice;																	// chip the data goes to
+	uint8_t* pBuffer;																						// data still to be written
+	uint32_t WriteAddr;																					// next address on that chip
+	uint32_t NumByteToWrite;																		// bytes left, 0 once the job is done
+} EEP_WriteJobTypeDef;
+
 
 #if (USE_SOFTWARE_SPI == 0)
 #define EEPROM_SPI_Init 								EEPROM_HardSPI_Init
@@ -79,10 +206,15 @@ extern "C"
 #define EEPROM_SPI_WriteByte 						EEPROM_HardSPI_WriteByte
 #define EEPROM_SPI_ReadByte 						EEPROM_HardSPI_ReadByte
 #define EEPROM_SPI_IsReady 							EEPROM_HardSPI_IsReady
+#define EEPROM_SPI_ReadStatus 					EEPROM_HardSPI_ReadStatus
+#define EEPROM_SPI_SendCommand 					EEPROM_HardSPI_SendCommand
+#define EEPROM_SPI_SetClock 						EEPROM_HardSPI_SetClock
 #define EEPROM_SPI_WriteStatusRegister 	EEPROM_HardSPI_WriteStatusRegister
 #define EEPROM_SPI_ReadBuffer 					EEPROM_HardSPI_ReadBuffer
+#define EEPROM_SPI_ReadStart 						EEPROM_HardSPI_ReadStart
+#define EEPROM_SPI_ReadNext 						EEPROM_HardSPI_ReadNext
+#define EEPROM_SPI_ReadStop 						EEPROM_HardSPI_ReadStop
 #define EEPROM_SPI_WritePage 						EEPROM_HardSPI_WritePage
-#define EEPROM_SPI_WriteBuffer 					EEPROM_HardSPI_WriteBuffer
 #elif (USE_SOFTWARE_SPI == 1)
 #define EEPROM_SPI_Init 								EEPROM_SoftSPI_Init
 #define EEPROM_SPI_SendByte 						EEPROM_SoftSPI_SendByte
@@ -90,26 +222,103 @@ extern "C"
 #define EEPROM_SPI_WriteByte 						EEPROM_SoftSPI_WriteByte
 #define EEPROM_SPI_ReadByte 						EEPROM_SoftSPI_ReadByte
 #define EEPROM_SPI_IsReady 							EEPROM_SoftSPI_IsReady
+#define EEPROM_SPI_ReadStatus 					EEPROM_SoftSPI_ReadStatus
+#define EEPROM_SPI_SendCommand 					EEPROM_SoftSPI_SendCommand
+#define EEPROM_SPI_SetClock 						EEPROM_SoftSPI_SetClock
 #define EEPROM_SPI_WriteStatusRegister 	EEPROM_SoftSPI_WriteStatusRegister
 #define EEPROM_SPI_ReadBuffer 					EEPROM_SoftSPI_ReadBuffer
+#define EEPROM_SPI_ReadStart 						EEPROM_SoftSPI_ReadStart
+#define EEPROM_SPI_ReadNext 						EEPROM_SoftSPI_ReadNext
+#define EEPROM_SPI_ReadStop 						EEPROM_SoftSPI_ReadStop
 #define EEPROM_SPI_WritePage 						EEPROM_SoftSPI_WritePage
-#define EEPROM_SPI_WriteBuffer 					EEPROM_SoftSPI_WriteBuffer
 #else
 #error Wrong SPI Configuration
 #endif
 
 
+/**
+  * @brief  starts planning an access as a sequence of page bounded chunks
+  * @param  pPlan: planner state
+  * @param  Addr: first device address
+  * @param  Len: total bytes
+  * @param  PageSize: page size of the device
+	* @retval none
+  */
+__STATIC_INLINE void EEPROM_SPI_PlanInit(EEP_ChunkPlanTypeDef* pPlan, uint32_t Addr, uint32_t Len, uint16_t PageSize)
+{
+	pPlan->Addr = Addr;
+	pPlan->Offset = 0;
+	pPlan->Len = 0;
+	pPlan->Remain = Len;
+	pPlan->PageSize = PageSize;
+}
+
+/**
+  * @brief  moves to the next chunk, Addr/Offset/Len then describe it
+  * @param  pPlan: planner state
+	* @retval 1 if there is a chunk, 0 when the access is complete
+  */
+__STATIC_INLINE uint8_t EEPROM_SPI_PlanNext(EEP_ChunkPlanTypeDef* pPlan)
+{
+	pPlan->Addr += pPlan->Len;
+	pPlan->Offset += pPlan->Len;
+
+	if(pPlan->Remain == 0){
+		pPlan->Len = 0;
+		return 0;
+	}
+
+	pPlan->Len = EEP_CHUNK_LEN(pPlan->Addr, pPlan->Remain, pPlan->PageSize);
+	pPlan->Remain -= pPlan->Len;
+	return 1;
+}
+
+
 extern SPI_HandleTypeDef hspi1;	
+extern EEP_DeviceTypeDef hEeprom;
+extern EEP_DeviceTypeDef* pEeprom;
 
 HAL_StatusTypeDef EEPROM_HardSPI_Init(void);
 HAL_StatusTypeDef EEPROM_SoftSPI_Init(void);
+HAL_StatusTypeDef EEPROM_HardSPI_ReadStatus(uint8_t* pStatus);
+HAL_StatusTypeDef EEPROM_SoftSPI_ReadStatus(uint8_t* pStatus);
+HAL_StatusTypeDef EEPROM_HardSPI_SendCommand(uint8_t ucCmd);
+HAL_StatusTypeDef EEPROM_SoftSPI_SendCommand(uint8_t ucCmd);
+HAL_StatusTypeDef EEPROM_HardSPI_SetClock(uint8_t ucStep);
+HAL_StatusTypeDef EEPROM_SoftSPI_SetClock(uint8_t ucStep);
+HAL_StatusTypeDef EEPROM_SPI_CalibrateClock(void);
+HAL_StatusTypeDef EEPROM_HardSPI_ReadStart(uint32_t ReadAddr);
+HAL_StatusTypeDef EEPROM_SoftSPI_ReadStart(uint32_t ReadAddr);
+HAL_StatusTypeDef EEPROM_HardSPI_ReadNext(uint8_t* pBuffer, uint32_t NumByteToRead);
+HAL_StatusTypeDef EEPROM_SoftSPI_ReadNext(uint8_t* pBuffer, uint32_t NumByteToRead);
+void EEPROM_HardSPI_ReadStop(void);
+void EEPROM_SoftSPI_ReadStop(void);
+HAL_StatusTypeDef EEPROM_HardSPI_ReadBuffer(uint8_t* pBuffer, uint32_t ReadAddr, uint32_t NumByteToRead);
+HAL_StatusTypeDef EEPROM_SoftSPI_ReadBuffer(uint8_t* pBuffer, uint32_t ReadAddr, uint32_t NumByteToRead);
+HAL_StatusTypeDef EEPROM_HardSPI_WritePage(uint8_t* pBuffer, uint32_t WriteAddr, uint32_t NumByteToWrite);
+HAL_StatusTypeDef EEPROM_SoftSPI_WritePage(uint8_t* pBuffer, uint32_t WriteAddr, uint32_t NumByteToWrite);
+HAL_StatusTypeDef EEPROM_SPI_WriteBuffer(uint8_t* pBuffer, uint32_t WriteAddr, uint32_t NumByteToWrite);
+
+void EEPROM_SPI_WriteCycleStarted(void);
+HAL_StatusTypeDef EEPROM_SPI_WaitReady(void);
+HAL_StatusTypeDef EEPROM_SPI_PollReady(void);
+HAL_StatusTypeDef EEPROM_SPI_Select(EEP_DeviceTypeDef* pDevice);
+HAL_StatusTypeDef EEPROM_SPI_MultiWrite(EEP_WriteJobTypeDef* pJobs, uint8_t ucCount);
+uint16_t EEPROM_SPI_Crc16(uint16_t uiCrc, const uint8_t* pData, uint32_t uwLen);
 
 HAL_StatusTypeDef EEPROM_SPI_MultipleReadWriteTest(uint8_t eraseFlag);
 HAL_StatusTypeDef EEPROM_SPI_SingleReadWriteTest(uint8_t eraseFlag);
+HAL_StatusTypeDef EEPROM_SPI_BenchmarkTest(void);
+HAL_StatusTypeDef EEPROM_SPI_InterleaveTest(EEP_DeviceTypeDef* pDevices[], uint8_t ucCount);
 
 uint8_t BSP_EEPROM_IsConnected(void);
-HAL_StatusTypeDef BSP_EEPROM_Write(uint16_t reg_address, uint8_t data_buf[], uint16_t length);
-HAL_StatusTypeDef BSP_EEPROM_Read(uint16_t reg_address, uint8_t data_buf[], uint16_t length);
+HAL_StatusTypeDef EEPROM_SPI_Probe(void);
+HAL_StatusTypeDef BSP_EEPROM_Detect(EEP_DeviceTypeDef* pDevice);
+HAL_StatusTypeDef BSP_EEPROM_Write(uint32_t reg_address, uint8_t data_buf[], uint32_t length);
+HAL_StatusTypeDef BSP_EEPROM_Read(uint32_t reg_address, uint8_t data_buf[], uint32_t length);
+HAL_StatusTypeDef BSP_EEPROM_Fill(uint32_t reg_address, uint32_t length, uint8_t pattern);
+HAL_StatusTypeDef BSP_EEPROM_Crc(uint32_t reg_address, uint32_t length, uint16_t* pCrc);
+HAL_StatusTypeDef BSP_EEPROM_WriteVerify(uint32_t reg_address, uint8_t data_buf[], uint32_t length);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,402 @@
+/**
+  ******************************************************************************
+  * @file    BSP_EEPROM.hpp
+  * @author  Hossein Bagherzade(@realhba)
+	* @email	 hossein.bagherzade@gmail.com
+  * @version V1.0.0
+  * @date    18-Oct-2026
+  * @brief   Header only C++17 driver for SPI EEPROMs, specialized at compile time.
+  * Eeprom<Device, Bus> takes the geometry from the Device policy and the byte
+  * transfers from the Bus policy, so page splitting, address encoding and
+  * bounds checks of fixed accesses (Write<Addr, N>, Read<Addr, N>) are all
+  * resolved by the compiler and only the bus traffic is left at run time.
+  * Opcodes and status bits are the ones of BSP_EEPROM.h.
+  ******************************************************************************
+	**/
+
+
+#ifndef __BSP_EEPROM_HPP
+#define __BSP_EEPROM_HPP
+
+#include "BSP_EEPROM.h"
+#ifndef BSP_EEPROM_SIM
+#include "stm32f0xx_ll_gpio.h"
+#include "stm32f0xx_ll_spi.h"
+#endif
+
+#include <cstdint>
+
+namespace bsp
+{
+
+//=======================================================================================
+//================================== Device policies ====================================
+//=======================================================================================
+
+template <uint32_t Cap, uint16_t Page, uint8_t AddrWidth, uint32_t Twc>
+struct EepromDevice
+{
+	static constexpr uint32_t Capacity = Cap;										// array size in bytes
+	static constexpr uint16_t PageSize = Page;									// write page size in bytes
+	static constexpr uint8_t  AddrBytes = AddrWidth;						// address phase length, 1 to 4 bytes
+	static constexpr uint32_t TwcUs = Twc;											// datasheet write cycle time
+
+	static_assert(AddrWidth >= 1 && AddrWidth <= EEP_HEADER_MAX - 1, "address phase is 1 to 4 bytes");
+	static_assert((Page & (Page - 1)) == 0, "page size must be a power of two");
+};
+
+using AT25160 = EepromDevice<EEP_SPI_CAPACITY, EEP_SPI_PAGESIZE, EEP_SPI_ADDRBYTES, EEP_TWC_MAX_US>;
+using AT25040 = EepromDevice<512, 8, 1, EEP_TWC_MAX_US>;
+using AT25M02 = EepromDevice<262144, 256, 3, 10000>;
+
+
+//=======================================================================================
+//==================================== Bus policies =====================================
+//=======================================================================================
+
+#ifndef BSP_EEPROM_SIM 		// the model has no port registers, a host build brings its own bus
+
+/**
+  * @brief  SPI1 through the HAL, same path as EEPROM_HardSPI_*
+  */
+template <uint32_t CsPort, uint16_t CsPin>
+struct HalSpiBus
+{
+	static void Select()   { HAL_GPIO_WritePin(reinterpret_cast<GPIO_TypeDef*>(CsPort), CsPin, GPIO_PIN_RESET); }
+	static void Deselect() { HAL_GPIO_WritePin(reinterpret_cast<GPIO_TypeDef*>(CsPort), CsPin, GPIO_PIN_SET); }
+
+	static HAL_StatusTypeDef Send(const uint8_t* pData, uint32_t uwLen)
+	{
+		HAL_StatusTypeDef E2PStatus = HAL_OK;
+		for(uint16_t uiChunk; (uwLen > 0) && (E2PStatus == HAL_OK); pData += uiChunk, uwLen -= uiChunk){
+			uiChunk = (uwLen > 0xFFFF) ? 0xFFFF : static_cast<uint16_t>(uwLen);
+			E2PStatus = HAL_SPI_Transmit(&hspi1, const_cast<uint8_t*>(pData), uiChunk, EEPROM_SPI_FLAG_TIMEOUT);
+		}
+		return E2PStatus;
+	}
+
+	static HAL_StatusTypeDef Recv(uint8_t* pData, uint32_t uwLen)
+	{
+		HAL_StatusTypeDef E2PStatus = HAL_OK;
+		for(uint16_t uiChunk; (uwLen > 0) && (E2PStatus == HAL_OK); pData += uiChunk, uwLen -= uiChunk){
+			uiChunk = (uwLen > 0xFFFF) ? 0xFFFF : static_cast<uint16_t>(uwLen);
+			E2PStatus = HAL_SPI_Receive(&hspi1, pData, uiChunk, EEPROM_SPI_FLAG_TIMEOUT);
+		}
+		return E2PStatus;
+	}
+};
+
+/**
+  * @brief  SPI peripheral driven by LL register accesses, no HAL state machine.
+  *         The peripheral must be configured for 8bit frames (RXNE at 8bit).
+  */
+template <uint32_t SpiBase, uint32_t CsPort, uint16_t CsPin>
+struct LlSpiBus
+{
+	static SPI_TypeDef*  Spi()  { return reinterpret_cast<SPI_TypeDef*>(SpiBase); }
+	static GPIO_TypeDef* Port() { return reinterpret_cast<GPIO_TypeDef*>(CsPort); }
+
+	static void Select()
+	{
+		if(!LL_SPI_IsEnabled(Spi())) LL_SPI_Enable(Spi());
+		LL_GPIO_ResetOutputPin(Port(), CsPin);
+	}
+	static void Deselect()
+	{
+		while(LL_SPI_IsActiveFlag_BSY(Spi())) {}
+		LL_GPIO_SetOutputPin(Port(), CsPin);
+	}
+
+	static uint8_t Transfer(uint8_t ucByte)
+	{
+		while(!LL_SPI_IsActiveFlag_TXE(Spi())) {}
+		LL_SPI_TransmitData8(Spi(), ucByte);
+		while(!LL_SPI_IsActiveFlag_RXNE(Spi())) {}
+		return LL_SPI_ReceiveData8(Spi());
+	}
+
+	static HAL_StatusTypeDef Send(const uint8_t* pData, uint32_t uwLen)
+	{
+		while(uwLen--) (void)Transfer(*pData++);
+		return HAL_OK;
+	}
+
+	static HAL_StatusTypeDef Recv(uint8_t* pData, uint32_t uwLen)
+	{
+		while(uwLen--) *pData++ = Transfer(0xFF);
+		return HAL_OK;
+	}
+};
+
+/**
+  * @brief  bit-banged SPI mode 0 on plain GPIOs, same timing as EEPROM_SoftSPI_*
+  */
+template <uint32_t SckPort, uint16_t SckPin, uint32_t MosiPort, uint16_t MosiPin,
+					uint32_t MisoPort, uint16_t MisoPin, uint32_t CsPort, uint16_t CsPin, uint32_t HalfPeriod = 0>
+struct BitBangBus
+{
+	static GPIO_TypeDef* Port(uint32_t uwBase) { return reinterpret_cast<GPIO_TypeDef*>(uwBase); }
+
+	static void Delay()
+	{
+		for(uint32_t i = 0; i < HalfPeriod; i++) __NOP();
+	}
+
+	static void Select()   { LL_GPIO_ResetOutputPin(Port(CsPort), CsPin); }
+	static void Deselect() { LL_GPIO_SetOutputPin(Port(CsPort), CsPin); }
+
+	static uint8_t Transfer(uint8_t ucByte)
+	{
+		uint8_t ucIn = 0;
+
+		for(uint8_t clk = 0; clk < 8; clk++)
+		{
+			if(ucByte & 0x80) LL_GPIO_SetOutputPin(Port(MosiPort), MosiPin);
+			else LL_GPIO_ResetOutputPin(Port(MosiPort), MosiPin);
+
+			LL_GPIO_ResetOutputPin(Port(SckPort), SckPin);
+			Delay();
+			LL_GPIO_SetOutputPin(Port(SckPort), SckPin);
+			Delay();
+
+			ucIn = static_cast<uint8_t>((ucIn << 1) | (LL_GPIO_IsInputPinSet(Port(MisoPort), MisoPin) ? 1 : 0));
+			ucByte <<= 1;
+		}
+		return ucIn;
+	}
+
+	static HAL_StatusTypeDef Send(const uint8_t* pData, uint32_t uwLen)
+	{
+		while(uwLen--) (void)Transfer(*pData++);
+		return HAL_OK;
+	}
+
+	static HAL_StatusTypeDef Recv(uint8_t* pData, uint32_t uwLen)
+	{
+		while(uwLen--) *pData++ = Transfer(0xFF);
+		return HAL_OK;
+	}
+};
+
+// board wiring, see main.h
+using BoardHalSpiBus = HalSpiBus<GPIOA_BASE, EEP_CS_Pin>;
+using BoardLlSpiBus = LlSpiBus<SPI1_BASE, GPIOA_BASE, EEP_CS_Pin>;
+using BoardBitBangBus = BitBangBus<GPIOA_BASE, EEP_CLK_Pin, GPIOA_BASE, EEP_MOSI_Pin,
+																	 GPIOA_BASE, EEP_MISO_Pin, GPIOA_BASE, EEP_CS_Pin>;
+#endif /* BSP_EEPROM_SIM */
+
+
+//=======================================================================================
+//====================================== Driver =========================================
+//=======================================================================================
+
+template <typename Device, typename Bus>
+class Eeprom
+{
+public:
+	struct Header
+	{
+		uint8_t Bytes[EEP_HEADER_MAX];
+		uint8_t Len;
+	};
+
+	/**
+	  * @brief  instruction and address phase, same encoding as EEPROM_SPI_BuildHeader
+	  */
+	static constexpr Header MakeHeader(uint8_t ucCmd, uint32_t Addr)
+	{
+		Header h{};
+		if constexpr (Device::AddrBytes == 1) ucCmd |= static_cast<uint8_t>((Addr >> 5) & 0x08);
+
+		h.Bytes[h.Len++] = ucCmd;
+		for(int8_t i = Device::AddrBytes - 1; i >= 0; i--){
+			h.Bytes[h.Len++] = static_cast<uint8_t>(Addr >> (8 * i));
+		}
+		return h;
+	}
+
+	/**
+	  * @brief  size of the first page chunk of an access starting at Addr, the
+	  *         planner of BSP_EEPROM.h evaluated at compile time when it can be
+	  */
+	static constexpr uint32_t FirstChunk(uint32_t Addr, uint32_t uwLen)
+	{
+		return EEP_CHUNK_LEN(Addr, uwLen, static_cast<uint32_t>(Device::PageSize));
+	}
+
+	static HAL_StatusTypeDef ReadStatus(uint8_t* pStatus)
+	{
+		static constexpr uint8_t cmd = CMD_RDSR;
+		HAL_StatusTypeDef E2PStatus;
+
+		Bus::Select();
+		E2PStatus = Bus::Send(&cmd, 1);
+		if(E2PStatus == HAL_OK) E2PStatus = Bus::Recv(pStatus, 1);
+		Bus::Deselect();
+		return E2PStatus;
+	}
+
+	/**
+	  * @brief  waits for the write cycle started by the previous write, if any.
+	  *         Like EEPROM_SPI_WaitReady it idles until just before the learned
+	  *         tWC and only then polls WIP every EEP_TWC_POLL_STEP_US
+	  */
+	static HAL_StatusTypeDef WaitReady()
+	{
+		uint8_t ucStatus = 0;
+		BSP_DeadlineTypeDef deadline = uwWriteStartUs + 4 * Device::TwcUs;
+		uint32_t uwFirstPoll, uwElapsed, uwLastBusy = 0, uwPolls = 0;
+
+		if(!ucWriteBusy) return HAL_OK;
+
+		uwFirstPoll = (uwTwcEstUs > uwTwcDevUs) ? (uwTwcEstUs - uwTwcDevUs) : 0;
+		BSP_DelayUs(BSP_Deadline_Remaining(uwWriteStartUs + uwFirstPoll), NONE_BLOCKING);
+
+		for(;;)
+		{
+			if(ReadStatus(&ucStatus) != HAL_OK) return HAL_ERROR;
+			uwElapsed = BSP_GetMicros() - uwWriteStartUs;
+			uwPolls++;
+
+			if(bitRead(ucStatus, BIT_WIP) == 0) break;
+			if(BSP_Deadline_Expired(deadline)) return HAL_TIMEOUT;
+
+			uwLastBusy = uwElapsed;
+			BSP_DelayUs(EEP_TWC_POLL_STEP_US, NONE_BLOCKING);
+		}
+
+		ucWriteBusy = 0;
+		if(uwPolls > 1) LearnTwc((uwLastBusy + uwElapsed) / 2);
+		else if(uwElapsed <= uwFirstPoll + 2 * EEP_TWC_POLL_STEP_US) LearnTwc(uwElapsed - EEP_TWC_POLL_STEP_US);
+		return HAL_OK;
+	}
+
+	/**
+	  * @brief  fixed write, split into page programs by the compiler. The first
+	  *         chunk is planned at compile time, the rest are page aligned and
+	  *         run as one loop, so a single page access is straight-line code
+	  *         and a long one does not nest a call per page
+	  */
+	template <uint32_t Addr, uint32_t N>
+	static HAL_StatusTypeDef Write(const uint8_t* pData)
+	{
+		static_assert(N > 0, "empty write");
+		static_assert(Addr < Device::Capacity && N <= Device::Capacity - Addr, "write beyond the device");
+
+		static constexpr uint32_t First = FirstChunk(Addr, N);
+		static constexpr Header h = MakeHeader(CMD_WRITE, Addr);
+		HAL_StatusTypeDef E2PStatus = WritePage(h, pData, First);
+
+		if constexpr (N > First){
+			for(uint32_t a = Addr + First; (a < Addr + N) && (E2PStatus == HAL_OK); a += Device::PageSize){
+				E2PStatus = WritePage(MakeHeader(CMD_WRITE, a), pData + (a - Addr), FirstChunk(a, Addr + N - a));
+			}
+		}
+		return E2PStatus;
+	}
+
+	/**
+	  * @brief  fixed read, one continuous READ
+	  */
+	template <uint32_t Addr, uint32_t N>
+	static HAL_StatusTypeDef Read(uint8_t* pData)
+	{
+		static_assert(N > 0, "empty read");
+		static_assert(Addr < Device::Capacity && N <= Device::Capacity - Addr, "read beyond the device");
+
+		static constexpr Header h = MakeHeader(CMD_READ, Addr);
+		return ReadRaw(h, pData, N);
+	}
+
+	/**
+	  * @brief  run time variants, same rules as BSP_EEPROM_Write/Read
+	  */
+	static HAL_StatusTypeDef Write(uint32_t Addr, const uint8_t* pData, uint32_t uwLen)
+	{
+		HAL_StatusTypeDef E2PStatus = HAL_OK;
+		uint32_t uwChunk;
+
+		if(pData == nullptr || Addr >= Device::Capacity || uwLen > Device::Capacity - Addr) return HAL_ERROR;
+
+		for(; (uwLen > 0) && (E2PStatus == HAL_OK); Addr += uwChunk, pData += uwChunk, uwLen -= uwChunk){
+			uwChunk = FirstChunk(Addr, uwLen);
+			E2PStatus = WritePage(MakeHeader(CMD_WRITE, Addr), pData, uwChunk);
+		}
+		return E2PStatus;
+	}
+
+	static HAL_StatusTypeDef Read(uint32_t Addr, uint8_t* pData, uint32_t uwLen)
+	{
+		if(pData == nullptr || uwLen == 0 || Addr >= Device::Capacity || uwLen > Device::Capacity - Addr) return HAL_ERROR;
+
+		return ReadRaw(MakeHeader(CMD_READ, Addr), pData, uwLen);
+	}
+
+private:
+	static inline uint8_t  ucWriteBusy = 0;
+	static inline uint32_t uwWriteStartUs = 0;
+	static inline uint32_t uwTwcEstUs = Device::TwcUs;
+	static inline uint32_t uwTwcDevUs = Device::TwcUs / 2;
+
+	/**
+	  * @brief  folds one observed write cycle time into the tWC estimate, same
+	  *         filter as EEPROM_SPI_LearnTwc
+	  */
+	static void LearnTwc(uint32_t uwSample)
+	{
+		int32_t iErr;
+
+		if(static_cast<int32_t>(uwSample) < 0) uwSample = 0;
+		if(uwSample > Device::TwcUs) uwSample = Device::TwcUs;
+
+		iErr = static_cast<int32_t>(uwSample) - static_cast<int32_t>(uwTwcEstUs);
+		uwTwcEstUs = static_cast<uint32_t>(static_cast<int32_t>(uwTwcEstUs) + iErr / EEP_TWC_EST_GAIN);
+
+		if(iErr < 0) iErr = -iErr;
+		uwTwcDevUs = static_cast<uint32_t>(static_cast<int32_t>(uwTwcDevUs) + (iErr - static_cast<int32_t>(uwTwcDevUs)) / EEP_TWC_DEV_GAIN);
+		if(uwTwcDevUs < EEP_TWC_POLL_STEP_US) uwTwcDevUs = EEP_TWC_POLL_STEP_US;
+	}
+
+	static HAL_StatusTypeDef WritePage(const Header& h, const uint8_t* pData, uint32_t uwLen)
+	{
+		static constexpr uint8_t wren = CMD_WREN;
+		HAL_StatusTypeDef E2PStatus;
+
+		if(WaitReady() != HAL_OK) return HAL_ERROR;
+
+		Bus::Select();
+		E2PStatus = Bus::Send(&wren, 1);
+		Bus::Deselect();
+		if(E2PStatus != HAL_OK) return E2PStatus;
+
+		Bus::Select();
+		E2PStatus = Bus::Send(h.Bytes, h.Len);
+		if(E2PStatus == HAL_OK) E2PStatus = Bus::Send(pData, uwLen);
+		Bus::Deselect();
+
+		uwWriteStartUs = BSP_GetMicros();
+		ucWriteBusy = 1;
+		return E2PStatus;
+	}
+
+	static HAL_StatusTypeDef ReadRaw(const Header& h, uint8_t* pData, uint32_t uwLen)
+	{
+		HAL_StatusTypeDef E2PStatus;
+
+		if(WaitReady() != HAL_OK) return HAL_ERROR;
+
+		Bus::Select();
+		E2PStatus = Bus::Send(h.Bytes, h.Len);
+		if(E2PStatus == HAL_OK) E2PStatus = Bus::Recv(pData, uwLen);
+		Bus::Deselect();
+		return E2PStatus;
+	}
+};
+
+#ifndef BSP_EEPROM_SIM
+using BoardEeprom = Eeprom<AT25160, BoardLlSpiBus>;
+#endif
+
+} // namespace bsp
+
+#endif /* __BSP_EEPROM_HPP */
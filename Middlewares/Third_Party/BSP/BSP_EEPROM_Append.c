@@ -0,0 +1,208 @@
+/**
+  ******************************************************************************
+  * @file    BSP_EEPROM_Append.c
+  * @author  Hossein Bagherzade(@realhba)
+	* @email	 hossein.bagherzade@gmail.com
+  * @version V1.0.0
+  * @date    18-Oct-2026
+  * @brief   Append writer for data produced a few bytes at a time, e.g. sensor
+  * samples. Every BSP_EEPROM_Write costs a write cycle however short it is, so
+  * the writer collects the bytes in a page aligned RAM buffer and programs a
+  * page only once it is full; flush writes the part of the tail page collected
+  * so far. A stream of small records costs one write cycle per page instead of
+  * one per record.
+  ******************************************************************************
+	**/
+
+#include "BSP_EEPROM_Append.h"
+#include "string.h"
+
+/**
+  * @brief  programs the buffered bytes on the writer's device and moves on to
+  *         the next page once the current one is complete
+  * @param  pWriter: writer handle
+	* @retval HAL_StatusTypeDef enum, HAL_OK in case of successful operation
+  */
+//==========================================================================
+static HAL_StatusTypeDef EEPROM_Append_Program(EEP_AppendTypeDef* pWriter)
+//==========================================================================
+{
+	HAL_StatusTypeDef E2PStatus;
+	EEP_DeviceTypeDef* pSaved = pEeprom;
+
+	if(pWriter->Fill == 0) return HAL_OK;
+
+	E2PStatus = EEPROM_SPI_Select(pWriter->pDevice);
+	if(E2PStatus == HAL_OK) E2PStatus = BSP_EEPROM_Write(pWriter->PageAddr + pWriter->Head, &pWriter->Buf[pWriter->Head], pWriter->Fill);
+	if(EEPROM_SPI_Select(pSaved) != HAL_OK) E2PStatus = HAL_ERROR;
+	if(E2PStatus != HAL_OK) return E2PStatus;
+
+	pWriter->Pages++;
+	pWriter->Head += pWriter->Fill;
+	pWriter->Fill = 0;
+
+	if(pWriter->Head == pWriter->pDevice->PageSize){
+		pWriter->PageAddr += pWriter->pDevice->PageSize;
+		pWriter->Head = 0;
+	}
+
+	return HAL_OK;
+}
+
+/**
+  * @brief  opens a writer on the selected device, appending from reg_address on
+  * @param  pWriter: writer handle
+  * @param  reg_address: first address to write, need not be page aligned
+	* @retval HAL_StatusTypeDef enum, HAL_OK in case of successful operation
+  */
+//==========================================================================================
+HAL_StatusTypeDef BSP_EEPROM_Append_Open(EEP_AppendTypeDef* pWriter, uint32_t reg_address)
+//==========================================================================================
+{
+	if(pWriter == NULL || pEeprom->PageSize > EEP_APPEND_PAGE_MAX || reg_address >= pEeprom->Capacity) return HAL_ERROR;
+
+	pWriter->pDevice = pEeprom;
+	pWriter->PageAddr = reg_address - (reg_address % pEeprom->PageSize);
+	pWriter->Head = (uint16_t)(reg_address % pEeprom->PageSize);
+	pWriter->Fill = 0;
+	pWriter->Pages = 0;
+	pWriter->Open = 1;
+
+	return HAL_OK;
+}
+
+/**
+  * @brief  appends bytes, every page they complete is programmed in one write
+  *         cycle and the rest stays buffered until it fills up or is flushed.
+  *         Nothing is taken if the data would run past the end of the device
+  * @param  pWriter: writer handle
+  * @param  data_buf: data to append
+  * @param  length: number of bytes
+	* @retval HAL_StatusTypeDef enum, HAL_OK in case of successful operation
+  */
+//================================================================================================================
+HAL_StatusTypeDef BSP_EEPROM_Append_Write(EEP_AppendTypeDef* pWriter, const uint8_t data_buf[], uint32_t length)
+//================================================================================================================
+{
+	HAL_StatusTypeDef E2PStatus = HAL_OK;
+	uint16_t uiPageSize;
+	uint32_t uwChunk;
+
+	if(pWriter == NULL || !pWriter->Open) return HAL_ERROR;
+	if(length > pWriter->pDevice->Capacity - BSP_EEPROM_Append_Tell(pWriter)) return HAL_ERROR;
+
+	uiPageSize = pWriter->pDevice->PageSize;
+	while((E2PStatus == HAL_OK) && (length > 0))
+	{
+		uwChunk = uiPageSize - pWriter->Head - pWriter->Fill;
+		if(uwChunk > length) uwChunk = length;
+
+		memcpy(&pWriter->Buf[pWriter->Head + pWriter->Fill], data_buf, uwChunk);
+		pWriter->Fill += (uint16_t)uwChunk;
+		data_buf += uwChunk;
+		length -= uwChunk;
+
+		if(pWriter->Head + pWriter->Fill == uiPageSize) E2PStatus = EEPROM_Append_Program(pWriter);
+	}
+
+	return E2PStatus;
+}
+
+/**
+  * @brief  programs the bytes buffered in the tail page. Later appends to the
+  *         same page cost another write cycle, so flush at record boundaries
+  *         that must survive a reset, not after every append
+  * @param  pWriter: writer handle
+	* @retval HAL_StatusTypeDef enum, HAL_OK in case of successful operation
+  */
+//=====================================================================
+HAL_StatusTypeDef BSP_EEPROM_Append_Flush(EEP_AppendTypeDef* pWriter)
+//=====================================================================
+{
+	if(pWriter == NULL || !pWriter->Open) return HAL_ERROR;
+
+	return EEPROM_Append_Program(pWriter);
+}
+
+/**
+  * @brief  flushes and closes the writer, it stays open if the flush fails so
+  *         the data is not lost and the close can be retried
+  * @param  pWriter: writer handle
+	* @retval HAL_StatusTypeDef enum, HAL_OK in case of successful operation
+  */
+//=====================================================================
+HAL_StatusTypeDef BSP_EEPROM_Append_Close(EEP_AppendTypeDef* pWriter)
+//=====================================================================
+{
+	HAL_StatusTypeDef E2PStatus = BSP_EEPROM_Append_Flush(pWriter);
+
+	if(E2PStatus == HAL_OK) pWriter->Open = 0;
+
+	return E2PStatus;
+}
+
+/**
+  * @brief  address the next appended byte goes to
+  * @param  pWriter: writer handle
+	* @retval device address
+  */
+//=================================================================
+uint32_t BSP_EEPROM_Append_Tell(const EEP_AppendTypeDef* pWriter)
+//=================================================================
+{
+	return pWriter->PageAddr + pWriter->Head + pWriter->Fill;
+}
+
+/**
+  * @brief  writes EEP_BENCH_PAGES pages as EEP_APPEND_BENCH_RECORD byte records,
+  *         once with a BSP_EEPROM_Write per record and once through a writer,
+  *         and compares write cycles and time. Both passes are verified
+	* @retval HAL_StatusTypeDef enum, HAL_OK in case of successful operation
+  */
+//=======================================================
+HAL_StatusTypeDef BSP_EEPROM_Append_BenchmarkTest(void)
+//=======================================================
+{
+	HAL_StatusTypeDef E2PStatus = HAL_OK;
+	EEP_AppendTypeDef writer;
+	uint8_t ucRecord[EEP_APPEND_BENCH_RECORD];
+	uint8_t ucBack[EEP_APPEND_PAGE_MAX];
+	uint32_t uwLength, uwCycles, uwStart, uwTime;
+
+	if(pEeprom->PageSize > EEP_APPEND_PAGE_MAX) return HAL_ERROR;
+	uwLength = (uint32_t)EEP_BENCH_PAGES * pEeprom->PageSize;
+	if(uwLength > pEeprom->Capacity) uwLength = pEeprom->Capacity;
+
+	EEP_LOG("EEPROM %d byte records, %lu bytes :\r\n\r\n", EEP_APPEND_BENCH_RECORD, (unsigned long)uwLength);
+
+	for(uint8_t ucPass = 0; (ucPass < 2) && (E2PStatus == HAL_OK); ucPass++)
+	{
+		if(ucPass == 1) E2PStatus = BSP_EEPROM_Append_Open(&writer, 0);
+
+		uwCycles = pEeprom->WriteCycles;
+		uwStart = BSP_GetMicros();
+		for(uint32_t a = 0; (a < uwLength) && (E2PStatus == HAL_OK); a += EEP_APPEND_BENCH_RECORD)
+		{
+			for(uint8_t i = 0; i < EEP_APPEND_BENCH_RECORD; i++) ucRecord[i] = (uint8_t)((a + i) * 5 + ucPass);
+			if(ucPass == 0) E2PStatus = BSP_EEPROM_Write(a, ucRecord, EEP_APPEND_BENCH_RECORD);
+			else E2PStatus = BSP_EEPROM_Append_Write(&writer, ucRecord, EEP_APPEND_BENCH_RECORD);
+		}
+		if((ucPass == 1) && (E2PStatus == HAL_OK)) E2PStatus = BSP_EEPROM_Append_Close(&writer);
+		if(E2PStatus == HAL_OK) E2PStatus = EEPROM_SPI_WaitReady();
+		uwTime = BSP_GetMicros() - uwStart;
+		uwCycles = pEeprom->WriteCycles - uwCycles;
+
+		for(uint32_t a = 0; (a < uwLength) && (E2PStatus == HAL_OK); a += pEeprom->PageSize)
+		{
+			E2PStatus = BSP_EEPROM_Read(a, ucBack, pEeprom->PageSize);
+			for(uint16_t i = 0; (i < pEeprom->PageSize) && (E2PStatus == HAL_OK); i++){
+				if(ucBack[i] != (uint8_t)((a + i) * 5 + ucPass)) E2PStatus = HAL_ERROR;
+			}
+		}
+
+		EEP_LOG("%s: %lu write cycles, %lu us %s\r\n", (ucPass == 0) ? "per record" : "appender  ",
+						(unsigned long)uwCycles, (unsigned long)uwTime, (E2PStatus == HAL_OK) ? "Passed" : "Failed");
+	}
+
+	return E2PStatus;
+}
@@ -0,0 +1,51 @@
+/**
+  ******************************************************************************
+  * @file    BSP_EEPROM_Append.h
+  * @author  Hossein Bagherzade(@realhba)
+	* @email	 hossein.bagherzade@gmail.com
+  * @version V1.0.0
+  * @date    18-Oct-2026
+  * @brief   Header file for BSP_EEPROM_Append.c
+  ******************************************************************************
+	**/
+
+
+#ifndef __BSP_EEPROM_APPEND_H
+#define __BSP_EEPROM_APPEND_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "BSP_EEPROM.h"
+
+
+#define EEP_APPEND_PAGE_MAX							 (uint16_t)64 		// largest page a writer buffers
+#define EEP_APPEND_BENCH_RECORD					 (uint8_t)4 			// bytes per call in the benchmark, a typical sample
+
+typedef struct
+{
+	EEP_DeviceTypeDef* pDevice;																	// device the writer was opened on
+	uint32_t PageAddr;																					// start of the page in the buffer
+	uint16_t Head;																							// first buffered offset in the page, already flushed below it
+	uint16_t Fill;																							// buffered bytes from Head on
+	uint8_t  Open;
+	uint8_t  Buf[EEP_APPEND_PAGE_MAX];
+	uint32_t Pages;																							// statistics: page programs issued
+} EEP_AppendTypeDef;
+
+
+HAL_StatusTypeDef BSP_EEPROM_Append_Open(EEP_AppendTypeDef* pWriter, uint32_t reg_address);
+HAL_StatusTypeDef BSP_EEPROM_Append_Write(EEP_AppendTypeDef* pWriter, const uint8_t data_buf[], uint32_t length);
+HAL_StatusTypeDef BSP_EEPROM_Append_Flush(EEP_AppendTypeDef* pWriter);
+HAL_StatusTypeDef BSP_EEPROM_Append_Close(EEP_AppendTypeDef* pWriter);
+uint32_t BSP_EEPROM_Append_Tell(const EEP_AppendTypeDef* pWriter);
+HAL_StatusTypeDef BSP_EEPROM_Append_BenchmarkTest(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __BSP_EEPROM_APPEND_H */
+
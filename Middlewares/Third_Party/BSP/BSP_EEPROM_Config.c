@@ -0,0 +1,190 @@
+/**
+  ******************************************************************************
+  * @file    BSP_EEPROM_Config.c
+  * @author  Hossein Bagherzade(@realhba)
+	* @email	 hossein.bagherzade@gmail.com
+  * @version V1.0.0
+  * @date    18-Oct-2026
+  * @brief   Versioned configuration block. A small header (magic, version,
+  * length, CRC) precedes the body. At boot header and body come in with one
+  * read into a RAM shadow, older layouts are upgraded by a chain of migration
+  * functions, and write back programs only the pages whose bytes changed.
+  ******************************************************************************
+	**/
+
+#include "BSP_EEPROM_Config.h"
+#include "BSP_EEPROM_Flash.h"
+#include "string.h"
+#include "stddef.h"
+
+#define EEP_CONFIG_PAGE_MAX							 (uint16_t)64 		// largest page size compared on commit
+
+EEP_ConfigTypeDef hEepConfig;
+
+/**
+  * @brief  CRC-16 of an image: header fields in front of the CRC, then the body
+  * @param  pImage: image to run over
+	* @retval crc
+  */
+//==============================================================
+static uint16_t BSP_EEPROM_Config_Crc(EEP_ConfigImageTypeDef* pImage)
+//==============================================================
+{
+	uint16_t uiCrc = EEPROM_SPI_Crc16(0xFFFF, (uint8_t*)&pImage->Header, offsetof(EEP_ConfigHeaderTypeDef, Crc));
+
+	return EEPROM_SPI_Crc16(uiCrc, (uint8_t*)pImage->Body, pImage->Header.Length);
+}
+
+/**
+  * @brief  replaces the body with the defaults of the current layout
+  * @param  pSchema: layout the firmware uses
+  * @param  pImage: image to reset
+	* @retval none
+  */
+//=======================================================================================================
+static void BSP_EEPROM_Config_Defaults(const EEP_ConfigSchemaTypeDef* pSchema, EEP_ConfigImageTypeDef* pImage)
+//=======================================================================================================
+{
+	memset(pImage->Body, 0, sizeof(pImage->Body));
+	if(pSchema->Defaults != NULL) pSchema->Defaults((uint8_t*)pImage->Body);
+
+	pImage->Header.Version = pSchema->Version;
+	pImage->Header.Length = pSchema->Length;
+}
+
+/**
+  * @brief  brings an image read from the eeprom to the current layout. It has no
+  *         bus access, so migrations can be checked on the host with golden images.
+  * @param  pSchema: layout the firmware uses
+  * @param  pImage: image as stored, upgraded in place with a fresh header
+  * @param  pOrigin: what had to be done to the image
+	* @retval HAL_StatusTypeDef enum, HAL_OK in case of successful operation
+  */
+//===============================================================================================================================================
+HAL_StatusTypeDef BSP_EEPROM_Config_Upgrade(const EEP_ConfigSchemaTypeDef* pSchema, EEP_ConfigImageTypeDef* pImage, EEP_ConfigOriginTypeDef* pOrigin)
+//===============================================================================================================================================
+{
+	EEP_ConfigHeaderTypeDef* pHeader = &pImage->Header;
+	EEP_ConfigMigrateFn fMigrate;
+	uint16_t uiLength;
+
+	if(pSchema == NULL || pImage == NULL || pOrigin == NULL || pSchema->Length > EEP_CONFIG_BODY_MAX) return HAL_ERROR;
+
+	if((pHeader->Magic != EEP_CONFIG_MAGIC) || (pHeader->Length > EEP_CONFIG_BODY_MAX) || (pHeader->Crc != BSP_EEPROM_Config_Crc(pImage))){
+		*pOrigin = EEP_CONFIG_DEFAULTED;
+	}
+	else if(pHeader->Version == pSchema->Version){
+		*pOrigin = (pHeader->Length == pSchema->Length) ? EEP_CONFIG_LOADED : EEP_CONFIG_DEFAULTED;
+	}
+	else if(pHeader->Version > pSchema->Version){
+		// written by a newer firmware, keep it intact for when that firmware returns
+		*pOrigin = EEP_CONFIG_NEWER;
+	}
+	else{
+		*pOrigin = EEP_CONFIG_MIGRATED;
+		uiLength = pHeader->Length;
+
+		for(uint16_t v = pHeader->Version; v < pSchema->Version; v++)
+		{
+			fMigrate = (pSchema->pMigrations != NULL && v >= pSchema->FirstVersion) ? pSchema->pMigrations[v - pSchema->FirstVersion] : NULL;
+			if((fMigrate == NULL) || (fMigrate((uint8_t*)pImage->Body, &uiLength) != HAL_OK) || (uiLength > EEP_CONFIG_BODY_MAX)){
+				*pOrigin = EEP_CONFIG_DEFAULTED;
+				break;
+			}
+		}
+		if(uiLength != pSchema->Length) *pOrigin = EEP_CONFIG_DEFAULTED;
+
+		pHeader->Version = pSchema->Version;
+		pHeader->Length = uiLength;
+	}
+
+	if(*pOrigin != EEP_CONFIG_LOADED){
+		if(*pOrigin != EEP_CONFIG_MIGRATED) BSP_EEPROM_Config_Defaults(pSchema, pImage);
+		pHeader->Magic = EEP_CONFIG_MAGIC;
+		pHeader->Crc = BSP_EEPROM_Config_Crc(pImage);
+	}
+
+	return HAL_OK;
+}
+
+/**
+  * @brief  loads the config block into hEepConfig.Shadow with a single read,
+  *         upgrades it to the current layout and writes back what changed
+  * @param  pSchema: layout the firmware uses, must stay valid
+	* @retval HAL_StatusTypeDef enum, HAL_OK in case of successful operation
+  */
+//==================================================================================
+HAL_StatusTypeDef BSP_EEPROM_Config_Init(const EEP_ConfigSchemaTypeDef* pSchema)
+//==================================================================================
+{
+	HAL_StatusTypeDef E2PStatus;
+	uint32_t uwLength = sizeof(hEepConfig.Shadow);
+
+	if(pSchema == NULL || pSchema->Address + EEP_CONFIG_HDR_SIZE + pSchema->Length > EEP_BACKEND_CAPACITY) return HAL_ERROR;
+
+	hEepConfig.pSchema = pSchema;
+	hEepConfig.PagesWritten = 0;
+
+	// header and the largest body in one go, no second transaction once the length is known
+	memset(&hEepConfig.Shadow, 0xFF, sizeof(hEepConfig.Shadow));
+	if(pSchema->Address + uwLength > EEP_BACKEND_CAPACITY) uwLength = EEP_BACKEND_CAPACITY - pSchema->Address;
+
+#if (USE_FLASH_EEPROM == 1)
+	E2PStatus = BSP_EEPROM_Flash_Read(pSchema->Address, (uint8_t*)&hEepConfig.Shadow, uwLength);
+#else
+	E2PStatus = EEPROM_SPI_ReadBuffer((uint8_t*)&hEepConfig.Shadow, pSchema->Address, uwLength);
+#endif
+	if(E2PStatus != HAL_OK) return E2PStatus;
+
+	E2PStatus = BSP_EEPROM_Config_Upgrade(pSchema, &hEepConfig.Shadow, &hEepConfig.Origin);
+	if(E2PStatus != HAL_OK) return E2PStatus;
+
+	EEP_LOG("Config v%u: %s\r\n", hEepConfig.Shadow.Header.Version,
+		(hEepConfig.Origin == EEP_CONFIG_LOADED) ? "loaded" : (hEepConfig.Origin == EEP_CONFIG_MIGRATED) ? "migrated" :
+		(hEepConfig.Origin == EEP_CONFIG_DEFAULTED) ? "defaulted" : "newer layout, not written");
+
+	if(hEepConfig.Origin == EEP_CONFIG_MIGRATED || hEepConfig.Origin == EEP_CONFIG_DEFAULTED) return BSP_EEPROM_Config_Commit();
+
+	return HAL_OK;
+}
+
+/**
+  * @brief  stores the shadow after the application changed it. Every page of the
+  *         block is compared with the eeprom and only differing pages are programmed.
+	* @retval HAL_StatusTypeDef enum, HAL_OK in case of successful operation
+  */
+//==============================================
+HAL_StatusTypeDef BSP_EEPROM_Config_Commit(void)
+//==============================================
+{
+	HAL_StatusTypeDef E2PStatus = HAL_OK;
+	EEP_ChunkPlanTypeDef plan;
+	uint8_t* pImage = (uint8_t*)&hEepConfig.Shadow;
+	uint8_t ucPage[EEP_CONFIG_PAGE_MAX];
+
+	// a block of a newer layout is never overwritten by an older firmware
+	if(hEepConfig.pSchema == NULL || hEepConfig.Origin == EEP_CONFIG_NEWER || pEeprom->PageSize > EEP_CONFIG_PAGE_MAX) return HAL_ERROR;
+
+	hEepConfig.Shadow.Header.Crc = BSP_EEPROM_Config_Crc(&hEepConfig.Shadow);
+	hEepConfig.PagesWritten = 0;
+
+	EEPROM_SPI_PlanInit(&plan, hEepConfig.pSchema->Address, EEP_CONFIG_HDR_SIZE + hEepConfig.Shadow.Header.Length, pEeprom->PageSize);
+	while((E2PStatus == HAL_OK) && EEPROM_SPI_PlanNext(&plan))
+	{
+#if (USE_FLASH_EEPROM == 1)
+		E2PStatus = BSP_EEPROM_Flash_Read(plan.Addr, ucPage, plan.Len);
+#else
+		E2PStatus = EEPROM_SPI_ReadBuffer(ucPage, plan.Addr, plan.Len);
+#endif
+		if((E2PStatus != HAL_OK) || (memcmp(ucPage, &pImage[plan.Offset], plan.Len) == 0)) continue;
+
+#if (USE_FLASH_EEPROM == 1)
+		E2PStatus = BSP_EEPROM_Flash_Write(plan.Addr, &pImage[plan.Offset], plan.Len);
+#else
+		E2PStatus = EEPROM_SPI_WritePage(&pImage[plan.Offset], plan.Addr, plan.Len);
+#endif
+		hEepConfig.PagesWritten++;
+	}
+
+	return E2PStatus;
+}
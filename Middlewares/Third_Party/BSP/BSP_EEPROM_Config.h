@@ -0,0 +1,88 @@
+/**
+  ******************************************************************************
+  * @file    BSP_EEPROM_Config.h
+  * @author  Hossein Bagherzade(@realhba)
+	* @email	 hossein.bagherzade@gmail.com
+  * @version V1.0.0
+  * @date    18-Oct-2026
+  * @brief   Header file for BSP_EEPROM_Config.c
+  ******************************************************************************
+	**/
+
+
+#ifndef __BSP_EEPROM_CONFIG_H
+#define __BSP_EEPROM_CONFIG_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "BSP_EEPROM.h"
+
+
+#define EEP_CONFIG_MAGIC								 (uint16_t)0xC0F6 	// marks a formatted config block
+#define EEP_CONFIG_BODY_MAX							 (uint16_t)256 		// largest body of any layout version
+#define EEP_CONFIG_HDR_SIZE							 (uint16_t)sizeof(EEP_ConfigHeaderTypeDef)
+
+// Application view of the shadow body, e.g. EEP_CONFIG_BODY(AppConfigTypeDef)->Baudrate
+#define EEP_CONFIG_BODY(type) 					 ((type*)(void*)hEepConfig.Shadow.Body)
+
+typedef struct
+{
+	uint16_t Magic;
+	uint16_t Version;																						// layout version of the body
+	uint16_t Length;																						// body bytes following the header
+	uint16_t Crc;																								// CRC-16 over Magic..Length and the body
+} EEP_ConfigHeaderTypeDef;
+
+typedef struct
+{
+	EEP_ConfigHeaderTypeDef Header;
+	uint32_t Body[EEP_CONFIG_BODY_MAX / 4];											// word aligned so it can be cast to a struct
+} EEP_ConfigImageTypeDef;
+
+// Converts a body of layout v into layout v + 1 in place. It may grow or shrink
+// *puiLength up to EEP_CONFIG_BODY_MAX and has no bus access, so it can be run
+// on the host against golden images.
+typedef HAL_StatusTypeDef (*EEP_ConfigMigrateFn)(uint8_t* pBody, uint16_t* puiLength);
+
+typedef struct
+{
+	uint32_t Address;																						// eeprom address of the header
+	uint16_t Version;																						// layout the firmware uses
+	uint16_t Length;																						// body size of that layout
+	void (*Defaults)(uint8_t* pBody);														// fills a blank body of the current layout
+	const EEP_ConfigMigrateFn* pMigrations;											// [v] migrates v -> v + 1
+	uint16_t FirstVersion;																			// version pMigrations[0] starts from
+} EEP_ConfigSchemaTypeDef;
+
+typedef enum
+{
+	EEP_CONFIG_LOADED = 0,																			// stored block was current
+	EEP_CONFIG_MIGRATED,																				// stored block was upgraded and written back
+	EEP_CONFIG_DEFAULTED,																				// no valid block, defaults written
+	EEP_CONFIG_NEWER																						// block is from newer firmware, defaults in RAM only
+} EEP_ConfigOriginTypeDef;
+
+typedef struct
+{
+	const EEP_ConfigSchemaTypeDef* pSchema;
+	EEP_ConfigImageTypeDef Shadow;															// RAM copy of header and body
+	EEP_ConfigOriginTypeDef Origin;
+	uint16_t PagesWritten;																			// statistics: pages programmed by the last commit
+} EEP_ConfigTypeDef;
+
+
+extern EEP_ConfigTypeDef hEepConfig;
+
+HAL_StatusTypeDef BSP_EEPROM_Config_Init(const EEP_ConfigSchemaTypeDef* pSchema);
+HAL_StatusTypeDef BSP_EEPROM_Config_Upgrade(const EEP_ConfigSchemaTypeDef* pSchema, EEP_ConfigImageTypeDef* pImage, EEP_ConfigOriginTypeDef* pOrigin);
+HAL_StatusTypeDef BSP_EEPROM_Config_Commit(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __BSP_EEPROM_CONFIG_H */
+
@@ -0,0 +1,441 @@
+/**
+  ******************************************************************************
+  * @file    BSP_EEPROM_Diag.c
+  * @author  Hossein Bagherzade(@realhba)
+	* @email	 hossein.bagherzade@gmail.com
+  * @version V1.0.0
+  * @date    18-Oct-2026
+  * @brief   Memory diagnostics for the EEPROM. The range is tested in blocks of
+  * EEP_DIAG_BLOCK bytes that are saved before and restored after the tests, so
+  * a field unit keeps its data. Every write is a full page and every verify a
+  * streaming READ, which keeps a whole chip test in the order of seconds. A
+  * decoder pass over the whole range catches addresses aliasing across blocks,
+  * a coupling pass over every pair of blocks catches cells disturbed by writes
+  * to another block; it is quadratic in the number of blocks. Such a victim
+  * cannot be saved before it is found, so the XOR of all blocks is kept from
+  * the start and the disturbed block is rebuilt from it at the end.
+  ******************************************************************************
+	**/
+
+#include "BSP_EEPROM_Diag.h"
+#include "string.h"
+
+#define DIAG_NO_VICTIM 									 0xFFFFFFFFU 			// no block was disturbed by another one
+#define DIAG_VICTIMS 										 0xFFFFFFFEU 			// more than one, parity rebuilds only one
+
+// March C- after the initial w0, one element per row: direction, read, write
+static const struct { int8_t Dir; uint8_t Read; uint8_t Write; } DiagMarch[] =
+{
+	{ +1, 0x00, 0xFF }, { +1, 0xFF, 0x00 }, { -1, 0x00, 0xFF }, { -1, 0xFF, 0x00 }
+};
+
+// Coupling pass on a pair of blocks, one row per block fill: block (0/1), value, check the other one.
+// Each block is written with the other holding 0x00 and 0xFF, so every copied bit shows.
+static const struct { uint8_t Block; uint8_t Write; uint8_t Check; } DiagCoupling[] =
+{
+	{ 0, 0x00, 0 }, { 1, 0xFF, 1 }, { 0, 0x00, 1 }, { 0, 0xFF, 0 }, { 1, 0x00, 1 }, { 0, 0xFF, 1 }
+};
+
+static const char* DiagPhaseName[EEP_DIAG_PHASES] = { "Decoder", "Coupling", "March C-", "Walking 1", "Addr-in-addr" };
+
+static uint8_t ucDiagSave[EEP_DIAG_BLOCK];
+static uint8_t ucDiagPair[EEP_DIAG_BLOCK];
+static uint8_t ucDiagParity[EEP_DIAG_BLOCK];																// XOR of all blocks on entry
+
+/**
+  * @brief  test value of one byte
+  * @param  phase: running test
+  * @param  ucStep: background for March, bit offset for walking ones
+  * @param  uwAddr: byte address
+	* @retval expected byte
+  */
+//================================================================================================
+static uint8_t BSP_EEPROM_Diag_Value(EEP_DiagPhaseTypeDef phase, uint8_t ucStep, uint32_t uwAddr)
+//================================================================================================
+{
+	switch(phase){
+		case EEP_DIAG_WALKING: 	return (uint8_t)(1U << ((uwAddr + ucStep) & 7));
+		case EEP_DIAG_ADDRESS: 	return (uint8_t)(uwAddr ^ (uwAddr >> 8) ^ (uwAddr >> 16));
+		default: 								return ucStep;
+	}
+}
+
+/**
+  * @brief  books one read back byte into the report
+  * @param  pReport: report to update
+  * @param  phase: running test
+  * @param  uwAddr: byte address
+  * @param  ucGot: value read
+  * @param  ucExpected: value written
+	* @retval none
+  */
+//=============================================================================================================================================
+static void BSP_EEPROM_Diag_Check(EEP_DiagReportTypeDef* pReport, EEP_DiagPhaseTypeDef phase, uint32_t uwAddr, uint8_t ucGot, uint8_t ucExpected)
+//=============================================================================================================================================
+{
+	uint8_t ucMask = ucGot ^ ucExpected;
+
+	if(ucMask == 0) return;
+
+	if(pReport->Errors < EEP_DIAG_MAX_FAILS){
+		pReport->Fail[pReport->Errors].Addr = uwAddr;
+		pReport->Fail[pReport->Errors].Mask = ucMask;
+		pReport->Fail[pReport->Errors].Phase = (uint8_t)phase;
+	}
+	pReport->Errors++;
+	pReport->Phase[phase].Errors++;
+	pReport->Phase[phase].Mask |= ucMask;
+}
+
+/**
+  * @brief  programs one page with the test values
+  * @param  pReport: report to update
+  * @param  phase: running test
+  * @param  ucStep: see BSP_EEPROM_Diag_Value
+  * @param  uwPage: page address
+	* @retval HAL_StatusTypeDef enum, HAL_OK in case of successful operation
+  */
+//===========================================================================================================================
+static HAL_StatusTypeDef BSP_EEPROM_Diag_Write(EEP_DiagReportTypeDef* pReport, EEP_DiagPhaseTypeDef phase, uint8_t ucStep, uint32_t uwPage)
+//===========================================================================================================================
+{
+	uint8_t ucPage[EEP_DIAG_PAGE_MAX];
+
+	for(uint16_t i = 0; i < pEeprom->PageSize; i++) ucPage[i] = BSP_EEPROM_Diag_Value(phase, ucStep, uwPage + i);
+
+	pReport->Phase[phase].Bytes += pEeprom->PageSize;
+	return EEPROM_SPI_WritePage(ucPage, uwPage, pEeprom->PageSize);
+}
+
+/**
+  * @brief  reads a range back in one continuous READ and checks every byte
+  * @param  pReport: report to update
+  * @param  phase: running test
+  * @param  ucStep: see BSP_EEPROM_Diag_Value
+  * @param  uwBase: first address
+  * @param  uwLength: number of bytes, a multiple of the page size
+	* @retval HAL_StatusTypeDef enum, HAL_OK in case of successful operation
+  */
+//=========================================================================================================================================================
+static HAL_StatusTypeDef BSP_EEPROM_Diag_Verify(EEP_DiagReportTypeDef* pReport, EEP_DiagPhaseTypeDef phase, uint8_t ucStep, uint32_t uwBase, uint32_t uwLength)
+//=========================================================================================================================================================
+{
+	HAL_StatusTypeDef E2PStatus;
+	uint8_t ucPage[EEP_DIAG_PAGE_MAX];
+
+	E2PStatus = EEPROM_SPI_ReadStart(uwBase);
+	for(uint32_t uwAddr = uwBase; (uwAddr < uwBase + uwLength) && (E2PStatus == HAL_OK); uwAddr += pEeprom->PageSize)
+	{
+		E2PStatus = EEPROM_SPI_ReadNext(ucPage, pEeprom->PageSize);
+		for(uint16_t i = 0; i < pEeprom->PageSize; i++){
+			BSP_EEPROM_Diag_Check(pReport, phase, uwAddr + i, ucPage[i], BSP_EEPROM_Diag_Value(phase, ucStep, uwAddr + i));
+		}
+	}
+	EEPROM_SPI_ReadStop();
+
+	pReport->Phase[phase].Bytes += uwLength;
+	return E2PStatus;
+}
+
+/**
+  * @brief  decoder pass: the first byte of every page gets the page number and
+  *         all of them are read back, so an address line stuck or shorted across
+  *         blocks shows up as a wrong tag. Only those bytes are saved, and
+  *         only the pages whose tag was written are put back.
+  * @param  pReport: report to update
+  * @param  uwAddress: first address, page aligned
+  * @param  uwPages: number of pages, at most EEP_DIAG_MAX_PAGES
+	* @retval HAL_StatusTypeDef enum, HAL_OK in case of successful operation
+  */
+//=======================================================================================================================
+static HAL_StatusTypeDef BSP_EEPROM_Diag_Decoder(EEP_DiagReportTypeDef* pReport, uint32_t uwAddress, uint32_t uwPages)
+//=======================================================================================================================
+{
+	HAL_StatusTypeDef E2PStatus = HAL_OK;
+	uint32_t uwPage, uwTagged = 0;
+	uint8_t ucTag;
+
+	for(uint32_t p = 0; (p < uwPages) && (E2PStatus == HAL_OK); p++){
+		E2PStatus = EEPROM_SPI_ReadBuffer(&ucDiagSave[p], uwAddress + p * pEeprom->PageSize, 1);
+	}
+
+	// a failed write counts as tagged, part of the page may have been programmed
+	for(; (uwTagged < uwPages) && (E2PStatus == HAL_OK); uwTagged++){
+		ucTag = (uint8_t)uwTagged;
+		E2PStatus = EEPROM_SPI_WritePage(&ucTag, uwAddress + uwTagged * pEeprom->PageSize, 1);
+	}
+
+	for(uint32_t p = 0; (p < uwPages) && (E2PStatus == HAL_OK); p++){
+		uwPage = uwAddress + p * pEeprom->PageSize;
+		E2PStatus = EEPROM_SPI_ReadBuffer(&ucTag, uwPage, 1);
+		BSP_EEPROM_Diag_Check(pReport, EEP_DIAG_DECODER, uwPage, ucTag, (uint8_t)p);
+	}
+
+	for(uint32_t p = 0; p < uwTagged; p++){
+		if(EEPROM_SPI_WritePage(&ucDiagSave[p], uwAddress + p * pEeprom->PageSize, 1) != HAL_OK) E2PStatus = HAL_ERROR;
+	}
+
+	pReport->Phase[EEP_DIAG_DECODER].Bytes += 4 * uwPages;
+	return E2PStatus;
+}
+
+/**
+  * @brief  coupling test of two blocks, both saved and restored. The block that
+  *         read back wrong is restored last, writes to the other one would
+  *         disturb it again.
+  * @param  pReport: report to update
+  * @param  uwBase: first address of each block
+  * @param  uwLen: length of each block
+  * @param  ucHit: set to 1 for a block that was disturbed by the other one
+	* @retval HAL_StatusTypeDef enum, HAL_OK in case of successful operation
+  */
+//==================================================================================================================================================
+static HAL_StatusTypeDef BSP_EEPROM_Diag_Pair(EEP_DiagReportTypeDef* pReport, const uint32_t uwBase[2], const uint32_t uwLen[2], uint8_t ucHit[2])
+//==================================================================================================================================================
+{
+	HAL_StatusTypeDef E2PStatus;
+	uint8_t* pSave[2] = { ucDiagSave, ucDiagPair };
+	uint8_t ucHeld[2] = { 0, 0 }, b, o;
+	uint32_t uwErrors;
+
+	E2PStatus = EEPROM_SPI_ReadBuffer(ucDiagSave, uwBase[0], uwLen[0]);
+	if(E2PStatus == HAL_OK) E2PStatus = EEPROM_SPI_ReadBuffer(ucDiagPair, uwBase[1], uwLen[1]);
+	if(E2PStatus != HAL_OK) return E2PStatus;
+
+	for(uint8_t r = 0; (r < sizeof(DiagCoupling) / sizeof(DiagCoupling[0])) && (E2PStatus == HAL_OK); r++)
+	{
+		b = DiagCoupling[r].Block;
+		o = b ^ 1;
+		for(uint32_t uwPage = uwBase[b]; (uwPage < uwBase[b] + uwLen[b]) && (E2PStatus == HAL_OK); uwPage += pEeprom->PageSize){
+			E2PStatus = BSP_EEPROM_Diag_Write(pReport, EEP_DIAG_COUPLING, DiagCoupling[r].Write, uwPage);
+		}
+		ucHeld[b] = DiagCoupling[r].Write;
+
+		if(DiagCoupling[r].Check && E2PStatus == HAL_OK){
+			uwErrors = pReport->Phase[EEP_DIAG_COUPLING].Errors;
+			E2PStatus = BSP_EEPROM_Diag_Verify(pReport, EEP_DIAG_COUPLING, ucHeld[o], uwBase[o], uwLen[o]);
+			if(pReport->Phase[EEP_DIAG_COUPLING].Errors != uwErrors) ucHit[o] = 1;
+		}
+	}
+
+	b = (ucHit[0] != 0) ? 1 : 0;
+	if(EEPROM_SPI_WriteBuffer(pSave[b], uwBase[b], uwLen[b]) != HAL_OK) E2PStatus = HAL_ERROR;
+	b ^= 1;
+	if(EEPROM_SPI_WriteBuffer(pSave[b], uwBase[b], uwLen[b]) != HAL_OK) E2PStatus = HAL_ERROR;
+
+	return E2PStatus;
+}
+
+/**
+  * @brief  coupling pass over every pair of blocks
+  * @param  pReport: report to update
+  * @param  uwAddress: first address, page aligned
+  * @param  uwLength: number of bytes, a multiple of the page size
+  * @param  uwBlock: block size, a multiple of the page size
+  * @param  pVictim: disturbed block, DIAG_NO_VICTIM or DIAG_VICTIMS
+	* @retval HAL_StatusTypeDef enum, HAL_OK in case of successful operation
+  */
+//=============================================================================================================================================================
+static HAL_StatusTypeDef BSP_EEPROM_Diag_Coupling(EEP_DiagReportTypeDef* pReport, uint32_t uwAddress, uint32_t uwLength, uint32_t uwBlock, uint32_t* pVictim)
+//=============================================================================================================================================================
+{
+	HAL_StatusTypeDef E2PStatus = HAL_OK;
+	uint32_t uwBlocks = (uwLength + uwBlock - 1) / uwBlock;
+	uint32_t uwBase[2], uwLen[2], uwBlockNo[2];
+	uint8_t ucHit[2];
+
+	*pVictim = DIAG_NO_VICTIM;
+
+	for(uint32_t a = 0; (a < uwBlocks) && (E2PStatus == HAL_OK); a++)
+	{
+		for(uint32_t v = a + 1; (v < uwBlocks) && (E2PStatus == HAL_OK); v++)
+		{
+			uwBlockNo[0] = a;
+			uwBlockNo[1] = v;
+			uwBase[0] = uwAddress + a * uwBlock;
+			uwBase[1] = uwAddress + v * uwBlock;
+			uwLen[0] = uwBlock;
+			uwLen[1] = (uwLength - v * uwBlock < uwBlock) ? (uwLength - v * uwBlock) : uwBlock;
+			ucHit[0] = ucHit[1] = 0;
+
+			E2PStatus = BSP_EEPROM_Diag_Pair(pReport, uwBase, uwLen, ucHit);
+
+			for(uint8_t b = 0; b < 2; b++){
+				if(ucHit[b] == 0 || *pVictim == uwBlockNo[b]) continue;
+				*pVictim = (*pVictim == DIAG_NO_VICTIM) ? uwBlockNo[b] : DIAG_VICTIMS;
+			}
+		}
+	}
+
+	return E2PStatus;
+}
+
+/**
+  * @brief  XORs every block of the range but one into a buffer
+  * @param  pParity: block sized buffer to XOR into
+  * @param  uwAddress: first address, page aligned
+  * @param  uwLength: number of bytes, a multiple of the page size
+  * @param  uwBlock: block size, a multiple of the page size
+  * @param  uwSkip: block left out, DIAG_NO_VICTIM for none
+	* @retval HAL_StatusTypeDef enum, HAL_OK in case of successful operation
+  */
+//===========================================================================================================================================
+static HAL_StatusTypeDef BSP_EEPROM_Diag_Parity(uint8_t* pParity, uint32_t uwAddress, uint32_t uwLength, uint32_t uwBlock, uint32_t uwSkip)
+//===========================================================================================================================================
+{
+	HAL_StatusTypeDef E2PStatus = HAL_OK;
+	uint32_t uwLen;
+
+	for(uint32_t uwDone = 0; (uwDone < uwLength) && (E2PStatus == HAL_OK); uwDone += uwLen)
+	{
+		uwLen = (uwLength - uwDone < uwBlock) ? (uwLength - uwDone) : uwBlock;
+		if(uwDone / uwBlock == uwSkip) continue;
+
+		E2PStatus = EEPROM_SPI_ReadBuffer(ucDiagPair, uwAddress + uwDone, uwLen);
+		for(uint32_t i = 0; i < uwLen; i++) pParity[i] ^= ucDiagPair[i];
+	}
+
+	return E2PStatus;
+}
+
+/**
+  * @brief  March C-, walking ones and address in address over one saved block
+  * @param  pReport: report to update
+  * @param  uwBase: first address, page aligned
+  * @param  uwLength: number of bytes, a multiple of the page size
+	* @retval HAL_StatusTypeDef enum, HAL_OK in case of successful operation
+  */
+//==========================================================================================================
+static HAL_StatusTypeDef BSP_EEPROM_Diag_Block(EEP_DiagReportTypeDef* pReport, uint32_t uwBase, uint32_t uwLength)
+//==========================================================================================================
+{
+	HAL_StatusTypeDef E2PStatus = HAL_OK;
+	uint32_t uwPages = uwLength / pEeprom->PageSize, uwPage, uwStart;
+
+	// March C-: w0, then each element reads and writes page by page in its direction, r0 at the end
+	uwStart = BSP_GetMicros();
+	for(uint32_t p = 0; (p < uwPages) && (E2PStatus == HAL_OK); p++){
+		E2PStatus = BSP_EEPROM_Diag_Write(pReport, EEP_DIAG_MARCH, 0x00, uwBase + p * pEeprom->PageSize);
+	}
+	for(uint8_t e = 0; (e < sizeof(DiagMarch) / sizeof(DiagMarch[0])) && (E2PStatus == HAL_OK); e++)
+	{
+		for(uint32_t p = 0; (p < uwPages) && (E2PStatus == HAL_OK); p++){
+			uwPage = uwBase + ((DiagMarch[e].Dir > 0) ? p : (uwPages - 1 - p)) * pEeprom->PageSize;
+			E2PStatus = BSP_EEPROM_Diag_Verify(pReport, EEP_DIAG_MARCH, DiagMarch[e].Read, uwPage, pEeprom->PageSize);
+			if(E2PStatus == HAL_OK) E2PStatus = BSP_EEPROM_Diag_Write(pReport, EEP_DIAG_MARCH, DiagMarch[e].Write, uwPage);
+		}
+	}
+	if(E2PStatus == HAL_OK) E2PStatus = BSP_EEPROM_Diag_Verify(pReport, EEP_DIAG_MARCH, 0x00, uwBase, uwLength);
+	pReport->Phase[EEP_DIAG_MARCH].Micros += BSP_GetMicros() - uwStart;
+
+	// walking ones, the set bit moves with the address so neighbours always differ
+	uwStart = BSP_GetMicros();
+	for(uint8_t b = 0; (b < 8) && (E2PStatus == HAL_OK); b++)
+	{
+		for(uint32_t p = 0; (p < uwPages) && (E2PStatus == HAL_OK); p++){
+			E2PStatus = BSP_EEPROM_Diag_Write(pReport, EEP_DIAG_WALKING, b, uwBase + p * pEeprom->PageSize);
+		}
+		if(E2PStatus == HAL_OK) E2PStatus = BSP_EEPROM_Diag_Verify(pReport, EEP_DIAG_WALKING, b, uwBase, uwLength);
+	}
+	pReport->Phase[EEP_DIAG_WALKING].Micros += BSP_GetMicros() - uwStart;
+
+	uwStart = BSP_GetMicros();
+	for(uint32_t p = 0; (p < uwPages) && (E2PStatus == HAL_OK); p++){
+		E2PStatus = BSP_EEPROM_Diag_Write(pReport, EEP_DIAG_ADDRESS, 0, uwBase + p * pEeprom->PageSize);
+	}
+	if(E2PStatus == HAL_OK) E2PStatus = BSP_EEPROM_Diag_Verify(pReport, EEP_DIAG_ADDRESS, 0, uwBase, uwLength);
+	pReport->Phase[EEP_DIAG_ADDRESS].Micros += BSP_GetMicros() - uwStart;
+
+	return E2PStatus;
+}
+
+/**
+  * @brief  runs all tests over a range and fills the report. The original content
+  *         is restored block by block, also when a test fails. A block disturbed
+  *         by writes to another one is rebuilt from the parity of the range.
+  * @param  uwAddress: first address, page aligned
+  * @param  uwLength: number of bytes, a multiple of the page size
+  * @param  pReport: filled with per phase throughput, errors and failing bits
+	* @retval HAL_ERROR on a bus failure, HAL_OK otherwise (see pReport->Errors)
+  */
+//=====================================================================================================
+HAL_StatusTypeDef BSP_EEPROM_Diag_Run(uint32_t uwAddress, uint32_t uwLength, EEP_DiagReportTypeDef* pReport)
+//=====================================================================================================
+{
+	HAL_StatusTypeDef E2PStatus = HAL_OK;
+	uint32_t uwBlock, uwLen, uwStart, uwVictim = DIAG_NO_VICTIM;
+
+	if(pReport == NULL || uwLength == 0 || pEeprom->PageSize > EEP_DIAG_PAGE_MAX) return HAL_ERROR;
+	if((uwAddress % pEeprom->PageSize) != 0 || (uwLength % pEeprom->PageSize) != 0) return HAL_ERROR;
+	if(uwAddress >= pEeprom->Capacity || uwLength > pEeprom->Capacity - uwAddress) return HAL_ERROR;
+	if(uwLength / pEeprom->PageSize > EEP_DIAG_MAX_PAGES) return HAL_ERROR;
+
+	uwBlock = (EEP_DIAG_BLOCK / pEeprom->PageSize) * pEeprom->PageSize;
+
+	memset(pReport, 0, sizeof(*pReport));
+	memset(ucDiagParity, 0, sizeof(ucDiagParity));
+	if(BSP_EEPROM_Diag_Parity(ucDiagParity, uwAddress, uwLength, uwBlock, DIAG_NO_VICTIM) != HAL_OK) return HAL_ERROR;
+
+	uwStart = BSP_GetMicros();
+	E2PStatus = BSP_EEPROM_Diag_Decoder(pReport, uwAddress, uwLength / pEeprom->PageSize);
+	if(E2PStatus == HAL_OK) E2PStatus = EEPROM_SPI_WaitReady();
+	pReport->Phase[EEP_DIAG_DECODER].Micros = BSP_GetMicros() - uwStart;
+
+	uwStart = BSP_GetMicros();
+	if(E2PStatus == HAL_OK) E2PStatus = BSP_EEPROM_Diag_Coupling(pReport, uwAddress, uwLength, uwBlock, &uwVictim);
+	pReport->Phase[EEP_DIAG_COUPLING].Micros = BSP_GetMicros() - uwStart;
+
+	for(uint32_t uwDone = 0; (uwDone < uwLength) && (E2PStatus == HAL_OK); uwDone += uwLen)
+	{
+		uwLen = (uwLength - uwDone < uwBlock) ? (uwLength - uwDone) : uwBlock;
+
+		E2PStatus = EEPROM_SPI_ReadBuffer(ucDiagSave, uwAddress + uwDone, uwLen);
+		if(E2PStatus != HAL_OK) break;
+
+		E2PStatus = BSP_EEPROM_Diag_Block(pReport, uwAddress + uwDone, uwLen);
+
+		if(EEPROM_SPI_WriteBuffer(ucDiagSave, uwAddress + uwDone, uwLen) != HAL_OK) E2PStatus = HAL_ERROR;
+	}
+
+	// all other blocks are back, their XOR with the parity is the victim as it was
+	if(E2PStatus == HAL_OK && uwVictim == DIAG_VICTIMS){
+		EEP_LOG("Diagnostics: several blocks disturbed, not rebuilt\r\n");
+	}
+	else if(E2PStatus == HAL_OK && uwVictim != DIAG_NO_VICTIM){
+		uwLen = (uwLength - uwVictim * uwBlock < uwBlock) ? (uwLength - uwVictim * uwBlock) : uwBlock;
+		memcpy(ucDiagSave, ucDiagParity, sizeof(ucDiagSave));
+		E2PStatus = BSP_EEPROM_Diag_Parity(ucDiagSave, uwAddress, uwLength, uwBlock, uwVictim);
+		if(E2PStatus == HAL_OK) E2PStatus = EEPROM_SPI_WriteBuffer(ucDiagSave, uwAddress + uwVictim * uwBlock, uwLen);
+		EEP_LOG("Diagnostics: block @0x%05lX rebuilt from parity\r\n", (unsigned long)(uwAddress + uwVictim * uwBlock));
+	}
+	if(EEPROM_SPI_WaitReady() != HAL_OK) E2PStatus = HAL_ERROR;
+
+	return E2PStatus;
+}
+
+/**
+  * @brief  logs the report: throughput per phase, failing addresses and bits
+  * @param  pReport: report filled by BSP_EEPROM_Diag_Run
+	* @retval none
+  */
+//================================================================
+void BSP_EEPROM_Diag_Print(const EEP_DiagReportTypeDef* pReport)
+//================================================================
+{
+	const EEP_DiagPhaseStatTypeDef* pPhase;
+
+	for(uint8_t i = 0; i < EEP_DIAG_PHASES; i++)
+	{
+		pPhase = &pReport->Phase[i];
+		EEP_LOG("%-12s %6lu B in %8lu us, %6lu B/s, %lu errors, mask 0x%02X\r\n", DiagPhaseName[i],
+						(unsigned long)pPhase->Bytes, (unsigned long)pPhase->Micros,
+						(unsigned long)((pPhase->Micros != 0) ? ((uint64_t)pPhase->Bytes * 1000000 / pPhase->Micros) : 0),
+						(unsigned long)pPhase->Errors, pPhase->Mask);
+	}
+
+	for(uint8_t i = 0; (i < pReport->Errors) && (i < EEP_DIAG_MAX_FAILS); i++){
+		EEP_LOG("  fail @0x%05lX bits 0x%02X (%s)\r\n", (unsigned long)pReport->Fail[i].Addr,
+						pReport->Fail[i].Mask, DiagPhaseName[pReport->Fail[i].Phase]);
+	}
+	EEP_LOG("Diagnostics: %lu errors\r\n\r\n", (unsigned long)pReport->Errors);
+}
@@ -0,0 +1,70 @@
+/**
+  ******************************************************************************
+  * @file    BSP_EEPROM_Diag.h
+  * @author  Hossein Bagherzade(@realhba)
+	* @email	 hossein.bagherzade@gmail.com
+  * @version V1.0.0
+  * @date    18-Oct-2026
+  * @brief   Header file for BSP_EEPROM_Diag.c
+  ******************************************************************************
+	**/
+
+
+#ifndef __BSP_EEPROM_DIAG_H
+#define __BSP_EEPROM_DIAG_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "BSP_EEPROM.h"
+
+
+#define EEP_DIAG_BLOCK									 (uint32_t)256 		// bytes saved, tested and restored at a time
+#define EEP_DIAG_MAX_PAGES							 EEP_DIAG_BLOCK 	// pages the decoder pass can tag, one saved byte each
+#define EEP_DIAG_PAGE_MAX								 (uint16_t)64 		// largest page size handled
+#define EEP_DIAG_MAX_FAILS							 (uint8_t)8 			// failing addresses kept in the report
+
+typedef enum
+{
+	EEP_DIAG_DECODER = 0,																				// one tag byte per page over the whole range
+	EEP_DIAG_COUPLING,																					// every pair of blocks, each one aggressor of the other
+	EEP_DIAG_MARCH,																							// March C- at page granularity
+	EEP_DIAG_WALKING,																						// walking ones, shifted per byte
+	EEP_DIAG_ADDRESS,																						// address in address
+	EEP_DIAG_PHASES
+} EEP_DiagPhaseTypeDef;
+
+typedef struct
+{
+	uint32_t Bytes;																							// bytes moved over the bus, read and written
+	uint32_t Micros;
+	uint32_t Errors;																						// bytes that read back wrong
+	uint8_t  Mask;																							// OR of all failing bit masks
+} EEP_DiagPhaseStatTypeDef;
+
+typedef struct
+{
+	uint32_t Addr;
+	uint8_t  Mask;																							// bits that read back wrong
+	uint8_t  Phase;
+} EEP_DiagFailTypeDef;
+
+typedef struct
+{
+	EEP_DiagPhaseStatTypeDef Phase[EEP_DIAG_PHASES];
+	EEP_DiagFailTypeDef Fail[EEP_DIAG_MAX_FAILS];								// first failures in test order
+	uint32_t Errors;
+} EEP_DiagReportTypeDef;
+
+
+HAL_StatusTypeDef BSP_EEPROM_Diag_Run(uint32_t uwAddress, uint32_t uwLength, EEP_DiagReportTypeDef* pReport);
+void BSP_EEPROM_Diag_Print(const EEP_DiagReportTypeDef* pReport);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __BSP_EEPROM_DIAG_H */
+
@@ -0,0 +1,236 @@
+/**
+  ******************************************************************************
+  * @file    BSP_EEPROM_Flash.c
+  * @author  Hossein Bagherzade(@realhba)
+	* @email	 hossein.bagherzade@gmail.com
+  * @version V1.0.0
+  * @date    18-Oct-2026
+  * @brief   EEPROM emulated in two internal flash pages, for boards without the
+  * AT25 part or as a fast tier for small hot values. Every changed byte is
+  * appended to the VALID page as an {address, data} record; a full page is
+  * compacted into the other one (page swap), so a page is erased only once
+  * per EEP_FLASH_RECORDS byte updates. Reads come from a RAM cache rebuilt
+  * at init by replaying the log.
+  ******************************************************************************
+	**/
+
+#include "BSP_EEPROM_Flash.h"
+#include "string.h"
+
+EEP_FlashTypeDef hEepFlash;
+
+#ifdef BSP_EEPROM_FLASH_VIRTUAL
+uint8_t ucEepFlashSim[2 * EEP_FLASH_PAGE_SIZE];
+#define EEP_FLASH_READ16(addr) 					 (*(uint16_t*)&ucEepFlashSim[(addr) - EEP_FLASH_PAGE0])
+#else
+#define EEP_FLASH_READ16(addr) 					 (*(__IO uint16_t*)(addr))
+#endif
+
+/**
+  * @brief  programs one halfword. As on the part, a halfword that is not erased
+  *         can only be cleared to 0x0000.
+  * @param  uwAddress: flash address, halfword aligned
+  * @param  uiData: value to program
+	* @retval HAL_StatusTypeDef enum, HAL_OK in case of successful operation
+  */
+//=================================================================================
+static HAL_StatusTypeDef BSP_EEPROM_Flash_Program(uint32_t uwAddress, uint16_t uiData)
+//=================================================================================
+{
+#ifdef BSP_EEPROM_FLASH_VIRTUAL
+	if(EEP_FLASH_READ16(uwAddress) != 0xFFFF && uiData != 0x0000) return HAL_ERROR;
+	EEP_FLASH_READ16(uwAddress) = uiData;
+	return HAL_OK;
+#else
+	HAL_StatusTypeDef E2PStatus;
+
+	HAL_FLASH_Unlock();
+	E2PStatus = HAL_FLASH_Program(FLASH_TYPEPROGRAM_HALFWORD, uwAddress, uiData);
+	HAL_FLASH_Lock();
+
+	return E2PStatus;
+#endif
+}
+
+/**
+  * @brief  erases one of the two pages
+  * @param  uwPage: page base address
+	* @retval HAL_StatusTypeDef enum, HAL_OK in case of successful operation
+  */
+//==============================================================
+static HAL_StatusTypeDef BSP_EEPROM_Flash_Erase(uint32_t uwPage)
+//==============================================================
+{
+#ifdef BSP_EEPROM_FLASH_VIRTUAL
+	memset(&ucEepFlashSim[uwPage - EEP_FLASH_PAGE0], 0xFF, EEP_FLASH_PAGE_SIZE);
+	return HAL_OK;
+#else
+	HAL_StatusTypeDef E2PStatus;
+	FLASH_EraseInitTypeDef erase = { .TypeErase = FLASH_TYPEERASE_PAGES, .PageAddress = uwPage, .NbPages = 1 };
+	uint32_t uwPageError;
+
+	HAL_FLASH_Unlock();
+	E2PStatus = HAL_FLASHEx_Erase(&erase, &uwPageError);
+	HAL_FLASH_Lock();
+
+	return E2PStatus;
+#endif
+}
+
+/**
+  * @brief  appends one record, data first so that a record cut by a reset has no
+  *         address and is skipped on replay
+  * @param  uwPage: page base address
+  * @param  uwOffset: record offset in the page
+  * @param  uiAddress: emulated byte address
+  * @param  ucData: byte value
+	* @retval HAL_StatusTypeDef enum, HAL_OK in case of successful operation
+  */
+//===================================================================================================================
+static HAL_StatusTypeDef BSP_EEPROM_Flash_Record(uint32_t uwPage, uint32_t uwOffset, uint16_t uiAddress, uint8_t ucData)
+//===================================================================================================================
+{
+	if(BSP_EEPROM_Flash_Program(uwPage + uwOffset + 2, ucData) != HAL_OK) return HAL_ERROR;
+
+	return BSP_EEPROM_Flash_Program(uwPage + uwOffset, uiAddress);
+}
+
+/**
+  * @brief  compacts the live bytes of the cache into the other page and makes it
+  *         the VALID one. The old page is erased before the new one is marked, so
+  *         after a reset a RECEIVING page next to an erased one is complete.
+	* @retval HAL_StatusTypeDef enum, HAL_OK in case of successful operation
+  */
+//==============================================
+static HAL_StatusTypeDef BSP_EEPROM_Flash_Swap(void)
+//==============================================
+{
+	uint32_t uwTarget = (hEepFlash.ActivePage == EEP_FLASH_PAGE0) ? EEP_FLASH_PAGE1 : EEP_FLASH_PAGE0;
+	uint32_t uwOffset = EEP_FLASH_RECORD_SIZE;
+
+	if(BSP_EEPROM_Flash_Erase(uwTarget) != HAL_OK) return HAL_ERROR;
+	if(BSP_EEPROM_Flash_Program(uwTarget, EEP_FLASH_PAGE_RECEIVING) != HAL_OK) return HAL_ERROR;
+
+	for(uint32_t a = 0; a < EEP_FLASH_CAPACITY; a++)
+	{
+		if(hEepFlash.Cache[a] == 0xFF) continue;
+		if(BSP_EEPROM_Flash_Record(uwTarget, uwOffset, (uint16_t)a, hEepFlash.Cache[a]) != HAL_OK) return HAL_ERROR;
+		uwOffset += EEP_FLASH_RECORD_SIZE;
+	}
+
+	if(BSP_EEPROM_Flash_Erase(hEepFlash.ActivePage) != HAL_OK) return HAL_ERROR;
+	if(BSP_EEPROM_Flash_Program(uwTarget, EEP_FLASH_PAGE_VALID) != HAL_OK) return HAL_ERROR;
+
+	hEepFlash.ActivePage = uwTarget;
+	hEepFlash.WriteOffset = uwOffset;
+	hEepFlash.Swaps++;
+	return HAL_OK;
+}
+
+/**
+  * @brief  finds the VALID page, finishes a swap cut by a reset and replays the
+  *         log into the cache. Blank or broken pages are formatted.
+	* @retval HAL_StatusTypeDef enum, HAL_OK in case of successful operation
+  */
+//==============================================
+HAL_StatusTypeDef BSP_EEPROM_Flash_Init(void)
+//==============================================
+{
+	uint16_t uiStatus0 = EEP_FLASH_READ16(EEP_FLASH_PAGE0);
+	uint16_t uiStatus1 = EEP_FLASH_READ16(EEP_FLASH_PAGE1);
+	uint32_t uwOther, uwRecord, uwUsed = 0;
+	uint16_t uiAddress, uiData;
+
+	memset(&hEepFlash, 0, sizeof(hEepFlash));
+	memset(hEepFlash.Cache, 0xFF, sizeof(hEepFlash.Cache));
+
+	if(uiStatus0 == EEP_FLASH_PAGE_VALID || uiStatus1 == EEP_FLASH_PAGE_VALID){
+		// a RECEIVING partner is an unfinished copy, the VALID page is still the source
+		hEepFlash.ActivePage = (uiStatus0 == EEP_FLASH_PAGE_VALID) ? EEP_FLASH_PAGE0 : EEP_FLASH_PAGE1;
+	}
+	else if(uiStatus0 == EEP_FLASH_PAGE_RECEIVING || uiStatus1 == EEP_FLASH_PAGE_RECEIVING){
+		// copy finished and the old page erased, only the VALID mark is missing
+		hEepFlash.ActivePage = (uiStatus0 == EEP_FLASH_PAGE_RECEIVING) ? EEP_FLASH_PAGE0 : EEP_FLASH_PAGE1;
+		if(BSP_EEPROM_Flash_Program(hEepFlash.ActivePage, EEP_FLASH_PAGE_VALID) != HAL_OK) return HAL_ERROR;
+	}
+	else{
+		EEP_LOG("Flash EEPROM: formatting\r\n");
+		hEepFlash.ActivePage = EEP_FLASH_PAGE0;
+		if(BSP_EEPROM_Flash_Erase(EEP_FLASH_PAGE0) != HAL_OK) return HAL_ERROR;
+		if(BSP_EEPROM_Flash_Program(EEP_FLASH_PAGE0, EEP_FLASH_PAGE_VALID) != HAL_OK) return HAL_ERROR;
+	}
+
+	uwOther = (hEepFlash.ActivePage == EEP_FLASH_PAGE0) ? EEP_FLASH_PAGE1 : EEP_FLASH_PAGE0;
+	if(EEP_FLASH_READ16(uwOther) != EEP_FLASH_PAGE_ERASED){
+		if(BSP_EEPROM_Flash_Erase(uwOther) != HAL_OK) return HAL_ERROR;
+	}
+
+	for(uint32_t i = 0; i < EEP_FLASH_RECORDS; i++)
+	{
+		uwRecord = hEepFlash.ActivePage + EEP_FLASH_RECORD_SIZE * (i + 1);
+		uiAddress = EEP_FLASH_READ16(uwRecord);
+		uiData = EEP_FLASH_READ16(uwRecord + 2);
+
+		if(uiAddress == 0xFFFF && uiData == 0xFFFF) continue;
+		uwUsed = i + 1;
+		if(uiAddress < EEP_FLASH_CAPACITY) hEepFlash.Cache[uiAddress] = (uint8_t)uiData;
+	}
+	hEepFlash.WriteOffset = EEP_FLASH_RECORD_SIZE * (uwUsed + 1);
+
+	return HAL_OK;
+}
+
+/**
+  * @brief  Writes multiple bytes, same semantics as BSP_EEPROM_Write. Bytes that
+  *         already hold the value cost nothing. BSP_EEPROM_Flash_Init must have run.
+  * @param  reg_address: emulated address starts from 0x00000000
+  * @param  data_buf: pointer to a user defined buffer for data to be copied
+  * @param  length: number of bytes to be written statring from reg_address
+	* @retval HAL_StatusTypeDef enum, HAL_OK in case of successful operation
+  */
+//===================================================================================================
+HAL_StatusTypeDef BSP_EEPROM_Flash_Write(uint32_t reg_address, uint8_t data_buf[], uint32_t length)
+//===================================================================================================
+{
+	HAL_StatusTypeDef E2PStatus = HAL_OK;
+
+	if(data_buf == NULL || length == 0 || reg_address >= EEP_FLASH_CAPACITY || length > EEP_FLASH_CAPACITY - reg_address) return HAL_ERROR;
+	if(hEepFlash.ActivePage == 0) return HAL_ERROR;
+
+	for(uint32_t i = 0; (i < length) && (E2PStatus == HAL_OK); i++)
+	{
+		if(hEepFlash.Cache[reg_address + i] == data_buf[i]) continue;
+		hEepFlash.Cache[reg_address + i] = data_buf[i];
+
+		// a swap copies the cache, the new value included
+		if(hEepFlash.WriteOffset + EEP_FLASH_RECORD_SIZE > EEP_FLASH_PAGE_SIZE){
+			E2PStatus = BSP_EEPROM_Flash_Swap();
+			continue;
+		}
+
+		E2PStatus = BSP_EEPROM_Flash_Record(hEepFlash.ActivePage, hEepFlash.WriteOffset, (uint16_t)(reg_address + i), data_buf[i]);
+		hEepFlash.WriteOffset += EEP_FLASH_RECORD_SIZE;
+		hEepFlash.Records++;
+	}
+
+	return E2PStatus;
+}
+
+/**
+  * @brief  Reads multiple bytes, same semantics as BSP_EEPROM_Read, served from
+  *         the cache without touching the flash
+  * @param  reg_address: emulated address starts from 0x00000000
+  * @param  data_buf: pointer to a user defined buffer for data to be copied
+  * @param  length: number of bytes to be restored statring from reg_address
+	* @retval HAL_StatusTypeDef enum, HAL_OK in case of successful operation
+  */
+//==================================================================================================
+HAL_StatusTypeDef BSP_EEPROM_Flash_Read(uint32_t reg_address, uint8_t data_buf[], uint32_t length)
+//==================================================================================================
+{
+	if(data_buf == NULL || length == 0 || reg_address >= EEP_FLASH_CAPACITY || length > EEP_FLASH_CAPACITY - reg_address) return HAL_ERROR;
+	if(hEepFlash.ActivePage == 0) return HAL_ERROR;
+
+	memcpy(data_buf, &hEepFlash.Cache[reg_address], length);
+	return HAL_OK;
+}
@@ -0,0 +1,71 @@
+/**
+  ******************************************************************************
+  * @file    BSP_EEPROM_Flash.h
+  * @author  Hossein Bagherzade(@realhba)
+	* @email	 hossein.bagherzade@gmail.com
+  * @version V1.0.0
+  * @date    18-Oct-2026
+  * @brief   Header file for BSP_EEPROM_Flash.c
+  ******************************************************************************
+	**/
+
+
+#ifndef __BSP_EEPROM_FLASH_H
+#define __BSP_EEPROM_FLASH_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "BSP_EEPROM.h"
+
+
+//#define BSP_EEPROM_FLASH_VIRTUAL 										// host builds: the two pages live in RAM, erase/program are simulated
+
+// The two pages at the top of the flash, kept out of the image by the IROM1
+// size of 0xF800 in the target options
+#define EEP_FLASH_PAGE_SIZE							 FLASH_PAGE_SIZE
+#define EEP_FLASH_PAGE0									 (uint32_t)(FLASH_BANK1_END + 1 - 2 * EEP_FLASH_PAGE_SIZE)
+#define EEP_FLASH_PAGE1									 (uint32_t)(FLASH_BANK1_END + 1 - 1 * EEP_FLASH_PAGE_SIZE)
+#define EEP_FLASH_CAPACITY							 (uint32_t)128 		// emulated bytes, at most the records of one page
+
+#define EEP_FLASH_PAGE_ERASED						 (uint16_t)0xFFFF // page status, first halfword of a page
+#define EEP_FLASH_PAGE_RECEIVING				 (uint16_t)0xEEEE // swap target while live bytes are copied in
+#define EEP_FLASH_PAGE_VALID						 (uint16_t)0x0000 // page holding the log
+#define EEP_FLASH_RECORD_SIZE						 (uint32_t)4 			// halfword address + halfword data
+#define EEP_FLASH_RECORDS								 ((EEP_FLASH_PAGE_SIZE - EEP_FLASH_RECORD_SIZE) / EEP_FLASH_RECORD_SIZE)
+
+// Bytes BSP_EEPROM_Read/Write serve, the bound for the layers on top of them
+#if (USE_FLASH_EEPROM == 1)
+#define EEP_BACKEND_CAPACITY						 EEP_FLASH_CAPACITY
+#else
+#define EEP_BACKEND_CAPACITY						 (pEeprom->Capacity)
+#endif
+
+typedef struct
+{
+	uint32_t ActivePage;																				// base of the VALID page
+	uint32_t WriteOffset;																				// next free record in it
+	uint8_t  Cache[EEP_FLASH_CAPACITY];													// latest value of every byte, 0xFF if never written
+	uint32_t Records;																						// statistics: records appended
+	uint32_t Swaps;																							// statistics: page swaps (one erase each)
+} EEP_FlashTypeDef;
+
+
+extern EEP_FlashTypeDef hEepFlash;
+
+HAL_StatusTypeDef BSP_EEPROM_Flash_Init(void);
+HAL_StatusTypeDef BSP_EEPROM_Flash_Write(uint32_t reg_address, uint8_t data_buf[], uint32_t length);
+HAL_StatusTypeDef BSP_EEPROM_Flash_Read(uint32_t reg_address, uint8_t data_buf[], uint32_t length);
+
+#ifdef BSP_EEPROM_FLASH_VIRTUAL
+extern uint8_t ucEepFlashSim[2 * EEP_FLASH_PAGE_SIZE];
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __BSP_EEPROM_FLASH_H */
+
@@ -0,0 +1,316 @@
+/**
+  ******************************************************************************
+  * @file    BSP_EEPROM_Gang.c
+  * @author  Hossein Bagherzade(@realhba)
+	* @email	 hossein.bagherzade@gmail.com
+  * @version V1.0.0
+  * @date    18-Oct-2026
+  * @brief   Lane parallel soft SPI for programming fixtures. The chips share SCK
+  * and CS, every chip (lane) has its own MOSI and MISO pin on the same port.
+  * Each clock edge is a single BSRR write that also sets the data bit of every
+  * lane and each bit is sampled from all lanes with a single IDR read, so N
+  * chips are written and verified in about the time of one. Lanes get their
+  * own data, e.g. serial numbers, and their own verify result. A lane whose
+  * chip never gets ready is dropped and the others carry on. With
+  * BSP_EEPROM_SIM the BSRR words and IDR samples go to the bus model instead,
+  * lane l drives SI and reads SO of chip l.
+  ******************************************************************************
+	**/
+
+#include "BSP_EEPROM_Gang.h"
+#include "string.h"
+
+#define EEP_GANG_DELAY(g)								 for(uint32_t i = 0 ; i < (g)->Device.ClkDelay ; i++) __NOP()
+
+#ifdef BSP_EEPROM_SIM
+
+/**
+  * @brief  host build: one BSRR word on the model, the data bits of every lane
+  *         first, then the shared SCK edge
+  * @param  pGang: gang handle
+  * @param  uwWord: BSRR value, set bits low, reset bits high
+	* @retval none
+  */
+//=======================================================================
+static void EEPROM_Gang_SimOut(EEP_GangTypeDef* pGang, uint32_t uwWord)
+//=======================================================================
+{
+	for(uint8_t l = 0; l < pGang->LaneCount; l++)
+	{
+		if(uwWord & ((uint32_t)pGang->Lane[l].MosiPin << 16)) EEPROM_Sim_SetChipPin(l, EEP_SIM_PIN_SI, 0);
+		if(uwWord & pGang->Lane[l].MosiPin) EEPROM_Sim_SetChipPin(l, EEP_SIM_PIN_SI, 1);
+	}
+	if(uwWord & ((uint32_t)pGang->SckPin << 16)) EEPROM_Sim_SetPin(EEP_SIM_PIN_CK, 0);
+	if(uwWord & pGang->SckPin) EEPROM_Sim_SetPin(EEP_SIM_PIN_CK, 1);
+}
+
+/**
+  * @brief  host build: IDR with the SO level of every lane on its MISO pin
+  * @param  pGang: gang handle
+	* @retval port input word
+  */
+//=========================================================
+static uint32_t EEPROM_Gang_SimIn(EEP_GangTypeDef* pGang)
+//=========================================================
+{
+	uint32_t uwIdr = 0;
+
+	for(uint8_t l = 0; l < pGang->LaneCount; l++){
+		if(EEPROM_Sim_GetChipSO(l)) uwIdr |= pGang->Lane[l].MisoPin;
+	}
+
+	return uwIdr;
+}
+
+#endif /* BSP_EEPROM_SIM */
+
+/**
+  * @brief  shifts one byte on every lane at once, SPI mode 0, SCK is left high
+  * @param  pGang: gang handle
+  * @param  pTx: byte to send per lane
+  * @param  pRx: byte received per lane
+	* @retval none
+  */
+//===========================================================================================
+static void EEPROM_Gang_ShiftByte(EEP_GangTypeDef* pGang, const uint8_t* pTx, uint8_t* pRx)
+//===========================================================================================
+{
+	uint32_t uwWord, uwIdr;
+	uint8_t l;
+
+	for(l = 0; l < pGang->LaneCount; l++) pRx[l] = 0;
+
+	for(uint8_t ucMask = 0x80; ucMask != 0; ucMask >>= 1)
+	{
+		uwWord = (uint32_t)pGang->SckPin << 16;
+		for(l = 0; l < pGang->LaneCount; l++){
+			uwWord |= (pTx[l] & ucMask) ? (uint32_t)pGang->Lane[l].MosiPin : (uint32_t)pGang->Lane[l].MosiPin << 16;
+		}
+
+		EEP_GANG_OUT(pGang, uwWord);
+		EEP_GANG_DELAY(pGang);
+		EEP_GANG_OUT(pGang, pGang->SckPin);
+		EEP_GANG_DELAY(pGang);
+
+		uwIdr = EEP_GANG_IN(pGang);
+		for(l = 0; l < pGang->LaneCount; l++){
+			if(uwIdr & pGang->Lane[l].MisoPin) pRx[l] |= ucMask;
+		}
+	}
+}
+
+/**
+  * @brief  shifts the same byte on every lane
+  * @param  pGang: gang handle
+  * @param  ucByte: byte to send
+  * @param  pRx: byte received per lane, may be NULL
+	* @retval none
+  */
+//=========================================================================================
+static void EEPROM_Gang_ShiftCommon(EEP_GangTypeDef* pGang, uint8_t ucByte, uint8_t* pRx)
+//=========================================================================================
+{
+	uint8_t tx[EEP_GANG_MAX_LANES], rx[EEP_GANG_MAX_LANES];
+
+	memset(tx, ucByte, sizeof(tx));
+	EEPROM_Gang_ShiftByte(pGang, tx, (pRx != NULL) ? pRx : rx);
+}
+
+/**
+  * @brief  instruction and address phase, the same on every lane
+  * @param  pGang: gang handle
+  * @param  ucCmd: CMD_READ or CMD_WRITE
+  * @param  uwAddr: memory address
+	* @retval none
+  */
+//======================================================================================
+static void EEPROM_Gang_Header(EEP_GangTypeDef* pGang, uint8_t ucCmd, uint32_t uwAddr)
+//======================================================================================
+{
+	// single address byte parts carry A8 in bit 3 of the opcode
+	if(pGang->Device.AddrBytes == 1) ucCmd |= (uint8_t)((uwAddr >> 5) & 0x08);
+
+	EEPROM_Gang_ShiftCommon(pGang, ucCmd, NULL);
+	for(int8_t i = (int8_t)pGang->Device.AddrBytes - 1; i >= 0; i--){
+		EEPROM_Gang_ShiftCommon(pGang, (uint8_t)(uwAddr >> (8 * i)), NULL);
+	}
+}
+
+/**
+  * @brief  polls RDSR on all lanes together until no live lane is busy, lanes
+  *         still busy after WRITE_TIMEOUT_US are dropped into FailMask
+  * @param  pGang: gang handle
+	* @retval HAL_StatusTypeDef enum, HAL_OK if a lane is left
+  */
+//======================================================================
+static HAL_StatusTypeDef EEPROM_Gang_WaitReady(EEP_GangTypeDef* pGang)
+//======================================================================
+{
+	BSP_DeadlineTypeDef deadline = BSP_Deadline_After(WRITE_TIMEOUT_US);
+	uint8_t rx[EEP_GANG_MAX_LANES];
+	uint8_t ucBusy;
+
+	for(;;)
+	{
+		EEP_GANG_CS_LOW(pGang);
+		EEPROM_Gang_ShiftCommon(pGang, CMD_RDSR, NULL);
+		EEPROM_Gang_ShiftCommon(pGang, 0xFF, rx);
+		EEP_GANG_CS_HIGH(pGang);
+
+		ucBusy = 0;
+		for(uint8_t l = 0; l < pGang->LaneCount; l++){
+			if(bitRead(rx[l], BIT_WIP)) ucBusy |= (uint8_t)(1U << l);
+		}
+		ucBusy &= (uint8_t)~pGang->FailMask;
+		if(ucBusy == 0) break;
+
+		if(BSP_Deadline_Expired(deadline)){
+			EEP_LOG("EEPROM gang: lanes 0x%02X never got ready, dropped\r\n", ucBusy);
+			pGang->FailMask |= ucBusy;
+			break;
+		}
+		BSP_DelayUs(EEP_TWC_POLL_STEP_US, BLOCKING);
+	}
+
+	return (pGang->FailMask == (uint8_t)((1U << pGang->LaneCount) - 1)) ? HAL_ERROR : HAL_OK;
+}
+
+/**
+  * @brief  configures the shared SCK/CS and the lane pins and clears the results,
+  *         MISO has a pull-up so a missing chip reads busy and is dropped
+  * @param  pGang: gang handle with Device, Port, SckPin, LaneCount and lane pins set
+	* @retval HAL_StatusTypeDef enum, HAL_OK in case of successful operation
+  */
+//==============================================================
+HAL_StatusTypeDef BSP_EEPROM_Gang_Init(EEP_GangTypeDef* pGang)
+//==============================================================
+{
+	uint16_t uiMosi = 0, uiMiso = 0;
+
+	if(pGang->LaneCount == 0 || pGang->LaneCount > EEP_GANG_MAX_LANES) return HAL_ERROR;
+
+	for(uint8_t l = 0; l < pGang->LaneCount; l++)
+	{
+		uiMosi |= pGang->Lane[l].MosiPin;
+		uiMiso |= pGang->Lane[l].MisoPin;
+		pGang->Lane[l].FailAddr = EEP_GANG_NO_FAIL;
+		pGang->Lane[l].Errors = 0;
+	}
+	pGang->FailMask = 0;
+
+	EEP_GANG_CS_HIGH(pGang);
+	EEP_GANG_OUT(pGang, pGang->SckPin);
+
+#ifndef BSP_EEPROM_SIM
+	GPIO_InitTypeDef GPIO_InitStruct;
+
+	GPIO_InitStruct.Pin = pGang->Device.CsPin;
+	GPIO_InitStruct.Mode = GPIO_MODE_OUTPUT_PP;
+	GPIO_InitStruct.Pull = GPIO_NOPULL;
+	GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_LOW;
+	HAL_GPIO_Init(pGang->Device.CsPort, &GPIO_InitStruct);
+
+	GPIO_InitStruct.Pin = pGang->SckPin | uiMosi;
+	GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_HIGH;
+	HAL_GPIO_Init(pGang->Port, &GPIO_InitStruct);
+
+	GPIO_InitStruct.Pin = uiMiso;
+	GPIO_InitStruct.Mode = GPIO_MODE_INPUT;
+	GPIO_InitStruct.Pull = GPIO_PULLUP;
+	HAL_GPIO_Init(pGang->Port, &GPIO_InitStruct);
+#else
+	(void)uiMosi;
+	(void)uiMiso;
+#endif
+
+	return HAL_OK;
+}
+
+/**
+  * @brief  writes a buffer per lane to the same address range of every chip, one
+  *         page at a time on all lanes together. The last write cycle is left
+  *         running, BSP_EEPROM_Gang_Verify waits for it
+  * @param  pGang: gang handle
+  * @param  uwAddress: first address
+  * @param  pData: data per lane, the same pointer on every lane for a common image
+  * @param  uwLength: bytes per lane
+	* @retval HAL_StatusTypeDef enum, HAL_OK if no lane failed
+  */
+//==============================================================================================================================
+HAL_StatusTypeDef BSP_EEPROM_Gang_Write(EEP_GangTypeDef* pGang, uint32_t uwAddress, const uint8_t* pData[], uint32_t uwLength)
+//==============================================================================================================================
+{
+	EEP_ChunkPlanTypeDef plan;
+	uint8_t tx[EEP_GANG_MAX_LANES], rx[EEP_GANG_MAX_LANES];
+
+	if(uwLength == 0 || uwAddress >= pGang->Device.Capacity || uwLength > pGang->Device.Capacity - uwAddress) return HAL_ERROR;
+
+	EEPROM_SPI_PlanInit(&plan, uwAddress, uwLength, pGang->Device.PageSize);
+	while(EEPROM_SPI_PlanNext(&plan))
+	{
+		if(EEPROM_Gang_WaitReady(pGang) != HAL_OK) return HAL_ERROR;
+
+		EEP_GANG_CS_LOW(pGang);
+		EEPROM_Gang_ShiftCommon(pGang, CMD_WREN, NULL);
+		EEP_GANG_CS_HIGH(pGang);
+
+		EEP_SEQ_DELAY(20);
+
+		EEP_GANG_CS_LOW(pGang);
+		EEPROM_Gang_Header(pGang, CMD_WRITE, plan.Addr);
+		for(uint32_t i = 0; i < plan.Len; i++)
+		{
+			for(uint8_t l = 0; l < pGang->LaneCount; l++) tx[l] = pData[l][plan.Offset + i];
+			EEPROM_Gang_ShiftByte(pGang, tx, rx);
+		}
+		EEP_GANG_CS_HIGH(pGang);
+
+		EEP_SEQ_DELAY(20);
+	}
+
+	return (pGang->FailMask == 0) ? HAL_OK : HAL_ERROR;
+}
+
+/**
+  * @brief  reads the range back from all lanes with one READ and compares every
+  *         lane with its data, mismatching lanes get FailAddr/Errors and a bit
+  *         in FailMask
+  * @param  pGang: gang handle
+  * @param  uwAddress: first address
+  * @param  pData: expected data per lane
+  * @param  uwLength: bytes per lane
+	* @retval HAL_StatusTypeDef enum, HAL_OK if every lane matched
+  */
+//===============================================================================================================================
+HAL_StatusTypeDef BSP_EEPROM_Gang_Verify(EEP_GangTypeDef* pGang, uint32_t uwAddress, const uint8_t* pData[], uint32_t uwLength)
+//===============================================================================================================================
+{
+	uint8_t rx[EEP_GANG_MAX_LANES];
+	EEP_GangLaneTypeDef* pLane;
+
+	if(uwLength == 0 || uwAddress >= pGang->Device.Capacity || uwLength > pGang->Device.Capacity - uwAddress) return HAL_ERROR;
+
+	if(EEPROM_Gang_WaitReady(pGang) != HAL_OK) return HAL_ERROR;
+
+	EEP_GANG_CS_LOW(pGang);
+	EEPROM_Gang_Header(pGang, CMD_READ, uwAddress);
+	for(uint32_t i = 0; i < uwLength; i++)
+	{
+		EEPROM_Gang_ShiftCommon(pGang, 0xFF, rx);
+
+		for(uint8_t l = 0; l < pGang->LaneCount; l++)
+		{
+			if(rx[l] == pData[l][i]) continue;
+
+			pLane = &pGang->Lane[l];
+			if(pLane->FailAddr == EEP_GANG_NO_FAIL) pLane->FailAddr = uwAddress + i;
+			pLane->Errors++;
+			pGang->FailMask |= (uint8_t)(1U << l);
+		}
+	}
+	EEP_GANG_CS_HIGH(pGang);
+
+	EEP_SEQ_DELAY(20);
+
+	return (pGang->FailMask == 0) ? HAL_OK : HAL_ERROR;
+}
@@ -0,0 +1,67 @@
+/**
+  ******************************************************************************
+  * @file    BSP_EEPROM_Gang.h
+  * @author  Hossein Bagherzade(@realhba)
+	* @email	 hossein.bagherzade@gmail.com
+  * @version V1.0.0
+  * @date    18-Oct-2026
+  * @brief   Header file for BSP_EEPROM_Gang.c
+  ******************************************************************************
+	**/
+
+
+#ifndef __BSP_EEPROM_GANG_H
+#define __BSP_EEPROM_GANG_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "BSP_EEPROM.h"
+
+
+#define EEP_GANG_MAX_LANES							 (uint8_t)8 			// chips programmed at once
+#define EEP_GANG_NO_FAIL								 (uint32_t)0xFFFFFFFF
+
+#ifdef BSP_EEPROM_SIM
+#define EEP_GANG_CS_LOW(g)							 EEPROM_Sim_SetCs((g)->Device.CsPin, 0)
+#define EEP_GANG_CS_HIGH(g)							 EEPROM_Sim_SetCs((g)->Device.CsPin, 1)
+#define EEP_GANG_OUT(g, w)							 EEPROM_Gang_SimOut((g), (w))
+#define EEP_GANG_IN(g)								 EEPROM_Gang_SimIn(g)
+#else
+#define EEP_GANG_CS_LOW(g)							 HAL_GPIO_WritePin((g)->Device.CsPort, (g)->Device.CsPin, GPIO_PIN_RESET)
+#define EEP_GANG_CS_HIGH(g)							 HAL_GPIO_WritePin((g)->Device.CsPort, (g)->Device.CsPin, GPIO_PIN_SET)
+#define EEP_GANG_OUT(g, w)							 ((g)->Port->BSRR = (w))
+#define EEP_GANG_IN(g)								 ((g)->Port->IDR)
+#endif
+
+typedef struct
+{
+	uint16_t MosiPin;																						// data to this chip
+	uint16_t MisoPin;																						// data from this chip
+	uint32_t FailAddr;																					// first address that failed to verify, EEP_GANG_NO_FAIL if none
+	uint32_t Errors;																						// bytes that failed to verify
+} EEP_GangLaneTypeDef;
+
+typedef struct
+{
+	EEP_DeviceTypeDef Device;																		// part type of every lane, CsPort/CsPin is the shared chip select
+	GPIO_TypeDef* Port;																					// port of SCK and of every lane pin
+	uint16_t SckPin;
+	uint8_t  LaneCount;
+	EEP_GangLaneTypeDef Lane[EEP_GANG_MAX_LANES];
+	uint8_t  FailMask;																					// lanes that timed out or failed to verify
+} EEP_GangTypeDef;
+
+
+HAL_StatusTypeDef BSP_EEPROM_Gang_Init(EEP_GangTypeDef* pGang);
+HAL_StatusTypeDef BSP_EEPROM_Gang_Write(EEP_GangTypeDef* pGang, uint32_t uwAddress, const uint8_t* pData[], uint32_t uwLength);
+HAL_StatusTypeDef BSP_EEPROM_Gang_Verify(EEP_GangTypeDef* pGang, uint32_t uwAddress, const uint8_t* pData[], uint32_t uwLength);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __BSP_EEPROM_GANG_H */
+
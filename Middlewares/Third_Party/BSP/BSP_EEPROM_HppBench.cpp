@@ -0,0 +1,268 @@
+/**
+  ******************************************************************************
+  * @file    BSP_EEPROM_HppBench.cpp
+  * @author  Hossein Bagherzade(@realhba)
+	* @email	 hossein.bagherzade@gmail.com
+  * @version V1.0.0
+  * @date    18-Oct-2026
+  * @brief   Host benchmark of BSP_EEPROM.hpp against the C driver. Both paths
+  * run the same fixed access, a page crossing write and its read back, on the
+  * AT25 model of BSP_EEPROM_Sim.c with the same bit-banged bus, and the
+  * benchmark reports the cycles per access and the bytes of driver code each
+  * path links in. The code size is read from the symbol table of the binary
+  * itself, so it has to be linked with section garbage collection and not be
+  * stripped, e.g. from the repository root:
+  *
+  *   gcc -std=gnu99 -Os -ffunction-sections -DUSE_HAL_DRIVER -DSTM32F030x8
+  *       -DBSP_TIMEBASE_VIRTUAL -DBSP_EEPROM_SIM -IInc
+  *       -IMiddlewares/Third_Party/BSP -IDrivers/STM32F0xx_HAL_Driver/Inc
+  *       -IDrivers/CMSIS/Include -IDrivers/CMSIS/Device/ST/STM32F0xx/Include
+  *       -c Middlewares/Third_Party/BSP/BSP_Timebase.c
+  *          Middlewares/Third_Party/BSP/BSP_EEPROM.c
+  *          Middlewares/Third_Party/BSP/BSP_EEPROM_Sim.c
+  *   g++ -std=c++17 -Os -ffunction-sections -DBSP_EEPROM_HPPBENCH (same
+  *       defines and includes) -c Middlewares/Third_Party/BSP/BSP_EEPROM_HppBench.cpp
+  *   g++ -Wl,--gc-sections *.o -o eeprom_hppbench
+  *
+  * The figures are host ones: they compare the two paths built by the same
+  * compiler, not the Cortex-M0 numbers.
+  ******************************************************************************
+	**/
+
+#include "BSP_EEPROM.hpp"
+#include "BSP_EEPROM_Sim.h"
+
+#if defined(BSP_EEPROM_SIM) && defined(BSP_EEPROM_HPPBENCH)
+
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include <elf.h>
+#include <link.h>
+#include <chrono>
+
+#define HPPBENCH_ADDR 									 (uint32_t)20 			// starts mid page
+#define HPPBENCH_LEN 										 (uint32_t)40 			// and crosses into the next one
+#define HPPBENCH_ROUNDS 								 (uint32_t)2000
+
+/**
+  * @brief  bit-banged SPI mode 0 on the model pins, the bus of EEPROM_SoftSPI_*
+  *         in a BSP_EEPROM_SIM build
+  */
+template <uint16_t CsPin>
+struct SimBus
+{
+	static void Select()   { EEPROM_Sim_SetCs(CsPin, 0); }
+	static void Deselect() { EEPROM_Sim_SetCs(CsPin, 1); }
+
+	static HAL_StatusTypeDef Send(const uint8_t* pData, uint32_t uwLen)
+	{
+		while(uwLen--)
+		{
+			uint8_t ucByte = *pData++;
+			for(uint8_t clk = 0; clk < 8; clk++)
+			{
+				EEPROM_Sim_SetPin(EEP_SIM_PIN_SI, (ucByte & 0x80) ? 1 : 0);
+				EEPROM_Sim_SetPin(EEP_SIM_PIN_CK, 0);
+				EEPROM_Sim_SetPin(EEP_SIM_PIN_CK, 1);
+				ucByte <<= 1;
+			}
+		}
+		return HAL_OK;
+	}
+
+	static HAL_StatusTypeDef Recv(uint8_t* pData, uint32_t uwLen)
+	{
+		while(uwLen--)
+		{
+			uint8_t ucIn = 0;
+			for(uint8_t clk = 0; clk < 8; clk++)
+			{
+				EEPROM_Sim_SetPin(EEP_SIM_PIN_CK, 0);
+				EEPROM_Sim_SetPin(EEP_SIM_PIN_CK, 1);
+				ucIn = static_cast<uint8_t>((ucIn << 1) | (EEPROM_Sim_GetSO() ? 1 : 0));
+			}
+			*pData++ = ucIn;
+		}
+		return HAL_OK;
+	}
+};
+
+using BenchEeprom = bsp::Eeprom<bsp::AT25160, SimBus<EEP_CS_Pin>>;
+
+/**
+  * @brief  time stamp in cycles, the time stamp counter where there is one
+  */
+static uint64_t HppBench_Cycles(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+	return __builtin_ia32_rdtsc();
+#else
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+/**
+  * @brief  the access through the C driver, kept out of line so its code is
+  *         counted on its own
+  */
+extern "C" __attribute__((noinline)) HAL_StatusTypeDef HppBench_CPath(uint8_t* pOut, uint8_t* pIn)
+{
+	HAL_StatusTypeDef E2PStatus = BSP_EEPROM_Write(HPPBENCH_ADDR, pOut, HPPBENCH_LEN);
+	if(E2PStatus == HAL_OK) E2PStatus = BSP_EEPROM_Read(HPPBENCH_ADDR, pIn, HPPBENCH_LEN);
+	return E2PStatus;
+}
+
+/**
+  * @brief  the same access through the compile time driver
+  */
+extern "C" __attribute__((noinline)) HAL_StatusTypeDef HppBench_CppPath(const uint8_t* pOut, uint8_t* pIn)
+{
+	HAL_StatusTypeDef E2PStatus = BenchEeprom::Write<HPPBENCH_ADDR, HPPBENCH_LEN>(pOut);
+	if(E2PStatus == HAL_OK) E2PStatus = BenchEeprom::Read<HPPBENCH_ADDR, HPPBENCH_LEN>(pIn);
+	return E2PStatus;
+}
+
+/**
+  * @brief  bytes of code of the functions left in the binary for each path:
+  *         the C driver functions and HppBench_CPath, the Eeprom<> and SimBus
+  *         instances and HppBench_CppPath. The model and the time base serve
+  *         both and are not counted
+  * @param  pC: code of the C path
+  * @param  pCpp: code of the C++ path
+	* @retval HAL_StatusTypeDef enum, HAL_ERROR without a symbol table
+  */
+static HAL_StatusTypeDef HppBench_CodeSize(uint32_t* pC, uint32_t* pCpp)
+{
+	std::vector<uint8_t> image;
+	FILE* pFile = fopen("/proc/self/exe", "rb");
+	const ElfW(Ehdr)* pEhdr;
+	const ElfW(Shdr)* pShdr;
+
+	*pC = *pCpp = 0;
+	if(pFile == NULL) return HAL_ERROR;
+
+	for(int c = fgetc(pFile); c != EOF; c = fgetc(pFile)) image.push_back(static_cast<uint8_t>(c));
+	fclose(pFile);
+	if(image.size() < sizeof(ElfW(Ehdr))) return HAL_ERROR;
+
+	pEhdr = reinterpret_cast<const ElfW(Ehdr)*>(image.data());
+	pShdr = reinterpret_cast<const ElfW(Shdr)*>(image.data() + pEhdr->e_shoff);
+
+	for(uint32_t s = 0; s < pEhdr->e_shnum; s++)
+	{
+		if(pShdr[s].sh_type != SHT_SYMTAB) continue;
+
+		const ElfW(Sym)* pSym = reinterpret_cast<const ElfW(Sym)*>(image.data() + pShdr[s].sh_offset);
+		const char* pNames = reinterpret_cast<const char*>(image.data() + pShdr[pShdr[s].sh_link].sh_offset);
+		uint32_t uwCount = static_cast<uint32_t>(pShdr[s].sh_size / sizeof(ElfW(Sym)));
+
+		for(uint32_t i = 0; i < uwCount; i++)
+		{
+			const char* pName = pNames + pSym[i].st_name;
+			if(ELF64_ST_TYPE(pSym[i].st_info) != STT_FUNC || pSym[i].st_shndx == SHN_UNDEF) continue;
+
+			if(strncmp(pName, "EEPROM_Sim", 10) == 0) continue;
+			if(strncmp(pName, "EEPROM_", 7) == 0 || strncmp(pName, "BSP_EEPROM_", 11) == 0 || strcmp(pName, "HppBench_CPath") == 0){
+				*pC += static_cast<uint32_t>(pSym[i].st_size);
+			}
+			else if(strstr(pName, "6Eeprom") != NULL || strstr(pName, "6SimBus") != NULL || strcmp(pName, "HppBench_CppPath") == 0){
+				*pCpp += static_cast<uint32_t>(pSym[i].st_size);
+			}
+		}
+		return HAL_OK;
+	}
+	return HAL_ERROR;
+}
+
+/**
+  * @brief  runs HPPBENCH_ROUNDS accesses on each path, every one checked, and
+  *         compares cycles and code size
+	* @retval HAL_StatusTypeDef enum, HAL_OK when both paths are right and the
+  *         C++ one is both smaller and faster
+  */
+//==============================================
+static HAL_StatusTypeDef HppBench_Run(void)
+//==============================================
+{
+	HAL_StatusTypeDef E2PStatus = HAL_OK;
+	uint8_t ucOut[HPPBENCH_LEN], ucIn[HPPBENCH_LEN];
+	uint64_t ulCycles[2] = { 0, 0 };
+	uint32_t uwWrites[2], uwBusUs[2], uwCode[2];
+
+	for(uint8_t ucPath = 0; (ucPath < 2) && (E2PStatus == HAL_OK); ucPath++)
+	{
+		uwWrites[ucPath] = hEepSim[0].Writes;
+		uwBusUs[ucPath] = BSP_GetMicros();
+
+		for(uint32_t r = 0; (r < HPPBENCH_ROUNDS) && (E2PStatus == HAL_OK); r++)
+		{
+			for(uint32_t i = 0; i < HPPBENCH_LEN; i++) ucOut[i] = static_cast<uint8_t>(r * 13 + i * 3 + ucPath);
+			memset(ucIn, 0, sizeof(ucIn));
+
+			uint64_t ulStart = HppBench_Cycles();
+			E2PStatus = (ucPath == 0) ? HppBench_CPath(ucOut, ucIn) : HppBench_CppPath(ucOut, ucIn);
+			ulCycles[ucPath] += HppBench_Cycles() - ulStart;
+
+			if((E2PStatus == HAL_OK) && (memcmp(ucOut, ucIn, HPPBENCH_LEN) != 0)) E2PStatus = HAL_ERROR;
+		}
+
+		uwWrites[ucPath] = hEepSim[0].Writes - uwWrites[ucPath];
+		uwBusUs[ucPath] = BSP_GetMicros() - uwBusUs[ucPath];
+	}
+
+	if(E2PStatus == HAL_OK) E2PStatus = HppBench_CodeSize(&uwCode[0], &uwCode[1]);
+	if(E2PStatus != HAL_OK){
+		EEP_LOG("EEPROM hpp benchmark Failed\r\n");
+		return E2PStatus;
+	}
+
+	EEP_LOG("EEPROM %lu bytes at %lu, write and read back, %lu rounds :\r\n\r\n",
+					(unsigned long)HPPBENCH_LEN, (unsigned long)HPPBENCH_ADDR, (unsigned long)HPPBENCH_ROUNDS);
+	for(uint8_t ucPath = 0; ucPath < 2; ucPath++)
+	{
+		EEP_LOG("%s: %5lu bytes of code, %7lu cycles per access, %lu page writes, %lu us on the bus\r\n",
+						(ucPath == 0) ? "C driver  " : "C++ driver", (unsigned long)uwCode[ucPath],
+						(unsigned long)(ulCycles[ucPath] / HPPBENCH_ROUNDS), (unsigned long)uwWrites[ucPath], (unsigned long)uwBusUs[ucPath]);
+	}
+
+	if((uwWrites[0] != uwWrites[1]) || (uwCode[1] >= uwCode[0]) || (ulCycles[1] >= ulCycles[0])) E2PStatus = HAL_ERROR;
+	EEP_LOG("\r\n%s\r\n", (E2PStatus == HAL_OK) ? "Passed" : "Failed");
+
+	return E2PStatus;
+}
+
+/**
+  * @brief  EEP_LOG goes to stdout on the host
+  * @param  format: printf format
+	* @retval number of characters written
+  */
+//==============================================
+extern "C" int aPrintOutLog(const char* format, ...)
+//==============================================
+{
+	va_list args;
+	int iLen;
+
+	va_start(args, format);
+	iLen = vprintf(format, args);
+	va_end(args);
+
+	return iLen;
+}
+
+//==============================================
+int main(void)
+//==============================================
+{
+	pEeprom = &hEeprom;
+
+	EEPROM_SPI_Init();
+	EEPROM_SPI_SetClock(0);
+	EEPROM_Sim_Init(pEeprom->Capacity, pEeprom->PageSize, pEeprom->AddrBytes);
+
+	return (HppBench_Run() == HAL_OK) ? 0 : 1;
+}
+
+#endif /* BSP_EEPROM_SIM && BSP_EEPROM_HPPBENCH */
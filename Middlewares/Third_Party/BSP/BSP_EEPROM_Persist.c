@@ -0,0 +1,223 @@
+/**
+  ******************************************************************************
+  * @file    BSP_EEPROM_Persist.c
+  * @author  Hossein Bagherzade(@realhba)
+	* @email	 hossein.bagherzade@gmail.com
+  * @version V1.0.0
+  * @date    18-Oct-2026
+  * @brief   Persistent variables kept in RAM and backed by the EEPROM.
+  * All variables are loaded at boot with one continuous READ. An assignment
+  * through EEP_PERSIST_SET only marks its page dirty, and dirty pages are
+  * programmed later, once per page however often the variables changed.
+  ******************************************************************************
+	**/
+
+#include "BSP_EEPROM_Persist.h"
+#include "BSP_EEPROM_Flash.h"
+#include "string.h"
+
+EEP_PersistTypeDef hEepPersist;
+
+/**
+  * @brief  assigns the auto slots, sorts the variables by address and loads them
+  *         all from the eeprom in a single sequential read
+  * @param  pVars: variable descriptors, they must live as long as the application
+  * @param  uiCount: number of descriptors
+	* @retval HAL_StatusTypeDef enum, HAL_OK in case of successful operation
+  */
+//=========================================================================================
+HAL_StatusTypeDef BSP_EEPROM_Persist_Init(EEP_PersistVarTypeDef* pVars, uint16_t uiCount)
+//=========================================================================================
+{
+	HAL_StatusTypeDef E2PStatus = HAL_OK;
+	EEP_PersistVarTypeDef tmp;
+	uint32_t uwNext = EEP_PERSIST_BASE, uwEnd;
+	uint16_t uiPage = pEeprom->PageSize;
+
+	memset(&hEepPersist, 0, sizeof(hEepPersist));
+	if(pVars == NULL || uiCount == 0 || uiPage > EEP_PERSIST_PAGE_MAX) return HAL_ERROR;
+
+	// auto slots go above every fixed variable
+	for(uint16_t i = 0; i < uiCount; i++){
+		if(pVars[i].pVar == NULL || pVars[i].Size == 0) return HAL_ERROR;
+		if(pVars[i].Addr != EEP_PERSIST_AUTO && pVars[i].Addr + pVars[i].Size > uwNext) uwNext = pVars[i].Addr + pVars[i].Size;
+	}
+
+	// a slot does not straddle a page when it fits in one, so it costs one program
+	for(uint16_t i = 0; i < uiCount; i++){
+		if(pVars[i].Addr != EEP_PERSIST_AUTO) continue;
+		if((pVars[i].Size <= uiPage) && ((uwNext % uiPage) + pVars[i].Size > uiPage)) uwNext += uiPage - (uwNext % uiPage);
+		pVars[i].Addr = uwNext;
+		uwNext += pVars[i].Size;
+	}
+
+	for(uint16_t i = 1; i < uiCount; i++){
+		tmp = pVars[i];
+		uint16_t j = i;
+		for(; (j > 0) && (pVars[j - 1].Addr > tmp.Addr); j--) pVars[j] = pVars[j - 1];
+		pVars[j] = tmp;
+	}
+
+	for(uint16_t i = 1; i < uiCount; i++){
+		if(pVars[i - 1].Addr + pVars[i - 1].Size > pVars[i].Addr) return HAL_ERROR;
+	}
+	uwEnd = pVars[uiCount - 1].Addr + pVars[uiCount - 1].Size;
+	if(uwEnd > EEP_BACKEND_CAPACITY) return HAL_ERROR;
+
+	hEepPersist.FirstPage = pVars[0].Addr / uiPage;
+	if((uwEnd - 1) / uiPage - hEepPersist.FirstPage >= EEP_PERSIST_MAX_PAGES) return HAL_ERROR;
+	hEepPersist.PageCount = (uint8_t)((uwEnd - 1) / uiPage - hEepPersist.FirstPage + 1);
+
+#if (USE_FLASH_EEPROM == 1)
+	for(uint16_t i = 0; (i < uiCount) && (E2PStatus == HAL_OK); i++){
+		E2PStatus = BSP_EEPROM_Flash_Read(pVars[i].Addr, (uint8_t*)pVars[i].pVar, pVars[i].Size);
+	}
+#else
+	uint32_t uwCursor, uwSkip;
+	uint8_t ucScratch[16];
+
+	// one READ over the whole area, gaps between the variables are clocked into scratch
+	uwCursor = pVars[0].Addr;
+	E2PStatus = EEPROM_SPI_ReadStart(uwCursor);
+	for(uint16_t i = 0; (i < uiCount) && (E2PStatus == HAL_OK); i++)
+	{
+		while((uwCursor < pVars[i].Addr) && (E2PStatus == HAL_OK)){
+			uwSkip = pVars[i].Addr - uwCursor;
+			if(uwSkip > sizeof(ucScratch)) uwSkip = sizeof(ucScratch);
+			E2PStatus = EEPROM_SPI_ReadNext(ucScratch, uwSkip);
+			uwCursor += uwSkip;
+		}
+		if(E2PStatus == HAL_OK) E2PStatus = EEPROM_SPI_ReadNext((uint8_t*)pVars[i].pVar, pVars[i].Size);
+		uwCursor += pVars[i].Size;
+	}
+	EEPROM_SPI_ReadStop();
+#endif
+
+	if(E2PStatus == HAL_OK){
+		hEepPersist.pVars = pVars;
+		hEepPersist.Count = uiCount;
+	}
+	return E2PStatus;
+}
+
+/**
+  * @brief  marks the pages of a changed variable dirty, no bus access
+  * @param  pVar: address of the RAM variable, as registered with EEP_PERSIST_VAR
+	* @retval none
+  */
+//==============================================
+void BSP_EEPROM_Persist_Touch(const void* pVar)
+//==============================================
+{
+	EEP_PersistVarTypeDef* pDesc;
+	uint32_t uwFirst, uwLast;
+
+	for(uint16_t i = 0; i < hEepPersist.Count; i++)
+	{
+		pDesc = &hEepPersist.pVars[i];
+		if((const uint8_t*)pVar < (const uint8_t*)pDesc->pVar || (const uint8_t*)pVar >= (const uint8_t*)pDesc->pVar + pDesc->Size) continue;
+
+		if(hEepPersist.DirtyMask == 0) hEepPersist.DirtySinceMs = BSP_GetTick();
+
+		uwFirst = pDesc->Addr / pEeprom->PageSize - hEepPersist.FirstPage;
+		uwLast = (pDesc->Addr + pDesc->Size - 1) / pEeprom->PageSize - hEepPersist.FirstPage;
+		for(uint32_t p = uwFirst; p <= uwLast; p++) hEepPersist.DirtyMask |= (1UL << p);
+		return;
+	}
+}
+
+/**
+  * @brief  programs one dirty page: the variables in it are merged into the
+  *         current page content and only the changed span is written
+  * @param  ucIndex: page index relative to hEepPersist.FirstPage
+	* @retval HAL_StatusTypeDef enum, HAL_OK in case of successful operation
+  */
+//================================================================
+static HAL_StatusTypeDef BSP_EEPROM_Persist_FlushPage(uint8_t ucIndex)
+//================================================================
+{
+	EEP_PersistVarTypeDef* pDesc;
+	uint8_t ucPage[EEP_PERSIST_PAGE_MAX];
+	uint16_t uiPage = pEeprom->PageSize;
+	uint32_t uwBase = (hEepPersist.FirstPage + ucIndex) * uiPage;
+	uint32_t uwFrom, uwTo, uwLo = uiPage, uwHi = 0;
+
+#if (USE_FLASH_EEPROM == 1)
+	if(BSP_EEPROM_Flash_Read(uwBase, ucPage, uiPage) != HAL_OK) return HAL_ERROR;
+#else
+	if(EEPROM_SPI_ReadBuffer(ucPage, uwBase, uiPage) != HAL_OK) return HAL_ERROR;
+#endif
+
+	for(uint16_t i = 0; i < hEepPersist.Count; i++)
+	{
+		pDesc = &hEepPersist.pVars[i];
+		if(pDesc->Addr >= uwBase + uiPage) break;
+		if(pDesc->Addr + pDesc->Size <= uwBase) continue;
+
+		uwFrom = (pDesc->Addr > uwBase) ? pDesc->Addr : uwBase;
+		uwTo = (pDesc->Addr + pDesc->Size < uwBase + uiPage) ? (pDesc->Addr + pDesc->Size) : (uwBase + uiPage);
+
+		for(uint32_t a = uwFrom; a < uwTo; a++){
+			uint8_t ucByte = ((uint8_t*)pDesc->pVar)[a - pDesc->Addr];
+			if(ucPage[a - uwBase] == ucByte) continue;
+			ucPage[a - uwBase] = ucByte;
+			if(a - uwBase < uwLo) uwLo = a - uwBase;
+			if(a - uwBase + 1 > uwHi) uwHi = a - uwBase + 1;
+		}
+	}
+
+	// set back to the stored value in the meantime, nothing to program
+	if(uwHi == 0) return HAL_OK;
+
+	hEepPersist.PagePrograms++;
+#if (USE_FLASH_EEPROM == 1)
+	return BSP_EEPROM_Flash_Write(uwBase + uwLo, &ucPage[uwLo], uwHi - uwLo);
+#else
+	return EEPROM_SPI_WritePage(&ucPage[uwLo], uwBase + uwLo, uwHi - uwLo);
+#endif
+}
+
+/**
+  * @brief  lazy flush, call it periodically (main loop or a low priority task).
+  *         It programs the dirty pages once EEP_PERSIST_DIRTY_THRESHOLD pages
+  *         are dirty or the oldest change is EEP_PERSIST_FLUSH_MS old.
+	* @retval HAL_StatusTypeDef enum, HAL_OK in case of successful operation
+  */
+//==============================================
+HAL_StatusTypeDef BSP_EEPROM_Persist_Poll(void)
+//==============================================
+{
+	uint8_t ucDirty = 0;
+
+	if(hEepPersist.DirtyMask == 0) return HAL_OK;
+
+	for(uint32_t m = hEepPersist.DirtyMask; m != 0; m &= m - 1) ucDirty++;
+
+	if((ucDirty >= EEP_PERSIST_DIRTY_THRESHOLD) || (BSP_GetTick() - hEepPersist.DirtySinceMs >= EEP_PERSIST_FLUSH_MS)){
+		return BSP_EEPROM_Persist_Sync();
+	}
+	return HAL_OK;
+}
+
+/**
+  * @brief  programs every dirty page now, e.g. before a reset or power down
+	* @retval HAL_StatusTypeDef enum, HAL_OK in case of successful operation
+  */
+//==============================================
+HAL_StatusTypeDef BSP_EEPROM_Persist_Sync(void)
+//==============================================
+{
+	HAL_StatusTypeDef E2PStatus = HAL_OK;
+
+	for(uint8_t p = 0; (p < hEepPersist.PageCount) && (E2PStatus == HAL_OK); p++)
+	{
+		if((hEepPersist.DirtyMask & (1UL << p)) == 0) continue;
+
+		hEepPersist.DirtyMask &= ~(1UL << p);
+		E2PStatus = BSP_EEPROM_Persist_FlushPage(p);
+		if(E2PStatus != HAL_OK) hEepPersist.DirtyMask |= (1UL << p);
+	}
+
+	if(hEepPersist.DirtyMask != 0) hEepPersist.DirtySinceMs = BSP_GetTick();
+	return E2PStatus;
+}
@@ -0,0 +1,70 @@
+/**
+  ******************************************************************************
+  * @file    BSP_EEPROM_Persist.h
+  * @author  Hossein Bagherzade(@realhba)
+	* @email	 hossein.bagherzade@gmail.com
+  * @version V1.0.0
+  * @date    18-Oct-2026
+  * @brief   Header file for BSP_EEPROM_Persist.c
+  ******************************************************************************
+	**/
+
+
+#ifndef __BSP_EEPROM_PERSIST_H
+#define __BSP_EEPROM_PERSIST_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "BSP_EEPROM.h"
+
+
+#define EEP_PERSIST_BASE								 (uint32_t)0x0000 	// auto slots are assigned from here up
+#define EEP_PERSIST_AUTO								 (uint32_t)0xFFFFFFFF // address of a variable that gets the next free slot
+#define EEP_PERSIST_MAX_PAGES						 (uint8_t)32 			// pages the dirty mask can track
+#define EEP_PERSIST_PAGE_MAX						 (uint16_t)64 		// largest page size handled
+#define EEP_PERSIST_DIRTY_THRESHOLD			 (uint8_t)4 			// dirty pages that trigger a flush
+#define EEP_PERSIST_FLUSH_MS						 (uint32_t)2000 	// oldest dirty page is flushed after this
+
+// Descriptor of one persistent variable, e.g.
+//   static uint32_t uwBootCount;
+//   static EEP_PersistVarTypeDef vars[] = { EEP_PERSIST_VAR(uwBootCount, EEP_PERSIST_AUTO) };
+#define EEP_PERSIST_VAR(var, addr) 			 { (void*)&(var), (uint16_t)sizeof(var), (addr) }
+
+// Assignment that only marks the containing page dirty, reads stay plain RAM accesses
+#define EEP_PERSIST_SET(var, value) 		 do { (var) = (value); BSP_EEPROM_Persist_Touch(&(var)); } while(0)
+
+typedef struct
+{
+	void*    pVar;																							// RAM copy, the application uses it directly
+	uint16_t Size;
+	uint32_t Addr;																							// eeprom address or EEP_PERSIST_AUTO
+} EEP_PersistVarTypeDef;
+
+typedef struct
+{
+	EEP_PersistVarTypeDef* pVars;																// sorted by address after init
+	uint16_t Count;
+	uint32_t FirstPage;																					// first page the variables use
+	uint8_t  PageCount;
+	uint32_t DirtyMask;																					// bit n: page FirstPage + n needs a program
+	uint32_t DirtySinceMs;																			// tick of the oldest unflushed change
+	uint32_t PagePrograms;																			// statistics: pages programmed by flushes
+} EEP_PersistTypeDef;
+
+
+extern EEP_PersistTypeDef hEepPersist;
+
+HAL_StatusTypeDef BSP_EEPROM_Persist_Init(EEP_PersistVarTypeDef* pVars, uint16_t uiCount);
+void BSP_EEPROM_Persist_Touch(const void* pVar);
+HAL_StatusTypeDef BSP_EEPROM_Persist_Poll(void);
+HAL_StatusTypeDef BSP_EEPROM_Persist_Sync(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __BSP_EEPROM_PERSIST_H */
+
@@ -0,0 +1,289 @@
+/**
+  ******************************************************************************
+  * @file    BSP_EEPROM_Rtos.c
+  * @author  Hossein Bagherzade(@realhba)
+	* @email	 hossein.bagherzade@gmail.com
+  * @version V1.0.0
+  * @date    18-Oct-2026
+  * @brief   CMSIS-RTOS integration of the EEPROM driver. A single worker thread
+  * owns the SPI bus and the EEPROM handles; other threads only queue requests,
+  * so no lock is ever held across a write cycle. While the worker waits for a
+  * write cycle it blocks in osDelay, shorter waits yield the CPU to the other
+  * threads.
+  ******************************************************************************
+	**/
+
+#include "BSP_EEPROM_Rtos.h"
+#include "string.h"
+
+#ifdef BSP_EEPROM_USE_RTOS
+
+static void BSP_EEPROM_Rtos_Worker(void const* argument);
+
+osThreadDef(BSP_EEPROM_Rtos_Worker, EEP_RTOS_PRIORITY, 1, EEP_RTOS_STACK_SIZE);
+// the macro leaves implementation fields of the definition (pool) to their zero default
+#if defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmissing-field-initializers"
+#endif
+osMessageQDef(EepRequestQ, EEP_RTOS_QUEUE_SIZE, EEP_RequestTypeDef*);
+#if defined(__GNUC__)
+#pragma GCC diagnostic pop
+#endif
+
+static osThreadId EepWorkerId = NULL;
+static osMessageQId EepRequestQId = NULL;
+static uint8_t ucEepMergeBuf[EEP_RTOS_MERGE_SIZE];
+
+/**
+  * @brief  creates the request queue and the storage worker thread, call it
+  *         once after the EEPROM is inited and before the kernel hands it out
+	* @retval HAL_StatusTypeDef enum, HAL_OK in case of successful operation
+  */
+//==============================================
+HAL_StatusTypeDef BSP_EEPROM_Rtos_Init(void)
+//==============================================
+{
+	// sleeping on WFI would stall the other threads, polling waits go through osDelay
+	pEeprom->WaitMode = EEP_WAIT_POLL;
+
+	EepRequestQId = osMessageCreate(osMessageQ(EepRequestQ), NULL);
+	if(EepRequestQId == NULL) return HAL_ERROR;
+
+	EepWorkerId = osThreadCreate(osThread(BSP_EEPROM_Rtos_Worker), NULL);
+	if(EepWorkerId == NULL) return HAL_ERROR;
+
+	return HAL_OK;
+}
+
+/**
+  * @brief  queues a request for the worker, it returns at once. Completion is
+  *         reported through pReq->Status and Done / Callback / Waiter if set.
+  * @param  pReq: request, owned by the caller until it completes
+	* @retval HAL_OK if queued, HAL_BUSY if the queue is full, HAL_ERROR otherwise
+  */
+//===================================================================
+HAL_StatusTypeDef BSP_EEPROM_Rtos_Submit(EEP_RequestTypeDef* pReq)
+//===================================================================
+{
+	if(pReq == NULL || EepRequestQId == NULL) return HAL_ERROR;
+
+	pReq->Status = HAL_BUSY;
+	if(osMessagePut(EepRequestQId, (uint32_t)(uintptr_t)pReq, 0) != osOK){
+		pReq->Status = HAL_ERROR;
+		return HAL_BUSY;
+	}
+
+	return HAL_OK;
+}
+
+/**
+  * @brief  queues a request and blocks the calling thread until it is done
+  * @param  pReq: request on the caller's stack
+	* @retval HAL_StatusTypeDef enum, HAL_OK in case of successful operation
+  */
+//==========================================================================
+static HAL_StatusTypeDef BSP_EEPROM_Rtos_Transfer(EEP_RequestTypeDef* pReq)
+//==========================================================================
+{
+	pReq->Done = NULL;
+	pReq->Callback = NULL;
+	pReq->Waiter = osThreadGetId();
+
+	// the worker itself must not wait for its own queue
+	if(pReq->Waiter == EepWorkerId) return HAL_ERROR;
+
+	osSignalClear(pReq->Waiter, EEP_RTOS_SIGNAL_DONE);
+	while(BSP_EEPROM_Rtos_Submit(pReq) == HAL_BUSY) osDelay(1);
+	if(pReq->Status == HAL_ERROR) return HAL_ERROR;
+
+	while(pReq->Status == HAL_BUSY) osSignalWait(EEP_RTOS_SIGNAL_DONE, osWaitForever);
+
+	return pReq->Status;
+}
+
+/**
+  * @brief  thread safe BSP_EEPROM_Write, blocks only the calling thread
+  * @param  reg_address: eeprom register address starts from 0x00000000
+  * @param  data_buf: pointer to a user defined buffer for data to be copied
+  * @param  length: number of bytes to be written statring from reg_address
+	* @retval HAL_StatusTypeDef enum, HAL_OK in case of successful operation
+  */
+//===================================================================================================
+HAL_StatusTypeDef BSP_EEPROM_Rtos_Write(uint32_t reg_address, uint8_t data_buf[], uint32_t length)
+//===================================================================================================
+{
+	EEP_RequestTypeDef req = { .Type = EEP_REQ_WRITE, .Address = reg_address, .pBuffer = data_buf, .Length = length };
+
+	return BSP_EEPROM_Rtos_Transfer(&req);
+}
+
+/**
+  * @brief  thread safe BSP_EEPROM_Read, blocks only the calling thread
+  * @param  reg_address: eeprom register address starts from 0x00000000
+  * @param  data_buf: pointer to a user defined buffer for data to be copied
+  * @param  length: number of bytes to be restored statring from reg_address
+	* @retval HAL_StatusTypeDef enum, HAL_OK in case of successful operation
+  */
+//==================================================================================================
+HAL_StatusTypeDef BSP_EEPROM_Rtos_Read(uint32_t reg_address, uint8_t data_buf[], uint32_t length)
+//==================================================================================================
+{
+	EEP_RequestTypeDef req = { .Type = EEP_REQ_READ, .Address = reg_address, .pBuffer = data_buf, .Length = length };
+
+	return BSP_EEPROM_Rtos_Transfer(&req);
+}
+
+/**
+  * @brief  reports the completion of one request
+  * @param  pReq: request taken from the queue
+  * @param  E2PStatus: result of the bus operation
+	* @retval none
+  */
+//===========================================================================================
+static void BSP_EEPROM_Rtos_Complete(EEP_RequestTypeDef* pReq, HAL_StatusTypeDef E2PStatus)
+//===========================================================================================
+{
+	// a blocked caller may drop its request as soon as Status changes, keep what we still need
+	osThreadId waiter = pReq->Waiter;
+	osSemaphoreId done = pReq->Done;
+	void (*callback)(EEP_RequestTypeDef* pReq) = pReq->Callback;
+
+	pReq->Status = E2PStatus;
+	if(callback != NULL) callback(pReq);
+	if(done != NULL) osSemaphoreRelease(done);
+	if(waiter != NULL) osSignalSet(waiter, EEP_RTOS_SIGNAL_DONE);
+}
+
+/**
+  * @brief  counts the writes from batch[first] on that continue each other's
+  *         address range and fit in the merge buffer together
+  * @param  batch: requests taken from the queue
+  * @param  first: index of the first write
+  * @param  n: number of requests in the batch
+	* @retval number of requests to merge, at least 1
+  */
+//=================================================================================================
+static uint32_t BSP_EEPROM_Rtos_MergeRun(EEP_RequestTypeDef* batch[], uint32_t first, uint32_t n)
+//=================================================================================================
+{
+	uint32_t count = 1;
+	uint32_t total = batch[first]->Length;
+
+	while((first + count) < n)
+	{
+		EEP_RequestTypeDef* prev = batch[first + count - 1];
+		EEP_RequestTypeDef* next = batch[first + count];
+
+		if(next->Type != EEP_REQ_WRITE) break;
+		if(next->Address != (prev->Address + prev->Length)) break;
+		if((total + next->Length) > EEP_RTOS_MERGE_SIZE) break;
+
+		total += next->Length;
+		count++;
+	}
+
+	return count;
+}
+
+/**
+  * @brief  runs a batch on the bus. Adjacent writes are merged into a single
+  *         BSP_EEPROM_Write, so records that were queued one after the other
+  *         share their page programs instead of paying a write cycle each.
+  *         Reads and unrelated writes run one by one, in queue order.
+  * @param  batch: requests taken from the queue
+  * @param  n: number of requests in the batch
+	* @retval none
+  */
+//============================================================================
+static void BSP_EEPROM_Rtos_Execute(EEP_RequestTypeDef* batch[], uint32_t n)
+//============================================================================
+{
+	HAL_StatusTypeDef E2PStatus;
+	uint32_t i = 0;
+
+	while(i < n)
+	{
+		EEP_RequestTypeDef* pReq = batch[i];
+
+		if(pReq->Type != EEP_REQ_WRITE){
+			BSP_EEPROM_Rtos_Complete(pReq, BSP_EEPROM_Read(pReq->Address, pReq->pBuffer, pReq->Length));
+			i++;
+			continue;
+		}
+
+		uint32_t count = BSP_EEPROM_Rtos_MergeRun(batch, i, n);
+
+		if(count == 1){
+			E2PStatus = BSP_EEPROM_Write(pReq->Address, pReq->pBuffer, pReq->Length);
+		}
+		else{
+			uint32_t total = 0;
+
+			for(uint32_t k = i; k < (i + count); k++){
+				memcpy(&ucEepMergeBuf[total], batch[k]->pBuffer, batch[k]->Length);
+				total += batch[k]->Length;
+			}
+			E2PStatus = BSP_EEPROM_Write(pReq->Address, ucEepMergeBuf, total);
+		}
+
+		for(uint32_t k = i; k < (i + count); k++) BSP_EEPROM_Rtos_Complete(batch[k], E2PStatus);
+		i += count;
+	}
+}
+
+/**
+  * @brief  storage worker, the only thread that touches the SPI bus. Requests
+  *         that queue up while a write cycle runs are taken as one batch, and
+  *         adjacent writes of the batch go to the chip as one write.
+  * @param  argument: unused
+	* @retval none
+  */
+//==========================================================
+static void BSP_EEPROM_Rtos_Worker(void const* argument)
+//==========================================================
+{
+	EEP_RequestTypeDef* batch[EEP_RTOS_BATCH_SIZE];
+	uint32_t n;
+	osEvent evt;
+
+	(void)argument;
+
+	for(;;)
+	{
+		evt = osMessageGet(EepRequestQId, osWaitForever);
+		if(evt.status != osEventMessage) continue;
+
+		n = 0;
+		batch[n++] = (EEP_RequestTypeDef*)evt.value.p;
+
+		while(n < EEP_RTOS_BATCH_SIZE)
+		{
+			evt = osMessageGet(EepRequestQId, 0);
+			if(evt.status != osEventMessage) break;
+			batch[n++] = (EEP_RequestTypeDef*)evt.value.p;
+		}
+
+		BSP_EEPROM_Rtos_Execute(batch, n);
+	}
+}
+
+/**
+  * @brief  waits of the worker give the CPU away: a wait of a tick or more
+  *         (the write cycle) blocks in osDelay, a shorter one (a WIP poll
+  *         step) only yields. Waits of any other caller (before the kernel
+  *         runs) keep spinning.
+  * @param  uwRemainingUs: time left of the wait, 0 for an event wait
+	* @retval none
+  */
+//==================================================
+void BSP_Timebase_IdleHook(uint32_t uwRemainingUs)
+//==================================================
+{
+	if((EepWorkerId == NULL) || (osThreadGetId() != EepWorkerId)) return;
+
+	if(uwRemainingUs >= EEP_RTOS_TICK_US) osDelay(uwRemainingUs / EEP_RTOS_TICK_US);
+	else osThreadYield();
+}
+
+#endif /* BSP_EEPROM_USE_RTOS */
@@ -0,0 +1,70 @@
+/**
+  ******************************************************************************
+  * @file    BSP_EEPROM_Rtos.h
+  * @author  Hossein Bagherzade(@realhba)
+	* @email	 hossein.bagherzade@gmail.com
+  * @version V1.0.0
+  * @date    18-Oct-2026
+  * @brief   Header file for BSP_EEPROM_Rtos.c
+  ******************************************************************************
+	**/
+
+
+#ifndef __BSP_EEPROM_RTOS_H
+#define __BSP_EEPROM_RTOS_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "BSP_EEPROM.h"
+
+
+//#define BSP_EEPROM_USE_RTOS 											// CMSIS-RTOS builds: the bus is owned by a storage worker thread
+
+#ifdef BSP_EEPROM_USE_RTOS
+#include "cmsis_os.h"
+
+#define EEP_RTOS_QUEUE_SIZE							 (uint32_t)8 			// requests that can be pending
+#define EEP_RTOS_BATCH_SIZE							 (uint32_t)8 			// requests taken from the queue per wakeup
+#define EEP_RTOS_MERGE_SIZE							 (uint32_t)64 			// bytes of adjacent writes merged into one write
+#define EEP_RTOS_TICK_US								 (uint32_t)1000 	// kernel tick, shorter waits yield instead of osDelay
+#define EEP_RTOS_STACK_SIZE							 (uint32_t)256
+#define EEP_RTOS_PRIORITY								 osPriorityBelowNormal
+#define EEP_RTOS_SIGNAL_DONE						 (int32_t)0x01 		// thread signal used by the blocking calls
+
+typedef enum
+{
+	EEP_REQ_READ = 0,
+	EEP_REQ_WRITE
+} EEP_RequestTypeTypeDef;
+
+typedef struct EEP_Request
+{
+	EEP_RequestTypeTypeDef Type;
+	uint32_t Address;																						// BSP_EEPROM_Read/Write address
+	uint8_t* pBuffer;																						// must stay valid until completion
+	uint32_t Length;
+	volatile HAL_StatusTypeDef Status;													// HAL_BUSY while queued or running; with Callback
+																															// or Done set, wait for those before reusing
+	osSemaphoreId Done;																					// released on completion, may be NULL
+	void (*Callback)(struct EEP_Request* pReq);									// run by the worker on completion, may be NULL
+	void* pContext;																							// free for the owner of the request
+	osThreadId Waiter;																					// signalled on completion, may be NULL
+} EEP_RequestTypeDef;
+
+
+HAL_StatusTypeDef BSP_EEPROM_Rtos_Init(void);
+HAL_StatusTypeDef BSP_EEPROM_Rtos_Submit(EEP_RequestTypeDef* pReq);
+HAL_StatusTypeDef BSP_EEPROM_Rtos_Write(uint32_t reg_address, uint8_t data_buf[], uint32_t length);
+HAL_StatusTypeDef BSP_EEPROM_Rtos_Read(uint32_t reg_address, uint8_t data_buf[], uint32_t length);
+
+#endif /* BSP_EEPROM_USE_RTOS */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __BSP_EEPROM_RTOS_H */
+
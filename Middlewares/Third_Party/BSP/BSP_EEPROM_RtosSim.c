@@ -0,0 +1,494 @@
+/**
+  ******************************************************************************
+  * @file    BSP_EEPROM_RtosSim.c
+  * @author  Hossein Bagherzade(@realhba)
+	* @email	 hossein.bagherzade@gmail.com
+  * @version V1.0.0
+  * @date    18-Oct-2026
+  * @brief   POSIX threads stand-in for the CMSIS-RTOS calls of
+  * BSP_EEPROM_Rtos.c, so the storage worker and its clients run as real
+  * threads on the host next to the AT25 model. Only what the worker and the
+  * host checks use is there: threads with signals, message queues,
+  * semaphores and osDelay. Message values are 32 bit as on the target and
+  * carry request pointers, so created threads get their stacks below 4 GB and
+  * the host build is linked -no-pie: requests must live on those stacks or in
+  * static memory, never on the stack of main.
+  ******************************************************************************
+	**/
+
+#define _GNU_SOURCE 																					// MAP_32BIT
+#include "BSP_EEPROM_Rtos.h"
+
+#if defined(BSP_EEPROM_SIM) && defined(BSP_EEPROM_USE_RTOS)
+#include "pthread.h"
+#include "sched.h"
+#include "sys/mman.h"
+#include "time.h"
+#include "errno.h"
+
+#define RTOS_SIM_MAX_THREADS						 (uint32_t)8
+#define RTOS_SIM_MAX_QUEUES							 (uint32_t)4
+#define RTOS_SIM_MAX_SEMAPHORES					 (uint32_t)8
+#define RTOS_SIM_QUEUE_MAX							 (uint32_t)32 		// deepest message queue
+#define RTOS_SIM_STACK_SIZE							 (size_t)(1024 * 1024) // host stack, whatever the thread definition asks; sanitizers need the room
+
+struct os_thread_cb
+{
+	pthread_t Thread;
+	os_pthread Entry;
+	void* pArgument;
+	int32_t Signals;
+	pthread_cond_t Cond;																				// Signals changed
+};
+
+struct os_messageQ_cb
+{
+	uint32_t Size, Head, Count;
+	uint32_t Buf[RTOS_SIM_QUEUE_MAX];
+	pthread_cond_t Cond;																				// Count changed
+};
+
+struct os_semaphore_cb
+{
+	int32_t Count;
+	pthread_cond_t Cond;
+};
+
+// one lock for the whole kernel keeps the stand-in simple, nothing blocks while holding it
+static pthread_mutex_t xRtosSimLock = PTHREAD_MUTEX_INITIALIZER;
+static struct os_thread_cb xRtosSimThread[RTOS_SIM_MAX_THREADS];
+static struct os_messageQ_cb xRtosSimQueue[RTOS_SIM_MAX_QUEUES];
+static struct os_semaphore_cb xRtosSimSem[RTOS_SIM_MAX_SEMAPHORES];
+static uint32_t uwRtosSimThreads, uwRtosSimQueues, uwRtosSimSems;
+
+/**
+  * @brief  absolute pthread deadline millisec from now
+  * @param  pTs: deadline
+  * @param  millisec: timeout
+	* @retval none
+  */
+//=====================================================================
+static void RtosSim_Deadline(struct timespec* pTs, uint32_t millisec)
+//=====================================================================
+{
+	clock_gettime(CLOCK_REALTIME, pTs);
+	pTs->tv_sec += millisec / 1000;
+	pTs->tv_nsec += (long)(millisec % 1000) * 1000000L;
+	if(pTs->tv_nsec >= 1000000000L){
+		pTs->tv_sec++;
+		pTs->tv_nsec -= 1000000000L;
+	}
+}
+
+/**
+  * @brief  waits on a condition of the kernel lock, held by the caller
+  * @param  pCond: condition
+  * @param  pTs: deadline, NULL for osWaitForever
+	* @retval 0 if signalled, ETIMEDOUT once the deadline passed
+  */
+//==========================================================================
+static int RtosSim_Wait(pthread_cond_t* pCond, const struct timespec* pTs)
+//==========================================================================
+{
+	if(pTs == NULL) return pthread_cond_wait(pCond, &xRtosSimLock);
+
+	return pthread_cond_timedwait(pCond, &xRtosSimLock, pTs);
+}
+
+/**
+  * @brief  control block of a thread, the first call from a thread the stand-in
+  *         did not create (main) registers it. Kernel lock held by the caller
+	* @retval thread id, NULL if the table is full
+  */
+//==============================================
+static osThreadId RtosSim_Self(void)
+//==============================================
+{
+	pthread_t self = pthread_self();
+
+	for(uint32_t i = 0; i < uwRtosSimThreads; i++){
+		if(pthread_equal(xRtosSimThread[i].Thread, self)) return &xRtosSimThread[i];
+	}
+	if(uwRtosSimThreads >= RTOS_SIM_MAX_THREADS) return NULL;
+
+	xRtosSimThread[uwRtosSimThreads].Thread = self;
+	pthread_cond_init(&xRtosSimThread[uwRtosSimThreads].Cond, NULL);
+	return &xRtosSimThread[uwRtosSimThreads++];
+}
+
+/**
+  * @brief  pthread entry, runs the CMSIS thread function
+  * @param  pArg: control block
+	* @retval NULL
+  */
+//==============================================
+static void* RtosSim_Start(void* pArg)
+//==============================================
+{
+	osThreadId id = (osThreadId)pArg;
+
+	id->Entry(id->pArgument);
+	return NULL;
+}
+
+/**
+  * @brief  starts a thread on a stack below 4 GB, priority and stack size are ignored
+  * @param  thread_def: thread definition
+  * @param  argument: passed to the thread function
+	* @retval thread id, NULL on failure
+  */
+//==========================================================================
+osThreadId osThreadCreate(const osThreadDef_t* thread_def, void* argument)
+//==========================================================================
+{
+	pthread_attr_t attr;
+	osThreadId id = NULL;
+	void* pStack;
+
+	// requests live on the stacks of their callers and travel as 32 bit values
+	pStack = mmap(NULL, RTOS_SIM_STACK_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_32BIT, -1, 0);
+	if(pStack == MAP_FAILED) return NULL;
+
+	pthread_mutex_lock(&xRtosSimLock);
+	if(uwRtosSimThreads < RTOS_SIM_MAX_THREADS)
+	{
+		id = &xRtosSimThread[uwRtosSimThreads++];
+		id->Entry = thread_def->pthread;
+		id->pArgument = argument;
+		id->Signals = 0;
+		pthread_cond_init(&id->Cond, NULL);
+
+		pthread_attr_init(&attr);
+		pthread_attr_setstack(&attr, pStack, RTOS_SIM_STACK_SIZE);
+		pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+		if(pthread_create(&id->Thread, &attr, RtosSim_Start, id) != 0){
+			uwRtosSimThreads--;
+			id = NULL;
+		}
+		pthread_attr_destroy(&attr);
+	}
+	pthread_mutex_unlock(&xRtosSimLock);
+
+	return id;
+}
+
+/**
+  * @brief  id of the calling thread
+	* @retval thread id
+  */
+//==============================================
+osThreadId osThreadGetId(void)
+//==============================================
+{
+	osThreadId id;
+
+	pthread_mutex_lock(&xRtosSimLock);
+	id = RtosSim_Self();
+	pthread_mutex_unlock(&xRtosSimLock);
+
+	return id;
+}
+
+/**
+  * @brief  passes the CPU to the other ready threads
+	* @retval osOK
+  */
+//==============================================
+osStatus osThreadYield(void)
+//==============================================
+{
+	sched_yield();
+
+	return osOK;
+}
+
+/**
+  * @brief  gives the CPU to the other threads. Driver time is virtual on the
+  *         host and only moves with the bus, so sleeping would just stretch
+  *         every write cycle the worker waits out here
+  * @param  millisec: delay, not waited
+	* @retval osEventTimeout
+  */
+//==============================================
+osStatus osDelay(uint32_t millisec)
+//==============================================
+{
+	(void)millisec;
+	sched_yield();
+
+	return osEventTimeout;
+}
+
+/**
+  * @brief  sets signal flags of a thread and wakes it
+  * @param  thread_id: thread
+  * @param  signals: flags to set
+	* @retval previous flags, 0x80000000 on a bad id
+  */
+//==========================================================
+int32_t osSignalSet(osThreadId thread_id, int32_t signals)
+//==========================================================
+{
+	int32_t iPrev;
+
+	if(thread_id == NULL) return (int32_t)0x80000000;
+
+	pthread_mutex_lock(&xRtosSimLock);
+	iPrev = thread_id->Signals;
+	thread_id->Signals |= signals;
+	pthread_cond_broadcast(&thread_id->Cond);
+	pthread_mutex_unlock(&xRtosSimLock);
+
+	return iPrev;
+}
+
+/**
+  * @brief  clears signal flags of a thread
+  * @param  thread_id: thread
+  * @param  signals: flags to clear
+	* @retval previous flags, 0x80000000 on a bad id
+  */
+//============================================================
+int32_t osSignalClear(osThreadId thread_id, int32_t signals)
+//============================================================
+{
+	int32_t iPrev;
+
+	if(thread_id == NULL) return (int32_t)0x80000000;
+
+	pthread_mutex_lock(&xRtosSimLock);
+	iPrev = thread_id->Signals;
+	thread_id->Signals &= ~signals;
+	pthread_mutex_unlock(&xRtosSimLock);
+
+	return iPrev;
+}
+
+/**
+  * @brief  waits until all the given signals of the calling thread are set and clears them, 0 waits for any
+  * @param  signals: flags to wait for
+  * @param  millisec: timeout, 0 polls, osWaitForever blocks
+	* @retval osEventSignal, osOK or osEventTimeout
+  */
+//========================================================
+osEvent osSignalWait(int32_t signals, uint32_t millisec)
+//========================================================
+{
+	osEvent evt = { .status = osOK };
+	struct timespec ts;
+	osThreadId self;
+
+	RtosSim_Deadline(&ts, millisec);
+	pthread_mutex_lock(&xRtosSimLock);
+	self = RtosSim_Self();
+
+	for(;;)
+	{
+		// 0 waits for any signal, otherwise for all of the given ones
+		if((signals == 0) ? (self->Signals != 0) : ((self->Signals & signals) == signals)){
+			evt.status = osEventSignal;
+			evt.value.signals = self->Signals;
+			self->Signals &= (signals == 0) ? 0 : ~signals;
+			break;
+		}
+		if(millisec == 0) break;
+		if(RtosSim_Wait(&self->Cond, (millisec == osWaitForever) ? NULL : &ts) == ETIMEDOUT){
+			evt.status = osEventTimeout;
+			break;
+		}
+	}
+
+	pthread_mutex_unlock(&xRtosSimLock);
+	return evt;
+}
+
+/**
+  * @brief  creates a message queue of 32 bit values
+  * @param  queue_def: queue definition
+  * @param  thread_id: unused
+	* @retval queue id, NULL on failure
+  */
+//====================================================================================
+osMessageQId osMessageCreate(const osMessageQDef_t* queue_def, osThreadId thread_id)
+//====================================================================================
+{
+	osMessageQId id = NULL;
+
+	(void)thread_id;
+	if(queue_def->queue_sz == 0 || queue_def->queue_sz > RTOS_SIM_QUEUE_MAX) return NULL;
+
+	pthread_mutex_lock(&xRtosSimLock);
+	if(uwRtosSimQueues < RTOS_SIM_MAX_QUEUES){
+		id = &xRtosSimQueue[uwRtosSimQueues++];
+		id->Size = queue_def->queue_sz;
+		id->Head = 0;
+		id->Count = 0;
+		pthread_cond_init(&id->Cond, NULL);
+	}
+	pthread_mutex_unlock(&xRtosSimLock);
+
+	return id;
+}
+
+/**
+  * @brief  queues a 32 bit value
+  * @param  queue_id: queue
+  * @param  info: value
+  * @param  millisec: timeout while the queue is full
+	* @retval osOK, osErrorResource or osErrorTimeoutResource
+  */
+//==============================================================================
+osStatus osMessagePut(osMessageQId queue_id, uint32_t info, uint32_t millisec)
+//==============================================================================
+{
+	osStatus status = osOK;
+	struct timespec ts;
+
+	if(queue_id == NULL) return osErrorParameter;
+
+	RtosSim_Deadline(&ts, millisec);
+	pthread_mutex_lock(&xRtosSimLock);
+
+	while(queue_id->Count == queue_id->Size)
+	{
+		if(millisec == 0){
+			status = osErrorResource;
+			break;
+		}
+		if(RtosSim_Wait(&queue_id->Cond, (millisec == osWaitForever) ? NULL : &ts) == ETIMEDOUT){
+			status = osErrorTimeoutResource;
+			break;
+		}
+	}
+
+	if(status == osOK){
+		queue_id->Buf[(queue_id->Head + queue_id->Count) % queue_id->Size] = info;
+		queue_id->Count++;
+		pthread_cond_broadcast(&queue_id->Cond);
+	}
+
+	pthread_mutex_unlock(&xRtosSimLock);
+	return status;
+}
+
+/**
+  * @brief  takes the oldest value of a queue
+  * @param  queue_id: queue
+  * @param  millisec: timeout while the queue is empty
+	* @retval event, osEventMessage with the value
+  */
+//==============================================================
+osEvent osMessageGet(osMessageQId queue_id, uint32_t millisec)
+//==============================================================
+{
+	osEvent evt = { .status = osOK };
+	struct timespec ts;
+
+	if(queue_id == NULL){
+		evt.status = osErrorParameter;
+		return evt;
+	}
+
+	RtosSim_Deadline(&ts, millisec);
+	pthread_mutex_lock(&xRtosSimLock);
+
+	while(queue_id->Count == 0)
+	{
+		if(millisec == 0) break;
+		if(RtosSim_Wait(&queue_id->Cond, (millisec == osWaitForever) ? NULL : &ts) == ETIMEDOUT){
+			evt.status = osEventTimeout;
+			break;
+		}
+	}
+
+	if(queue_id->Count != 0){
+		evt.status = osEventMessage;
+		evt.value.p = (void*)(uintptr_t)queue_id->Buf[queue_id->Head];
+		evt.def.message_id = queue_id;
+		queue_id->Head = (queue_id->Head + 1) % queue_id->Size;
+		queue_id->Count--;
+		pthread_cond_broadcast(&queue_id->Cond);
+	}
+
+	pthread_mutex_unlock(&xRtosSimLock);
+	return evt;
+}
+
+/**
+  * @brief  creates a counting semaphore
+  * @param  semaphore_def: unused
+  * @param  count: initial tokens
+	* @retval semaphore id, NULL on failure
+  */
+//=====================================================================================
+osSemaphoreId osSemaphoreCreate(const osSemaphoreDef_t* semaphore_def, int32_t count)
+//=====================================================================================
+{
+	osSemaphoreId id = NULL;
+
+	(void)semaphore_def;
+
+	pthread_mutex_lock(&xRtosSimLock);
+	if(uwRtosSimSems < RTOS_SIM_MAX_SEMAPHORES){
+		id = &xRtosSimSem[uwRtosSimSems++];
+		id->Count = count;
+		pthread_cond_init(&id->Cond, NULL);
+	}
+	pthread_mutex_unlock(&xRtosSimLock);
+
+	return id;
+}
+
+/**
+  * @brief  takes a token
+  * @param  semaphore_id: semaphore
+  * @param  millisec: timeout while none is available
+	* @retval tokens available before, 0 on timeout, -1 on a bad id
+  */
+//======================================================================
+int32_t osSemaphoreWait(osSemaphoreId semaphore_id, uint32_t millisec)
+//======================================================================
+{
+	int32_t iTokens = 0;
+	struct timespec ts;
+
+	if(semaphore_id == NULL) return -1;
+
+	RtosSim_Deadline(&ts, millisec);
+	pthread_mutex_lock(&xRtosSimLock);
+
+	while(semaphore_id->Count == 0)
+	{
+		if(millisec == 0) break;
+		if(RtosSim_Wait(&semaphore_id->Cond, (millisec == osWaitForever) ? NULL : &ts) == ETIMEDOUT) break;
+	}
+
+	// like RTX: the tokens available before this one was taken
+	if(semaphore_id->Count != 0){
+		iTokens = semaphore_id->Count--;
+	}
+
+	pthread_mutex_unlock(&xRtosSimLock);
+	return iTokens;
+}
+
+/**
+  * @brief  returns a token and wakes a waiter
+  * @param  semaphore_id: semaphore
+	* @retval osOK, osErrorParameter on a bad id
+  */
+//=======================================================
+osStatus osSemaphoreRelease(osSemaphoreId semaphore_id)
+//=======================================================
+{
+	if(semaphore_id == NULL) return osErrorParameter;
+
+	pthread_mutex_lock(&xRtosSimLock);
+	semaphore_id->Count++;
+	pthread_cond_broadcast(&semaphore_id->Cond);
+	pthread_mutex_unlock(&xRtosSimLock);
+
+	return osOK;
+}
+
+#endif /* BSP_EEPROM_SIM && BSP_EEPROM_USE_RTOS */
@@ -0,0 +1,713 @@
+/**
+  ******************************************************************************
+  * @file    BSP_EEPROM_Sim.c
+  * @author  Hossein Bagherzade(@realhba)
+	* @email	 hossein.bagherzade@gmail.com
+  * @version V1.0.0
+  * @date    18-Oct-2026
+  * @brief   Host model of an AT25 part for testing the storage layers. With
+  * BSP_EEPROM_SIM the bit-bang pins of the driver drive this model, so the
+  * real driver code runs against it: SPI mode 0 frames, WEL, block protect,
+  * page latch with wrap, write cycles on the virtual clock and address
+  * wraparound. Up to EEP_SIM_MAX_CHIPS parts share CK, SI and SO, each on the
+  * chip select of its device handle. Faults come from a seeded schedule:
+  * power cut at byte N of a page program, read bit errors, stuck bits,
+  * coupling, WIP that never clears and tWC jitter. Everything is in RAM, so a scenario costs
+  * microseconds of host time. EEPROM_Sim_Fuzz replays a byte string as
+  * Write/Read calls through the driver and checks the array after each one
+  * against a flat reference, it is shaped for a libFuzzer entry point. With
+  * BSP_EEPROM_FUZZ this file has LLVMFuzzerTestOneInput, e.g. from the
+  * repository root:
+  *
+  *   clang -g -O1 -fsanitize=fuzzer,address,undefined -DUSE_HAL_DRIVER
+  *       -DSTM32F030x8 -DBSP_TIMEBASE_VIRTUAL -DBSP_EEPROM_SIM -DBSP_EEPROM_FUZZ
+  *       -IInc -IMiddlewares/Third_Party/BSP -IDrivers/STM32F0xx_HAL_Driver/Inc
+  *       -IDrivers/CMSIS/Include -IDrivers/CMSIS/Device/ST/STM32F0xx/Include
+  *       Middlewares/Third_Party/BSP/BSP_Timebase.c
+  *       Middlewares/Third_Party/BSP/BSP_EEPROM.c
+  *       Middlewares/Third_Party/BSP/BSP_EEPROM_Sim.c -o eeprom_fuzz
+  *   ./eeprom_fuzz -max_len=6144 corpus/
+  *
+  * The seed corpus is replayed by the "fuzz corpus replay" check of
+  * BSP_EEPROM_SimTest.c. A desktop replays about 1M random ops/min; the cost
+  * grows with the transfer length, full 512 byte ones run a few times slower.
+  ******************************************************************************
+	**/
+
+#include "BSP_EEPROM.h"
+#include "BSP_EEPROM_Sim.h"
+#include "BSP_Timebase.h"
+#include "string.h"
+#include "stddef.h"
+
+#ifdef BSP_EEPROM_SIM
+
+#define SIM_CMD_WRSR										 (uint8_t)0x01
+#define SIM_CMD_WRITE										 (uint8_t)0x02
+#define SIM_CMD_READ										 (uint8_t)0x03
+#define SIM_CMD_WRDI										 (uint8_t)0x04
+#define SIM_CMD_RDSR										 (uint8_t)0x05
+#define SIM_CMD_WREN										 (uint8_t)0x06
+#define SIM_SR_WIP											 (uint8_t)0x01
+#define SIM_SR_WEL											 (uint8_t)0x02
+#define SIM_SR_WRITABLE									 (uint8_t)0x8C 		// WPEN, BP1, BP0
+#define SIM_TWC_DEFAULT_US							 (uint32_t)3000
+#define SIM_FUZZ_TWC_US									 (uint32_t)5 			// short cycles keep the fuzzer fast, timing is not under test
+
+enum { SIM_IDLE = 0, SIM_CMD, SIM_ADDR, SIM_READ, SIM_STATUS, SIM_WRITE, SIM_WRSR, SIM_IGNORE };
+
+EEP_SimTypeDef hEepSim[EEP_SIM_MAX_CHIPS];
+uint8_t ucEepSimChips;
+
+static EEP_SimTypeDef* pSim = &hEepSim[0];										// chip the model functions work on
+
+static void EEPROM_Sim_PowerCycleChip(void);
+
+static uint8_t ucSimRef[EEP_SIM_CAPACITY_MAX];
+static uint8_t ucSimData[EEP_SIM_FUZZ_LEN_MAX];
+
+/**
+  * @brief  xorshift32 step of the fault schedule
+	* @retval next random value
+  */
+//==============================================
+static uint32_t EEPROM_Sim_Rand(void)
+//==============================================
+{
+	uint32_t x = pSim->Rng;
+
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	pSim->Rng = x;
+	return x;
+}
+
+/**
+  * @brief  true while a write cycle runs, a stuck WIP never ends
+	* @retval 1 if busy
+  */
+//==============================================
+static uint8_t EEPROM_Sim_Busy(void)
+//==============================================
+{
+	return (pSim->WipStuck != 0) || ((int32_t)(pSim->BusyUntil - BSP_GetMicros()) > 0);
+}
+
+/**
+  * @brief  status register as seen by RDSR, all ones during a write cycle
+	* @retval status byte
+  */
+//==============================================
+static uint8_t EEPROM_Sim_Status(void)
+//==============================================
+{
+	return EEPROM_Sim_Busy() ? 0xFF : pSim->Status;
+}
+
+/**
+  * @brief  array byte as read out: stuck bits and read errors applied
+  * @param  uwAddr: array address
+	* @retval byte on SO
+  */
+//==============================================
+static uint8_t EEPROM_Sim_ReadCell(uint32_t uwAddr)
+//==============================================
+{
+	uint8_t ucByte = pSim->Mem[uwAddr];
+
+	for(uint8_t i = 0; i < EEP_SIM_MAX_STUCK; i++){
+		if(pSim->Faults.Stuck[i].Mask != 0 && pSim->Faults.Stuck[i].Addr == uwAddr){
+			ucByte = (ucByte & ~pSim->Faults.Stuck[i].Mask) | (pSim->Faults.Stuck[i].Value & pSim->Faults.Stuck[i].Mask);
+		}
+	}
+
+	if(pSim->Faults.BitErrorPpm != 0){
+		for(uint8_t b = 0; b < 8; b++){
+			if((EEPROM_Sim_Rand() % 1000000) < pSim->Faults.BitErrorPpm){
+				ucByte ^= (uint8_t)(1U << b);
+				pSim->BitFlips++;
+			}
+		}
+	}
+
+	return ucByte;
+}
+
+/**
+  * @brief  programs one array byte, coupled victims follow
+  * @param  uwAddr: array address
+  * @param  ucByte: new value
+	* @retval none
+  */
+//===============================================================
+static void EEPROM_Sim_Program(uint32_t uwAddr, uint8_t ucByte)
+//===============================================================
+{
+	EEP_SimCouplingTypeDef* pCpl;
+
+	pSim->Mem[uwAddr] = ucByte;
+
+	for(uint8_t i = 0; i < EEP_SIM_MAX_COUPLING; i++){
+		pCpl = &pSim->Faults.Coupling[i];
+		if(pCpl->Mask != 0 && pCpl->Aggressor == uwAddr && pCpl->Victim < pSim->Capacity){
+			pSim->Mem[pCpl->Victim] = (pSim->Mem[pCpl->Victim] & ~pCpl->Mask) | (ucByte & pCpl->Mask);
+		}
+	}
+}
+
+/**
+  * @brief  first address of the block protected by BP1:BP0, Capacity if none
+	* @retval protected boundary
+  */
+//==============================================
+static uint32_t EEPROM_Sim_Protected(void)
+//==============================================
+{
+	switch((pSim->Status >> 2) & 0x03){
+		case 1: 	return pSim->Capacity - pSim->Capacity / 4;
+		case 2: 	return pSim->Capacity / 2;
+		case 3: 	return 0;
+		default: 	return pSim->Capacity;
+	}
+}
+
+/**
+  * @brief  starts a write cycle, a scheduled cut or stuck WIP hits here
+	* @retval 0 if the power was cut at this cycle
+  */
+//==============================================
+static uint8_t EEPROM_Sim_StartCycle(void)
+//==============================================
+{
+	uint32_t uwTwc = pSim->Faults.TwcUs;
+
+	pSim->Writes++;
+	pSim->Status &= (uint8_t)~SIM_SR_WEL;
+
+	if(pSim->Faults.TwcJitterUs != 0) uwTwc += EEPROM_Sim_Rand() % (pSim->Faults.TwcJitterUs + 1);
+	pSim->BusyUntil = BSP_GetMicros() + uwTwc;
+
+	if(pSim->Faults.WipStuckAtWrite != 0 && pSim->Writes == pSim->Faults.WipStuckAtWrite) pSim->WipStuck = 1;
+
+	return !(pSim->Faults.CutAtWrite != 0 && pSim->Writes == pSim->Faults.CutAtWrite);
+}
+
+/**
+  * @brief  CS rising edge: WREN/WRDI take effect and a latched WRITE/WRSR starts
+  *         its write cycle, only on a byte aligned frame as on the part
+	* @retval none
+  */
+//==============================================
+static void EEPROM_Sim_EndFrame(void)
+//==============================================
+{
+	uint32_t uwBase, uwAddr, uwProtected;
+	uint16_t uiDone = 0;
+
+	if(pSim->BitCount != 0 || pSim->Phase == SIM_IGNORE) return;
+
+	if(pSim->Phase == SIM_WRITE && pSim->LatchCount == 0) pSim->EmptyWrites++;
+	if(pSim->Phase == SIM_WRITE && pSim->LatchCount > pSim->PageSize - pSim->LatchOffset) pSim->WrapWrites++;
+
+	if(pSim->Phase == SIM_CMD && pSim->Opcode == SIM_CMD_WREN) pSim->Status |= SIM_SR_WEL;
+	if(pSim->Phase == SIM_CMD && pSim->Opcode == SIM_CMD_WRDI) pSim->Status &= (uint8_t)~SIM_SR_WEL;
+
+	if(pSim->Phase == SIM_WRITE && pSim->LatchCount != 0 && (pSim->Status & SIM_SR_WEL))
+	{
+		uwBase = pSim->Addr - (pSim->Addr % pSim->PageSize);
+		uwProtected = EEPROM_Sim_Protected();
+		if(uwBase >= uwProtected){
+			pSim->Status &= (uint8_t)~SIM_SR_WEL;
+			return;
+		}
+
+		if(EEPROM_Sim_StartCycle()){
+			uiDone = pSim->PageSize;
+		}
+		else{
+			pSim->PowerLost = 1;
+			uiDone = pSim->Faults.CutAtByte;
+		}
+
+		// bytes go in latch order starting at the addressed offset
+		for(uint16_t i = 0; i < pSim->PageSize; i++)
+		{
+			uint16_t uiOff = (pSim->LatchOffset + i) % pSim->PageSize;
+			if(pSim->LatchValid[uiOff] == 0) continue;
+			uwAddr = uwBase + uiOff;
+
+			if(uiDone == 0){
+				// the byte being programmed when the supply went away is torn
+				if(pSim->PowerLost) EEPROM_Sim_Program(uwAddr, (uint8_t)EEPROM_Sim_Rand());
+				break;
+			}
+			EEPROM_Sim_Program(uwAddr, pSim->Latch[uiOff]);
+			uiDone--;
+		}
+	}
+
+	if(pSim->Phase == SIM_WRSR && pSim->LatchCount != 0 && (pSim->Status & SIM_SR_WEL))
+	{
+		if(EEPROM_Sim_StartCycle()){
+			pSim->Status = (pSim->Status & (uint8_t)~SIM_SR_WRITABLE) | (pSim->Latch[0] & SIM_SR_WRITABLE);
+		}
+		else{
+			pSim->PowerLost = 1;
+		}
+	}
+}
+
+/**
+  * @brief  a complete byte was shifted in, decode it and load the next output
+	* @retval none
+  */
+//==============================================
+static void EEPROM_Sim_Byte(void)
+//==============================================
+{
+	uint8_t b = pSim->RxByte;
+
+	BSP_Timebase_Advance(EEP_SIM_BYTE_US);
+
+	switch(pSim->Phase)
+	{
+		case SIM_CMD:
+			pSim->Opcode = b;
+			pSim->Addr = 0;
+			// single address byte parts carry A8 in bit 3 of READ/WRITE
+			if(pSim->AddrBytes == 1 && ((b & 0xF7) == SIM_CMD_READ || (b & 0xF7) == SIM_CMD_WRITE)){
+				pSim->Opcode = b & 0xF7;
+				pSim->Addr = (b >> 3) & 0x01;
+			}
+
+			if(pSim->Opcode == SIM_CMD_RDSR){
+				pSim->TxByte = EEPROM_Sim_Status();
+				pSim->Phase = SIM_STATUS;
+			}
+			else if(EEPROM_Sim_Busy()){
+				pSim->Phase = SIM_IGNORE;
+			}
+			else if(pSim->Opcode == SIM_CMD_READ || pSim->Opcode == SIM_CMD_WRITE){
+				pSim->AddrLeft = pSim->AddrBytes;
+				pSim->Phase = SIM_ADDR;
+			}
+			else if(pSim->Opcode == SIM_CMD_WRSR){
+				pSim->LatchCount = 0;
+				pSim->Phase = SIM_WRSR;
+			}
+			else if(pSim->Opcode != SIM_CMD_WREN && pSim->Opcode != SIM_CMD_WRDI){
+				pSim->Phase = SIM_IGNORE;
+			}
+			break;
+
+		case SIM_ADDR:
+			pSim->Addr = (pSim->Addr << 8) | b;
+			if(--pSim->AddrLeft != 0) break;
+
+			// upper address bits the part does not have are ignored
+			pSim->Addr &= pSim->Capacity - 1;
+			if(pSim->Opcode == SIM_CMD_READ){
+				pSim->TxByte = EEPROM_Sim_ReadCell(pSim->Addr);
+				pSim->Phase = SIM_READ;
+			}
+			else{
+				memset(pSim->LatchValid, 0, pSim->PageSize);
+				pSim->LatchOffset = (uint16_t)(pSim->Addr % pSim->PageSize);
+				pSim->LatchCount = 0;
+				pSim->Phase = SIM_WRITE;
+			}
+			break;
+
+		case SIM_READ:
+			pSim->Addr = (pSim->Addr + 1) & (pSim->Capacity - 1);
+			pSim->TxByte = EEPROM_Sim_ReadCell(pSim->Addr);
+			break;
+
+		case SIM_STATUS:
+			pSim->TxByte = EEPROM_Sim_Status();
+			break;
+
+		case SIM_WRITE:
+		{
+			// the latch wraps inside the page, later bytes overwrite earlier ones
+			uint16_t uiOff = (uint16_t)((pSim->LatchOffset + pSim->LatchCount) % pSim->PageSize);
+			pSim->Latch[uiOff] = b;
+			pSim->LatchValid[uiOff] = 1;
+			pSim->LatchCount++;
+			break;
+		}
+
+		case SIM_WRSR:
+			if(pSim->LatchCount == 0) pSim->Latch[0] = b;
+			pSim->LatchCount++;
+			break;
+
+		default:
+			break;
+	}
+}
+
+/**
+  * @brief  takes every chip off the bus, add them back with EEPROM_Sim_AddChip
+	* @retval none
+  */
+//==============================================
+void EEPROM_Sim_Reset(void)
+//==============================================
+{
+	ucEepSimChips = 0;
+	pSim = &hEepSim[0];
+}
+
+/**
+  * @brief  puts an erased chip on the bus: it shares CK, SI and SO with the
+  *         others and has its own chip select, faults are cleared
+  * @param  uiCsPin: chip select pin it answers, EEP_SIM_CS_ANY for every one
+  * @param  uwCapacity: array size, a power of two up to EEP_SIM_CAPACITY_MAX
+  * @param  uiPageSize: page size, up to EEP_SIM_PAGE_MAX
+  * @param  ucAddrBytes: address bytes sent after the opcode
+	* @retval chip model, NULL if the bus is full
+  */
+//===================================================================================================================
+EEP_SimTypeDef* EEPROM_Sim_AddChip(uint16_t uiCsPin, uint32_t uwCapacity, uint16_t uiPageSize, uint8_t ucAddrBytes)
+//===================================================================================================================
+{
+	EEP_SimFaultsTypeDef faults;
+
+	if(ucEepSimChips >= EEP_SIM_MAX_CHIPS) return NULL;
+	if(uwCapacity > EEP_SIM_CAPACITY_MAX) uwCapacity = EEP_SIM_CAPACITY_MAX;
+	if(uiPageSize > EEP_SIM_PAGE_MAX) uiPageSize = EEP_SIM_PAGE_MAX;
+
+	pSim = &hEepSim[ucEepSimChips++];
+	pSim->CsPin = uiCsPin;
+	pSim->Capacity = uwCapacity;
+	pSim->PageSize = uiPageSize;
+	pSim->AddrBytes = ucAddrBytes;
+	memset(pSim->Mem, 0xFF, uwCapacity);
+	pSim->Status = 0;
+
+	memset(&faults, 0, sizeof(faults));
+	EEPROM_Sim_SetChipFaults(pSim, &faults);
+	EEPROM_Sim_PowerCycleChip();
+
+	return pSim;
+}
+
+/**
+  * @brief  a single erased chip answering every chip select, faults cleared
+  * @param  uwCapacity: array size, a power of two up to EEP_SIM_CAPACITY_MAX
+  * @param  uiPageSize: page size, up to EEP_SIM_PAGE_MAX
+  * @param  ucAddrBytes: address bytes sent after the opcode
+	* @retval none
+  */
+//=======================================================================================
+void EEPROM_Sim_Init(uint32_t uwCapacity, uint16_t uiPageSize, uint8_t ucAddrBytes)
+//=======================================================================================
+{
+	EEPROM_Sim_Reset();
+	EEPROM_Sim_AddChip(EEP_SIM_CS_ANY, uwCapacity, uiPageSize, ucAddrBytes);
+}
+
+/**
+  * @brief  installs a fault schedule on one chip and restarts its random
+  *         sequence and counters
+  * @param  pChip: chip model
+  * @param  pFaults: schedule, copied
+	* @retval none
+  */
+//=========================================================================================
+void EEPROM_Sim_SetChipFaults(EEP_SimTypeDef* pChip, const EEP_SimFaultsTypeDef* pFaults)
+//=========================================================================================
+{
+	pChip->Faults = *pFaults;
+	if(pChip->Faults.TwcUs == 0) pChip->Faults.TwcUs = SIM_TWC_DEFAULT_US;
+
+	pChip->Rng = (pFaults->Seed != 0) ? pFaults->Seed : 0x2545F491;
+	pChip->Writes = 0;
+	pChip->BitFlips = 0;
+	pChip->EmptyWrites = 0;
+	pChip->WrapWrites = 0;
+}
+
+/**
+  * @brief  installs the same fault schedule on every chip of the bus
+  * @param  pFaults: schedule, copied
+	* @retval none
+  */
+//==============================================================
+void EEPROM_Sim_SetFaults(const EEP_SimFaultsTypeDef* pFaults)
+//==============================================================
+{
+	for(uint8_t c = 0; c < ucEepSimChips; c++) EEPROM_Sim_SetChipFaults(&hEepSim[c], pFaults);
+}
+
+/**
+  * @brief  power comes back after a cut: the array and the non volatile status
+  *         bits are kept, WEL, the write cycle and the bus frame are reset
+	* @retval none
+  */
+//==============================================
+static void EEPROM_Sim_PowerCycleChip(void)
+//==============================================
+{
+	pSim->PowerLost = 0;
+	pSim->WipStuck = 0;
+	pSim->BusyUntil = BSP_GetMicros();
+	pSim->Status &= SIM_SR_WRITABLE;
+
+	pSim->Cs = 1;
+	pSim->Ck = 0;
+	pSim->So = 1;
+	pSim->Phase = SIM_IDLE;
+	pSim->BitCount = 0;
+}
+
+/**
+  * @brief  power cycle of the whole bus, see EEPROM_Sim_PowerCycleChip
+	* @retval none
+  */
+//==============================================
+void EEPROM_Sim_PowerCycle(void)
+//==============================================
+{
+	for(uint8_t c = 0; c < ucEepSimChips; c++){
+		pSim = &hEepSim[c];
+		EEPROM_Sim_PowerCycleChip();
+	}
+}
+
+/**
+  * @brief  chip select driven by the driver, a chip answers its own pin
+  * @param  uiCsPin: pin of the selected device, pEeprom->CsPin
+  * @param  ucLevel: 0 or 1
+	* @retval none
+  */
+//========================================================
+void EEPROM_Sim_SetCs(uint16_t uiCsPin, uint8_t ucLevel)
+//========================================================
+{
+	ucLevel = (ucLevel != 0);
+
+	for(uint8_t c = 0; c < ucEepSimChips; c++)
+	{
+		pSim = &hEepSim[c];
+		if(pSim->CsPin != EEP_SIM_CS_ANY && pSim->CsPin != uiCsPin) continue;
+		if(ucLevel == pSim->Cs) continue;
+		pSim->Cs = ucLevel;
+		if(pSim->PowerLost) continue;
+
+		if(ucLevel == 0){
+			pSim->Phase = SIM_CMD;
+			pSim->BitCount = 0;
+			pSim->RxByte = 0;
+			pSim->TxByte = 0xFF;
+		}
+		else{
+			EEPROM_Sim_EndFrame();
+			pSim->Phase = SIM_IDLE;
+		}
+	}
+}
+
+/**
+  * @brief  pin of one chip, SPI mode 0: SI sampled on CK rising, SO shifted
+  *         out on CK falling. Lanes of a gang fixture drive SI per chip.
+  * @param  ucChip: chip index on the bus
+  * @param  pin: CK or SI
+  * @param  ucLevel: 0 or 1
+	* @retval none
+  */
+//==================================================================================
+void EEPROM_Sim_SetChipPin(uint8_t ucChip, EEP_SimPinTypeDef pin, uint8_t ucLevel)
+//==================================================================================
+{
+	if(ucChip >= ucEepSimChips) return;
+
+	ucLevel = (ucLevel != 0);
+	pSim = &hEepSim[ucChip];
+
+	if(pin == EEP_SIM_PIN_SI){
+		pSim->Si = ucLevel;
+		return;
+	}
+
+	if(ucLevel == pSim->Ck) return;
+	pSim->Ck = ucLevel;
+	if(pSim->Cs != 0 || pSim->PowerLost) return;
+
+	if(ucLevel == 0){
+		pSim->So = (pSim->TxByte >> (7 - pSim->BitCount)) & 0x01;
+	}
+	else{
+		pSim->RxByte = (uint8_t)((pSim->RxByte << 1) | pSim->Si);
+		if(++pSim->BitCount == 8){
+			pSim->BitCount = 0;
+			EEPROM_Sim_Byte();
+			pSim->RxByte = 0;
+		}
+	}
+}
+
+/**
+  * @brief  bus pin driven by the driver and seen by every chip
+  * @param  pin: CK or SI
+  * @param  ucLevel: 0 or 1
+	* @retval none
+  */
+//==============================================================
+void EEPROM_Sim_SetPin(EEP_SimPinTypeDef pin, uint8_t ucLevel)
+//==============================================================
+{
+	for(uint8_t c = 0; c < ucEepSimChips; c++) EEPROM_Sim_SetChipPin(c, pin, ucLevel);
+}
+
+/**
+  * @brief  SO of one chip on its own line, high while it is deselected, dead
+  *         or missing (the MCU pull-up)
+  * @param  ucChip: chip index on the bus
+	* @retval SO level
+  */
+//==============================================
+uint8_t EEPROM_Sim_GetChipSO(uint8_t ucChip)
+//==============================================
+{
+	if(ucChip >= ucEepSimChips) return 1;
+	if(hEepSim[ucChip].Cs != 0 || hEepSim[ucChip].PowerLost) return 1;
+
+	return hEepSim[ucChip].So;
+}
+
+/**
+  * @brief  SO as sampled by the driver, the selected chips drive it and a dead
+  *         or deselected part leaves it high
+	* @retval SO level
+  */
+//==============================================
+uint8_t EEPROM_Sim_GetSO(void)
+//==============================================
+{
+	uint8_t ucSo = 1;
+
+	for(uint8_t c = 0; c < ucEepSimChips; c++) ucSo &= EEPROM_Sim_GetChipSO(c);
+
+	return ucSo;
+}
+
+/**
+  * @brief  SO with the part deselected: it floats and follows the MCU pull
+  * @param  ucPullUp: 1 with the pull-up, 0 with the pull-down
+	* @retval SO level
+  */
+//==============================================
+uint8_t EEPROM_Sim_SampleSO(uint8_t ucPullUp)
+//==============================================
+{
+	return ucPullUp;
+}
+
+/**
+  * @brief  differential run of the write path: each EEP_SIM_FUZZ_OP_BYTES of
+  *         input become one BSP_EEPROM_Write or BSP_EEPROM_Read with the given
+  *         address and length, out of range requests included. After every
+  *         call the model array must equal a flat reference, a read must return
+  *         it, and a write must cost exactly one write cycle per page it spans
+  *         with no empty or wrapping WRITE frame. The model takes the geometry
+  *         of pEeprom and starts erased, so an input replays the same way.
+  * @param  pData: fuzz input
+  * @param  uwSize: input length
+	* @retval number of failed checks, 0 if the driver agreed with the reference
+  */
+//===================================================================
+uint32_t EEPROM_Sim_Fuzz(const uint8_t* pData, uint32_t uwSize)
+//===================================================================
+{
+	EEP_SimFaultsTypeDef faults;
+	HAL_StatusTypeDef E2PStatus;
+	uint32_t uwAddr, uwLen, uwPages, uwWrites, uwFails = 0;
+	uint8_t ucValid;
+
+	EEPROM_Sim_Init(pEeprom->Capacity, pEeprom->PageSize, pEeprom->AddrBytes);
+	pSim = &hEepSim[0];
+	memset(&faults, 0, sizeof(faults));
+	faults.TwcUs = SIM_FUZZ_TWC_US;
+	EEPROM_Sim_SetFaults(&faults);
+	memset(ucSimRef, 0xFF, pSim->Capacity);
+	pEeprom->WriteBusy = 0;
+
+	for(; uwSize >= EEP_SIM_FUZZ_OP_BYTES; pData += EEP_SIM_FUZZ_OP_BYTES, uwSize -= EEP_SIM_FUZZ_OP_BYTES)
+	{
+		// a few addresses and lengths past the end exercise the range checks
+		uwAddr = ((uint32_t)pData[1] << 16 | (uint32_t)pData[2] << 8 | pData[3]) % (pSim->Capacity + pSim->PageSize);
+		uwLen = ((uint32_t)pData[4] << 8 | pData[5]) % (EEP_SIM_FUZZ_LEN_MAX + 1);
+		ucValid = (uwLen != 0) && (uwAddr < pSim->Capacity) && (uwLen <= pSim->Capacity - uwAddr);
+
+		if(pData[0] & 0x01)
+		{
+			memset(ucSimData, 0, uwLen);
+			E2PStatus = BSP_EEPROM_Read(uwAddr, ucSimData, uwLen);
+			if(ucValid && (E2PStatus != HAL_OK || memcmp(ucSimData, &ucSimRef[uwAddr], uwLen) != 0)) uwFails++;
+		}
+		else
+		{
+			// data depends on the op bytes only, so a rewrite often stores new values
+			pSim->Rng = ((uint32_t)pData[0] << 24 | uwAddr) ^ (uwLen << 12) ^ 0x9E3779B9;
+			for(uint32_t i = 0; i < uwLen; i++) ucSimData[i] = (uint8_t)EEPROM_Sim_Rand();
+
+			uwWrites = pSim->Writes;
+			E2PStatus = BSP_EEPROM_Write(uwAddr, ucSimData, uwLen);
+			uwPages = 0;
+			if(ucValid){
+				memcpy(&ucSimRef[uwAddr], ucSimData, uwLen);
+				uwPages = (uwAddr + uwLen - 1) / pSim->PageSize - uwAddr / pSim->PageSize + 1;
+			}
+			if((E2PStatus == HAL_OK) != ucValid || pSim->Writes - uwWrites != uwPages) uwFails++;
+		}
+
+		if(pSim->EmptyWrites != 0 || pSim->WrapWrites != 0 || memcmp(pSim->Mem, ucSimRef, pSim->Capacity) != 0){
+			uwFails++;
+			// resync so one bad op is not reported again for every later one
+			memcpy(ucSimRef, pSim->Mem, pSim->Capacity);
+			pSim->EmptyWrites = 0;
+			pSim->WrapWrites = 0;
+		}
+	}
+
+	return uwFails;
+}
+
+#ifdef BSP_EEPROM_FUZZ
+#ifndef BSP_EEPROM_SIMTEST
+/**
+  * @brief  EEP_LOG sink of the fuzz build, the driver's messages are dropped
+  *         so the fuzzer output stays readable
+  * @param  format: printf format
+	* @retval 0
+  */
+//==============================================
+int aPrintOutLog(const char* format, ...)
+//==============================================
+{
+	(void)format;
+
+	return 0;
+}
+#endif
+
+/**
+  * @brief  libFuzzer entry point, a failed check is reported as a crash
+  * @param  pData: fuzz input
+  * @param  size: input length
+	* @retval 0
+  */
+//====================================================================
+int LLVMFuzzerTestOneInput(const uint8_t* pData, size_t size)
+//====================================================================
+{
+	if(EEPROM_Sim_Fuzz(pData, (uint32_t)size) != 0) __builtin_trap();
+
+	return 0;
+}
+#endif
+
+#endif /* BSP_EEPROM_SIM */
@@ -0,0 +1,127 @@
+/**
+  ******************************************************************************
+  * @file    BSP_EEPROM_Sim.h
+  * @author  Hossein Bagherzade(@realhba)
+	* @email	 hossein.bagherzade@gmail.com
+  * @version V1.0.0
+  * @date    18-Oct-2026
+  * @brief   Header file for BSP_EEPROM_Sim.c
+  ******************************************************************************
+	**/
+
+
+#ifndef __BSP_EEPROM_SIM_H
+#define __BSP_EEPROM_SIM_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "stdint.h"
+
+
+#define EEP_SIM_CAPACITY_MAX						 (uint32_t)262144 // largest modelled part (25xxM02)
+#define EEP_SIM_PAGE_MAX								 (uint16_t)256
+#define EEP_SIM_MAX_STUCK								 (uint8_t)4
+#define EEP_SIM_MAX_COUPLING						 (uint8_t)4
+#define EEP_SIM_MAX_CHIPS								 (uint8_t)4 			// chips on the modelled bus
+#define EEP_SIM_CS_ANY									 (uint16_t)0 			// chip that answers every chip select
+#define EEP_SIM_BYTE_US									 (uint32_t)1 			// virtual time per byte on the bus
+#define EEP_SIM_FUZZ_OP_BYTES						 (uint8_t)6 			// fuzz input per operation: kind, address[3], length[2]
+#define EEP_SIM_FUZZ_LEN_MAX						 (uint16_t)512 		// longest fuzzed transfer
+
+typedef enum
+{
+	EEP_SIM_PIN_CK = 0,
+	EEP_SIM_PIN_SI
+} EEP_SimPinTypeDef;
+
+typedef struct
+{
+	uint32_t Addr;
+	uint8_t  Mask;																							// bits that are stuck
+	uint8_t  Value;																							// level they are stuck at
+} EEP_SimStuckTypeDef;
+
+typedef struct
+{
+	uint32_t Aggressor;																					// programming this byte ...
+	uint32_t Victim;																						// ... copies its Mask bits into this one
+	uint8_t  Mask;
+} EEP_SimCouplingTypeDef;
+
+// Fault schedule, replayed exactly for the same Seed and the same bus traffic
+typedef struct
+{
+	uint32_t Seed;
+	uint32_t CutAtWrite;																				// write cycle (1 = first) that loses power, 0 = never
+	uint16_t CutAtByte;																					// bytes of that page programmed before the cut
+	uint32_t BitErrorPpm;																				// read bit flips per million bits
+	uint32_t WipStuckAtWrite;																		// write cycle whose WIP never clears, 0 = never
+	uint32_t TwcUs;																							// nominal write cycle time
+	uint32_t TwcJitterUs;																				// uniform extra time 0..TwcJitterUs
+	EEP_SimStuckTypeDef Stuck[EEP_SIM_MAX_STUCK];								// Mask 0 = unused
+	EEP_SimCouplingTypeDef Coupling[EEP_SIM_MAX_COUPLING];			// Mask 0 = unused
+} EEP_SimFaultsTypeDef;
+
+typedef struct
+{
+	// wiring, geometry and array
+	uint16_t CsPin;																							// chip select it answers, EEP_SIM_CS_ANY for all
+	uint32_t Capacity;
+	uint16_t PageSize;
+	uint8_t  AddrBytes;
+	uint8_t  Mem[EEP_SIM_CAPACITY_MAX];
+
+	// fault schedule and its state
+	EEP_SimFaultsTypeDef Faults;
+	uint32_t Rng;
+	uint8_t  PowerLost;																					// set by a cut, cleared by EEPROM_Sim_PowerCycle
+	uint8_t  WipStuck;
+
+	// device state
+	uint8_t  Status;																						// WEL, BP0, BP1, WPEN; WIP comes from BusyUntil
+	uint32_t BusyUntil;																					// virtual time the write cycle ends
+
+	// bus frame state
+	uint8_t  Cs, Ck, Si, So;
+	uint8_t  BitCount, RxByte, TxByte;
+	uint8_t  Phase, Opcode, AddrLeft;
+	uint32_t Addr;
+	uint16_t LatchOffset, LatchCount;
+	uint8_t  Latch[EEP_SIM_PAGE_MAX];
+	uint8_t  LatchValid[EEP_SIM_PAGE_MAX];
+
+	// statistics
+	uint32_t Writes;																						// write cycles started
+	uint32_t BitFlips;
+	uint32_t EmptyWrites;																				// WRITE frames that carried no data byte
+	uint32_t WrapWrites;																				// WRITE frames that wrapped inside the page latch
+} EEP_SimTypeDef;
+
+
+extern EEP_SimTypeDef hEepSim[EEP_SIM_MAX_CHIPS];
+extern uint8_t ucEepSimChips;
+
+void EEPROM_Sim_Reset(void);
+EEP_SimTypeDef* EEPROM_Sim_AddChip(uint16_t uiCsPin, uint32_t uwCapacity, uint16_t uiPageSize, uint8_t ucAddrBytes);
+void EEPROM_Sim_Init(uint32_t uwCapacity, uint16_t uiPageSize, uint8_t ucAddrBytes);
+void EEPROM_Sim_SetChipFaults(EEP_SimTypeDef* pChip, const EEP_SimFaultsTypeDef* pFaults);
+void EEPROM_Sim_SetFaults(const EEP_SimFaultsTypeDef* pFaults);
+void EEPROM_Sim_PowerCycle(void);
+void EEPROM_Sim_SetCs(uint16_t uiCsPin, uint8_t ucLevel);
+void EEPROM_Sim_SetChipPin(uint8_t ucChip, EEP_SimPinTypeDef pin, uint8_t ucLevel);
+void EEPROM_Sim_SetPin(EEP_SimPinTypeDef pin, uint8_t ucLevel);
+uint8_t EEPROM_Sim_GetChipSO(uint8_t ucChip);
+uint8_t EEPROM_Sim_GetSO(void);
+uint8_t EEPROM_Sim_SampleSO(uint8_t ucPullUp);
+uint32_t EEPROM_Sim_Fuzz(const uint8_t* pData, uint32_t uwSize);
+uint32_t EEPROM_SimTest_Run(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __BSP_EEPROM_SIM_H */
+
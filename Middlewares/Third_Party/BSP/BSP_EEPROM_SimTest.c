@@ -0,0 +1,1385 @@
+/**
+  ******************************************************************************
+  * @file    BSP_EEPROM_SimTest.c
+  * @author  Hossein Bagherzade(@realhba)
+	* @email	 hossein.bagherzade@gmail.com
+  * @version V1.0.0
+  * @date    18-Oct-2026
+  * @brief   Host checks of the storage layers against the AT25 model of
+  * BSP_EEPROM_Sim.c. Every check starts from an erased part behind the
+  * default device handle and counts the conditions that failed;
+  * EEPROM_SimTest_Run runs them all. With BSP_EEPROM_SIMTEST this file also
+  * has main(), e.g. from the repository root (a lower case debugprobe.h alias
+  * is needed on case sensitive file systems):
+  *
+  *   gcc -std=gnu99 -DUSE_HAL_DRIVER -DSTM32F030x8 -DBSP_TIMEBASE_VIRTUAL
+  *       -DBSP_EEPROM_SIM -DBSP_EEPROM_SIMTEST -IInc -IMiddlewares/Third_Party/BSP
+  *       -IDrivers/STM32F0xx_HAL_Driver/Inc -IDrivers/CMSIS/Include
+  *       -IDrivers/CMSIS/Device/ST/STM32F0xx/Include
+  *       Middlewares/Third_Party/BSP/BSP_Timebase.c
+  *       Middlewares/Third_Party/BSP/BSP_EEPROM.c
+  *       Middlewares/Third_Party/BSP/BSP_EEPROM_Sim.c
+  *       Middlewares/Third_Party/BSP/BSP_EEPROM_Volume.c
+  *       Middlewares/Third_Party/BSP/BSP_EEPROM_Config.c
+  *       Middlewares/Third_Party/BSP/BSP_EEPROM_Diag.c
+  *       Middlewares/Third_Party/BSP/BSP_EEPROM_Wave.c
+  *       Middlewares/Third_Party/BSP/BSP_EEPROM_Append.c
+  *       Middlewares/Third_Party/BSP/BSP_EEPROM_Gang.c
+  *       Middlewares/Third_Party/BSP/BSP_EEPROM_SimTest.c -o eeprom_simtest
+  *
+  * Adding -DBSP_EEPROM_FLASH_VIRTUAL with BSP_EEPROM_Flash.c also checks the
+  * flash emulation on RAM pages.
+  *
+  * Adding -DBSP_EEPROM_USE_RTOS -IDrivers/CMSIS/RTOS/Template -pthread -no-pie
+  * with BSP_EEPROM_Rtos.c and BSP_EEPROM_RtosSim.c also runs the storage
+  * worker on POSIX threads.
+  ******************************************************************************
+	**/
+
+#include "BSP_EEPROM.h"
+#include "BSP_EEPROM_Sim.h"
+#include "BSP_EEPROM_Volume.h"
+#include "BSP_EEPROM_Config.h"
+#include "BSP_EEPROM_Flash.h"
+#include "BSP_EEPROM_Diag.h"
+#include "BSP_EEPROM_Wave.h"
+#include "BSP_EEPROM_Append.h"
+#include "BSP_EEPROM_Gang.h"
+#include "BSP_EEPROM_Rtos.h"
+#include "string.h"
+
+#ifdef BSP_EEPROM_SIM
+
+#define SIMTEST_CHECK(cond) 						 do{ if(!(cond)){ EEP_LOG("  %s:%d: %s\r\n", __func__, __LINE__, #cond); uwFails++; } }while(0)
+
+typedef struct
+{
+	const char* Name;
+	uint32_t (*Run)(void);																			// number of failed conditions
+} EEP_SimTestTypeDef;
+
+static const EEP_DeviceTypeDef hSimTestDevice = EEP_DEVICE_INIT(EEP_CS_GPIO_Port, EEP_CS_Pin);
+static const EEP_DeviceTypeDef hSimTestChip[EEP_MAX_DEVICES] = {
+	EEP_DEVICE_INIT(EEP_CS_GPIO_Port, EEP_CS_Pin),
+	EEP_DEVICE_INIT(GPIOA, GPIO_PIN_1),
+	EEP_DEVICE_INIT(GPIOA, GPIO_PIN_2),
+	EEP_DEVICE_INIT(GPIOA, GPIO_PIN_3),
+};
+static EEP_DeviceTypeDef hSimTestBus[EEP_MAX_DEVICES];
+static uint8_t ucSimTestImage[EEP_SIM_CAPACITY_MAX];
+
+/**
+  * @brief  deterministic test data
+  * @param  pBuf: buffer to fill
+  * @param  uwLen: bytes
+  * @param  uwSeed: start value, equal seeds give equal data
+	* @retval none
+  */
+//==================================================================================
+static void EEPROM_SimTest_Pattern(uint8_t* pBuf, uint32_t uwLen, uint32_t uwSeed)
+//==================================================================================
+{
+	for(uint32_t i = 0; i < uwLen; i++){
+		uwSeed = uwSeed * 1103515245 + 12345;
+		pBuf[i] = (uint8_t)(uwSeed >> 16);
+	}
+}
+
+// Config layouts of the migration test. v1: Baud / 100 (u16), Mode, pad, Name[16].
+// v2: Baud (u32), Mode, Volume, pad (u16), Name[16]. v3: Timeout (u16) in place
+// of the pad and Log[48] appended. Images are header and body as stored, the
+// trailing zeros of the v3 ones are left to the initializer.
+#define SIMTEST_CFG_ADDR 								 (uint32_t)0x110 	// mid page, a v3 block spans three pages
+#define SIMTEST_CFG_V3_LEN 							 (uint16_t)72
+
+static const uint8_t ucSimTestCfgV1[28] = {
+	0xF6, 0xC0, 0x01, 0x00, 0x14, 0x00, 0x83, 0xBB, 0x80, 0x04, 0x02, 0x00,
+	0x70, 0x75, 0x6D, 0x70, 0x2D, 0x37,
+};
+static const uint8_t ucSimTestCfgV2[32] = {
+	0xF6, 0xC0, 0x02, 0x00, 0x18, 0x00, 0x1A, 0x1A, 0x00, 0xE1, 0x00, 0x00,
+	0x01, 0x09, 0x00, 0x00, 0x66, 0x61, 0x6E, 0x2D, 0x33,
+};
+static const uint8_t ucSimTestCfgV3FromV1[EEP_CONFIG_HDR_SIZE + SIMTEST_CFG_V3_LEN] = {
+	0xF6, 0xC0, 0x03, 0x00, 0x48, 0x00, 0x1F, 0x57, 0x00, 0xC2, 0x01, 0x00,
+	0x02, 0x05, 0xE8, 0x03, 0x70, 0x75, 0x6D, 0x70, 0x2D, 0x37,
+};
+static const uint8_t ucSimTestCfgV3FromV2[EEP_CONFIG_HDR_SIZE + SIMTEST_CFG_V3_LEN] = {
+	0xF6, 0xC0, 0x03, 0x00, 0x48, 0x00, 0xD1, 0x43, 0x00, 0xE1, 0x00, 0x00,
+	0x01, 0x09, 0xE8, 0x03, 0x66, 0x61, 0x6E, 0x2D, 0x33,
+};
+static const uint8_t ucSimTestCfgV4[EEP_CONFIG_HDR_SIZE + SIMTEST_CFG_V3_LEN] = {
+	0xF6, 0xC0, 0x04, 0x00, 0x48, 0x00, 0x49, 0x17, 0x00, 0x84, 0x03, 0x00,
+	0x03, 0x07, 0xF4, 0x01, 0x6E, 0x65, 0x78, 0x74, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x02, 0x03,
+	0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F,
+	0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1A, 0x1B,
+	0x1C, 0x1D, 0x1E, 0x1F, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27,
+	0x28, 0x29, 0x2A, 0x2B, 0x2C, 0x2D, 0x2E, 0x2F,
+};
+
+/**
+  * @brief  default AT25160 handle on the fastest clock, in front of an erased model
+	* @retval none
+  */
+//==============================================
+static void EEPROM_SimTest_Setup(void)
+//==============================================
+{
+	hEeprom = hSimTestDevice;
+	pEeprom = &hEeprom;
+
+	EEPROM_SPI_Init();
+	EEPROM_SPI_SetClock(0);
+	EEPROM_Sim_Init(pEeprom->Capacity, pEeprom->PageSize, pEeprom->AddrBytes);
+}
+
+/**
+  * @brief  replaces the model with one chip per device handle on the shared bus
+  * @param  pDevices: filled with the handles, pDevices[0] is selected
+  * @param  ucCount: number of chips, up to EEP_MAX_DEVICES
+	* @retval none
+  */
+//==============================================================================
+static void EEPROM_SimTest_Bus(EEP_DeviceTypeDef* pDevices[], uint8_t ucCount)
+//==============================================================================
+{
+	EEPROM_Sim_Reset();
+	for(uint8_t d = 0; d < ucCount; d++)
+	{
+		hSimTestBus[d] = hSimTestChip[d];
+		hSimTestBus[d].ClkStep = 0;
+		pDevices[d] = &hSimTestBus[d];
+		EEPROM_Sim_AddChip(pDevices[d]->CsPin, pDevices[d]->Capacity, pDevices[d]->PageSize, pDevices[d]->AddrBytes);
+	}
+	pEeprom = pDevices[0];
+}
+
+/**
+  * @brief  chunk planner over every start offset and length up to three pages
+  *         past it, for 8 to 256 byte pages: the chunks tile the access, stay
+  *         inside a page and end on a page boundary unless they are the last
+  *         one. A page crossing write at every offset then lands right on a
+  *         model with that page size
+	* @retval number of failed conditions
+  */
+//==============================================
+static uint32_t EEPROM_SimTest_Planner(void)
+//==============================================
+{
+	uint32_t uwFails = 0, uwPlanFails = 0, uwWrites, uwBase;
+	EEP_ChunkPlanTypeDef plan;
+	uint8_t ucData[EEP_SIM_PAGE_MAX + 1];
+
+	for(uint16_t uiPage = 8; uiPage <= EEP_SIM_PAGE_MAX; uiPage <<= 1)
+	{
+		for(uint32_t uwAddr = 0; uwAddr < 4 * (uint32_t)uiPage; uwAddr++)
+		{
+			for(uint32_t uwLen = 0; uwLen <= 3 * (uint32_t)uiPage + 1; uwLen++)
+			{
+				uint32_t uwChunks = 0, uwExpected = (uwLen == 0) ? 0 : ((uwAddr + uwLen - 1) / uiPage - uwAddr / uiPage + 1);
+				uint8_t ucOk = 1;
+
+				EEPROM_SPI_PlanInit(&plan, uwAddr, uwLen, uiPage);
+				while(EEPROM_SPI_PlanNext(&plan))
+				{
+					uwChunks++;
+					if((plan.Len == 0) || (plan.Addr != uwAddr + plan.Offset)) ucOk = 0;
+					if(plan.Addr / uiPage != (plan.Addr + plan.Len - 1) / uiPage) ucOk = 0;
+					if((plan.Remain > 0) && ((plan.Addr + plan.Len) % uiPage != 0)) ucOk = 0;
+					if((uwChunks > 1) && (plan.Addr % uiPage != 0)) ucOk = 0;
+					if(plan.Offset + plan.Len + plan.Remain != uwLen) ucOk = 0;
+					if(uwChunks > uwExpected) break;
+				}
+				if((uwChunks != uwExpected) || (plan.Len != 0) || (plan.Offset != uwLen) || EEPROM_SPI_PlanNext(&plan)) ucOk = 0;
+
+				if(!ucOk && (uwPlanFails++ == 0)){
+					EEP_LOG("  page %u, address %lu, length %lu\r\n", uiPage, (unsigned long)uwAddr, (unsigned long)uwLen);
+				}
+			}
+		}
+
+		hEeprom.PageSize = uiPage;
+		EEPROM_Sim_Init(pEeprom->Capacity, uiPage, pEeprom->AddrBytes);
+		for(uint16_t uiOffset = 0; uiOffset < uiPage; uiOffset++)
+		{
+			uwBase = (uint32_t)(uiOffset % 4) * uiPage + uiOffset;
+			EEPROM_SimTest_Pattern(ucData, uiPage + 1, uiPage + uiOffset);
+			uwWrites = hEepSim[0].Writes;
+			SIMTEST_CHECK(BSP_EEPROM_Write(uwBase, ucData, uiPage + 1) == HAL_OK);
+			SIMTEST_CHECK(EEPROM_SPI_WaitReady() == HAL_OK);
+			SIMTEST_CHECK(hEepSim[0].Writes - uwWrites == 2);
+			SIMTEST_CHECK(memcmp(&hEepSim[0].Mem[uwBase], ucData, uiPage + 1) == 0);
+		}
+	}
+	SIMTEST_CHECK(uwPlanFails == 0);
+
+	return uwFails;
+}
+
+/**
+  * @brief  range fill on the default part and on a 256 byte page model: only
+  *         the pages, or EEP_FILL_PAGE_MAX pieces of the large ones, that do
+  *         not hold the pattern yet are programmed, and a second fill writes
+  *         nothing
+	* @retval number of failed conditions
+  */
+//==============================================
+static uint32_t EEPROM_SimTest_Fill(void)
+//==============================================
+{
+	uint32_t uwFails = 0, uwWrites, uwCap = pEeprom->Capacity;
+	uint32_t uwPieces = (uwCap / pEeprom->PageSize) * ((pEeprom->PageSize + EEP_FILL_PAGE_MAX - 1) / EEP_FILL_PAGE_MAX);
+
+	uwWrites = hEepSim[0].Writes;
+	SIMTEST_CHECK(BSP_EEPROM_Fill(0, uwCap, 0x00) == HAL_OK);
+	SIMTEST_CHECK(hEepSim[0].Writes - uwWrites == uwPieces);
+	for(uint32_t i = 0; i < uwCap; i++) SIMTEST_CHECK(hEepSim[0].Mem[i] == 0x00);
+
+	hEeprom.PageSize = 256;
+	EEPROM_Sim_Init(uwCap, hEeprom.PageSize, hEeprom.AddrBytes);
+
+	// one dirty piece in page 0, 1 and 3 of an erased part
+	hEepSim[0].Mem[5] = 0x00;
+	hEepSim[0].Mem[300] = 0x00;
+	hEepSim[0].Mem[1000] = 0x00;
+	uwWrites = hEepSim[0].Writes;
+	SIMTEST_CHECK(BSP_EEPROM_Fill(0, uwCap, 0xFF) == HAL_OK);
+	SIMTEST_CHECK(hEepSim[0].Writes - uwWrites == 3);
+	for(uint32_t i = 0; i < uwCap; i++) SIMTEST_CHECK(hEepSim[0].Mem[i] == 0xFF);
+
+	// 100..799 touches 3 + 4 + 4 + 1 pieces, the bytes around it stay erased
+	uwWrites = hEepSim[0].Writes;
+	SIMTEST_CHECK(BSP_EEPROM_Fill(100, 700, 0xA5) == HAL_OK);
+	SIMTEST_CHECK(hEepSim[0].Writes - uwWrites == 12);
+	for(uint32_t i = 0; i < uwCap; i++) SIMTEST_CHECK(hEepSim[0].Mem[i] == ((i >= 100 && i < 800) ? 0xA5 : 0xFF));
+	SIMTEST_CHECK(hEepSim[0].EmptyWrites == 0 && hEepSim[0].WrapWrites == 0);
+
+	uwWrites = hEepSim[0].Writes;
+	SIMTEST_CHECK(BSP_EEPROM_Fill(100, 700, 0xA5) == HAL_OK);
+	SIMTEST_CHECK(hEepSim[0].Writes == uwWrites);
+
+	return uwFails;
+}
+
+/**
+  * @brief  v1 -> v2 of the test layout: baud in full, Volume 5 added
+  * @param  pBody: body, converted in place
+  * @param  puiLength: body length
+	* @retval HAL_StatusTypeDef enum, HAL_OK in case of successful operation
+  */
+//==================================================================================
+static HAL_StatusTypeDef EEPROM_SimTest_CfgV1(uint8_t* pBody, uint16_t* puiLength)
+//==================================================================================
+{
+	uint32_t uwBaud = ((uint32_t)pBody[0] | ((uint32_t)pBody[1] << 8)) * 100;
+	uint8_t ucMode = pBody[2];
+
+	if(*puiLength != 20) return HAL_ERROR;
+
+	memmove(&pBody[8], &pBody[4], 16);
+	for(uint8_t i = 0; i < 4; i++) pBody[i] = (uint8_t)(uwBaud >> (8 * i));
+	pBody[4] = ucMode;
+	pBody[5] = 5;
+	pBody[6] = pBody[7] = 0;
+	*puiLength = 24;
+
+	return HAL_OK;
+}
+
+/**
+  * @brief  v2 -> v3 of the test layout: Timeout 1000 in the pad, empty log added
+  * @param  pBody: body, converted in place
+  * @param  puiLength: body length
+	* @retval HAL_StatusTypeDef enum, HAL_OK in case of successful operation
+  */
+//==================================================================================
+static HAL_StatusTypeDef EEPROM_SimTest_CfgV2(uint8_t* pBody, uint16_t* puiLength)
+//==================================================================================
+{
+	if(*puiLength != 24) return HAL_ERROR;
+
+	pBody[6] = (uint8_t)1000;
+	pBody[7] = (uint8_t)(1000 >> 8);
+	memset(&pBody[24], 0, SIMTEST_CFG_V3_LEN - 24);
+	*puiLength = SIMTEST_CFG_V3_LEN;
+
+	return HAL_OK;
+}
+
+/**
+  * @brief  blank v3 body of the test layout
+  * @param  pBody: body to fill
+	* @retval none
+  */
+//======================================================
+static void EEPROM_SimTest_CfgDefaults(uint8_t* pBody)
+//======================================================
+{
+	pBody[0] = (uint8_t)9600;
+	pBody[1] = (uint8_t)(9600 >> 8);
+	pBody[5] = 5;
+	pBody[6] = (uint8_t)1000;
+	pBody[7] = (uint8_t)(1000 >> 8);
+	memcpy(&pBody[8], "unnamed", 7);
+}
+
+static const EEP_ConfigMigrateFn fSimTestCfgMigrations[] = { EEPROM_SimTest_CfgV1, EEPROM_SimTest_CfgV2 };
+static const EEP_ConfigSchemaTypeDef xSimTestCfgSchema = {
+	.Address = SIMTEST_CFG_ADDR,
+	.Version = 3,
+	.Length = SIMTEST_CFG_V3_LEN,
+	.Defaults = EEPROM_SimTest_CfgDefaults,
+	.pMigrations = fSimTestCfgMigrations,
+	.FirstVersion = 1,
+};
+
+/**
+  * @brief  places a stored config image on the model, the rest of it erased
+  * @param  pImage: header and body as stored
+  * @param  uwLen: image bytes
+	* @retval none
+  */
+//==========================================================================
+static void EEPROM_SimTest_CfgStore(const uint8_t* pImage, uint32_t uwLen)
+//==========================================================================
+{
+	memset(hEepSim[0].Mem, 0xFF, hEepSim[0].Capacity);
+	memcpy(&hEepSim[0].Mem[SIMTEST_CFG_ADDR], pImage, uwLen);
+}
+
+/**
+  * @brief  golden images of every stored layout: v1 and v2 blocks are upgraded
+  *         to the expected v3 bytes, in RAM and through boot on the model, and
+  *         later commits program only the pages that changed. A v3 block is
+  *         loaded without a write, a v4 one is left alone, a corrupted one is
+  *         replaced by the defaults
+	* @retval number of failed conditions
+  */
+//==============================================
+static uint32_t EEPROM_SimTest_Config(void)
+//==============================================
+{
+	uint32_t uwFails = 0, uwWrites;
+	const uint8_t* pGolden[2][2] = { { ucSimTestCfgV1, ucSimTestCfgV3FromV1 }, { ucSimTestCfgV2, ucSimTestCfgV3FromV2 } };
+	const uint32_t uwGoldenLen[2] = { sizeof(ucSimTestCfgV1), sizeof(ucSimTestCfgV2) };
+	EEP_ConfigImageTypeDef image;
+	EEP_ConfigOriginTypeDef origin;
+	uint8_t ucExpected[EEP_CONFIG_HDR_SIZE + SIMTEST_CFG_V3_LEN];
+
+	for(uint8_t g = 0; g < 2; g++)
+	{
+		// migration chain alone, no bus
+		memset(&image, 0xFF, sizeof(image));
+		memcpy(&image, pGolden[g][0], uwGoldenLen[g]);
+		SIMTEST_CHECK(BSP_EEPROM_Config_Upgrade(&xSimTestCfgSchema, &image, &origin) == HAL_OK);
+		SIMTEST_CHECK(origin == EEP_CONFIG_MIGRATED);
+		SIMTEST_CHECK(memcmp(&image, pGolden[g][1], sizeof(ucExpected)) == 0);
+
+		// boot on a part holding the old block
+		EEPROM_SimTest_CfgStore(pGolden[g][0], uwGoldenLen[g]);
+		SIMTEST_CHECK(BSP_EEPROM_Config_Init(&xSimTestCfgSchema) == HAL_OK);
+		SIMTEST_CHECK(EEPROM_SPI_WaitReady() == HAL_OK);
+		SIMTEST_CHECK(hEepConfig.Origin == EEP_CONFIG_MIGRATED);
+		SIMTEST_CHECK(hEepConfig.PagesWritten == 3);
+		SIMTEST_CHECK(memcmp(&hEepSim[0].Mem[SIMTEST_CFG_ADDR], pGolden[g][1], sizeof(ucExpected)) == 0);
+	}
+
+	// current block: loaded, nothing written
+	uwWrites = hEepSim[0].Writes;
+	SIMTEST_CHECK(BSP_EEPROM_Config_Init(&xSimTestCfgSchema) == HAL_OK);
+	SIMTEST_CHECK(hEepConfig.Origin == EEP_CONFIG_LOADED);
+	SIMTEST_CHECK(hEepSim[0].Writes == uwWrites);
+
+	// a change in the last page programs that page and the one with the CRC
+	EEP_CONFIG_BODY(uint8_t)[SIMTEST_CFG_V3_LEN - 1] = 0x5A;
+	SIMTEST_CHECK(BSP_EEPROM_Config_Commit() == HAL_OK);
+	SIMTEST_CHECK(EEPROM_SPI_WaitReady() == HAL_OK);
+	SIMTEST_CHECK(hEepConfig.PagesWritten == 2);
+	SIMTEST_CHECK(hEepSim[0].Writes == uwWrites + 2);
+	SIMTEST_CHECK(memcmp(&hEepSim[0].Mem[SIMTEST_CFG_ADDR], &hEepConfig.Shadow, sizeof(ucExpected)) == 0);
+	SIMTEST_CHECK(BSP_EEPROM_Config_Init(&xSimTestCfgSchema) == HAL_OK);
+	SIMTEST_CHECK(hEepConfig.Origin == EEP_CONFIG_LOADED);
+
+	// block of a newer firmware: defaults in RAM, the part keeps the block
+	EEPROM_SimTest_CfgStore(ucSimTestCfgV4, sizeof(ucSimTestCfgV4));
+	uwWrites = hEepSim[0].Writes;
+	SIMTEST_CHECK(BSP_EEPROM_Config_Init(&xSimTestCfgSchema) == HAL_OK);
+	SIMTEST_CHECK(hEepConfig.Origin == EEP_CONFIG_NEWER);
+	SIMTEST_CHECK(BSP_EEPROM_Config_Commit() == HAL_ERROR);
+	SIMTEST_CHECK(hEepSim[0].Writes == uwWrites);
+	SIMTEST_CHECK(memcmp(&hEepSim[0].Mem[SIMTEST_CFG_ADDR], ucSimTestCfgV4, sizeof(ucSimTestCfgV4)) == 0);
+
+	// corrupted body: defaults written
+	EEPROM_SimTest_CfgStore(ucSimTestCfgV2, sizeof(ucSimTestCfgV2));
+	hEepSim[0].Mem[SIMTEST_CFG_ADDR + EEP_CONFIG_HDR_SIZE + 3] ^= 0x01;
+	SIMTEST_CHECK(BSP_EEPROM_Config_Init(&xSimTestCfgSchema) == HAL_OK);
+	SIMTEST_CHECK(EEPROM_SPI_WaitReady() == HAL_OK);
+	SIMTEST_CHECK(hEepConfig.Origin == EEP_CONFIG_DEFAULTED);
+	memset(ucExpected, 0, sizeof(ucExpected));
+	EEPROM_SimTest_CfgDefaults(&ucExpected[EEP_CONFIG_HDR_SIZE]);
+	SIMTEST_CHECK(memcmp(&hEepSim[0].Mem[SIMTEST_CFG_ADDR + EEP_CONFIG_HDR_SIZE], &ucExpected[EEP_CONFIG_HDR_SIZE], SIMTEST_CFG_V3_LEN) == 0);
+	SIMTEST_CHECK(hEepSim[0].Mem[SIMTEST_CFG_ADDR + 2] == 3);
+
+	return uwFails;
+}
+
+#ifdef BSP_EEPROM_FLASH_VIRTUAL
+/**
+  * @brief  flash emulation on the RAM pages: a blank flash is formatted, empty
+  *         and out of range accesses are refused, enough updates to swap pages
+  *         several times keep every byte, and a restart replays the same
+  *         content, also from a swap cut before the VALID mark or in the copy
+	* @retval number of failed conditions
+  */
+//==============================================
+static uint32_t EEPROM_SimTest_Flash(void)
+//==============================================
+{
+	uint32_t uwFails = 0, uwRecords;
+	uint8_t ucData[EEP_FLASH_CAPACITY], ucBack[EEP_FLASH_CAPACITY];
+	uint32_t uwActive;
+
+	memset(ucEepFlashSim, 0xFF, sizeof(ucEepFlashSim));
+	SIMTEST_CHECK(BSP_EEPROM_Flash_Init() == HAL_OK);
+	SIMTEST_CHECK(hEepFlash.ActivePage == EEP_FLASH_PAGE0);
+	SIMTEST_CHECK(*(uint16_t*)&ucEepFlashSim[0] == EEP_FLASH_PAGE_VALID);
+
+	SIMTEST_CHECK(BSP_EEPROM_Flash_Write(0, ucData, 0) == HAL_ERROR);
+	SIMTEST_CHECK(BSP_EEPROM_Flash_Read(0, ucBack, 0) == HAL_ERROR);
+	SIMTEST_CHECK(BSP_EEPROM_Flash_Write(EEP_FLASH_CAPACITY - 1, ucData, 2) == HAL_ERROR);
+	SIMTEST_CHECK(BSP_EEPROM_Flash_Read(EEP_FLASH_CAPACITY, ucBack, 1) == HAL_ERROR);
+	SIMTEST_CHECK(BSP_EEPROM_Flash_Write(0, NULL, 1) == HAL_ERROR);
+
+	// every round changes all bytes, 255 records a page force a swap every other round
+	for(uint32_t r = 0; r < 10; r++)
+	{
+		for(uint32_t i = 0; i < EEP_FLASH_CAPACITY; i++) ucData[i] = (uint8_t)(r * 3 + i);
+		SIMTEST_CHECK(BSP_EEPROM_Flash_Write(0, ucData, EEP_FLASH_CAPACITY) == HAL_OK);
+		SIMTEST_CHECK(BSP_EEPROM_Flash_Read(0, ucBack, EEP_FLASH_CAPACITY) == HAL_OK);
+		SIMTEST_CHECK(memcmp(ucData, ucBack, EEP_FLASH_CAPACITY) == 0);
+	}
+	SIMTEST_CHECK(hEepFlash.Swaps >= 4);
+
+	// unchanged bytes cost no record
+	uwRecords = hEepFlash.Records;
+	SIMTEST_CHECK(BSP_EEPROM_Flash_Write(0, ucData, EEP_FLASH_CAPACITY) == HAL_OK);
+	SIMTEST_CHECK(hEepFlash.Records == uwRecords);
+
+	// restart: the log replays to the same content
+	uwActive = hEepFlash.ActivePage;
+	SIMTEST_CHECK(BSP_EEPROM_Flash_Init() == HAL_OK);
+	SIMTEST_CHECK(hEepFlash.ActivePage == uwActive);
+	SIMTEST_CHECK(BSP_EEPROM_Flash_Read(0, ucBack, EEP_FLASH_CAPACITY) == HAL_OK);
+	SIMTEST_CHECK(memcmp(ucData, ucBack, EEP_FLASH_CAPACITY) == 0);
+
+	// copy complete, old page erased, VALID mark missing
+	*(uint16_t*)&ucEepFlashSim[uwActive - EEP_FLASH_PAGE0] = EEP_FLASH_PAGE_RECEIVING;
+	SIMTEST_CHECK(BSP_EEPROM_Flash_Init() == HAL_OK);
+	SIMTEST_CHECK(hEepFlash.ActivePage == uwActive);
+	SIMTEST_CHECK(*(uint16_t*)&ucEepFlashSim[uwActive - EEP_FLASH_PAGE0] == EEP_FLASH_PAGE_VALID);
+	SIMTEST_CHECK(BSP_EEPROM_Flash_Read(0, ucBack, EEP_FLASH_CAPACITY) == HAL_OK);
+	SIMTEST_CHECK(memcmp(ucData, ucBack, EEP_FLASH_CAPACITY) == 0);
+
+	// copy cut short: the VALID page stays the source, the partial one is erased
+	uwActive = (uwActive == EEP_FLASH_PAGE0) ? EEP_FLASH_PAGE1 : EEP_FLASH_PAGE0;
+	*(uint16_t*)&ucEepFlashSim[uwActive - EEP_FLASH_PAGE0] = EEP_FLASH_PAGE_RECEIVING;
+	*(uint16_t*)&ucEepFlashSim[uwActive - EEP_FLASH_PAGE0 + EEP_FLASH_RECORD_SIZE] = 0;
+	SIMTEST_CHECK(BSP_EEPROM_Flash_Init() == HAL_OK);
+	SIMTEST_CHECK(hEepFlash.ActivePage != uwActive);
+	SIMTEST_CHECK(*(uint16_t*)&ucEepFlashSim[uwActive - EEP_FLASH_PAGE0] == EEP_FLASH_PAGE_ERASED);
+	SIMTEST_CHECK(BSP_EEPROM_Flash_Read(0, ucBack, EEP_FLASH_CAPACITY) == HAL_OK);
+	SIMTEST_CHECK(memcmp(ucData, ucBack, EEP_FLASH_CAPACITY) == 0);
+
+	return uwFails;
+}
+#endif
+
+/**
+  * @brief  write cycle wait: from an untrained estimator both wait modes learn
+  *         the tWC of the model and write a page in little more than that
+	* @retval number of failed conditions
+  */
+//==============================================
+static uint32_t EEPROM_SimTest_WaitMode(void)
+//==============================================
+{
+	uint32_t uwFails = 0, uwStart, uwTime;
+	uint8_t ucPage[EEP_SPI_PAGESIZE];
+
+	memset(ucPage, 0x5A, sizeof(ucPage));
+
+	for(uint8_t ucMode = EEP_WAIT_POLL; ucMode <= EEP_WAIT_SLEEP; ucMode++)
+	{
+		pEeprom->TwcEstUs = hSimTestDevice.TwcEstUs;
+		pEeprom->TwcDevUs = hSimTestDevice.TwcDevUs;
+		pEeprom->WaitMode = (EEP_WaitModeTypeDef)ucMode;
+
+		// training, then one timed pass
+		for(uint16_t i = 0; i < 2 * EEP_BENCH_PAGES; i++){
+			SIMTEST_CHECK(EEPROM_SPI_WritePage(ucPage, (i % EEP_BENCH_PAGES) * pEeprom->PageSize, pEeprom->PageSize) == HAL_OK);
+		}
+		SIMTEST_CHECK(EEPROM_SPI_WaitReady() == HAL_OK);
+		uwStart = BSP_GetMicros();
+		for(uint16_t i = 0; i < EEP_BENCH_PAGES; i++){
+			SIMTEST_CHECK(EEPROM_SPI_WritePage(ucPage, i * pEeprom->PageSize, pEeprom->PageSize) == HAL_OK);
+		}
+		SIMTEST_CHECK(EEPROM_SPI_WaitReady() == HAL_OK);
+		uwTime = (BSP_GetMicros() - uwStart) / EEP_BENCH_PAGES;
+
+		EEP_LOG("  %s: %lu us/page, tWC est %lu us\r\n", (ucMode == EEP_WAIT_SLEEP) ? "sleep" : "poll ",
+						(unsigned long)uwTime, (unsigned long)pEeprom->TwcEstUs);
+		SIMTEST_CHECK(pEeprom->TwcEstUs < hEepSim[0].Faults.TwcUs + 200);
+		SIMTEST_CHECK(uwTime < hEepSim[0].Faults.TwcUs * 21 / 20);
+	}
+
+	SIMTEST_CHECK(EEPROM_SPI_BenchmarkTest() == HAL_OK);
+
+	return uwFails;
+}
+
+/**
+  * @brief  clock calibration only reads: a blank part keeps the slowest clock,
+  *         user data (the last page included) is left as it was
+	* @retval number of failed conditions
+  */
+//==============================================
+static uint32_t EEPROM_SimTest_Calibrate(void)
+//==============================================
+{
+	uint32_t uwFails = 0, uwWrites;
+	uint8_t ucData[EEP_SPI_PAGESIZE * 4];
+
+	uwWrites = hEepSim[0].Writes;
+	SIMTEST_CHECK(EEPROM_SPI_CalibrateClock() == HAL_OK);
+	SIMTEST_CHECK(pEeprom->ClkStep == EEP_CLK_STEPS - 1);
+	SIMTEST_CHECK(hEepSim[0].Writes == uwWrites);
+
+	EEPROM_SimTest_Pattern(ucData, sizeof(ucData), 29);
+	SIMTEST_CHECK(BSP_EEPROM_Write(0, ucData, sizeof(ucData)) == HAL_OK);
+	SIMTEST_CHECK(BSP_EEPROM_Write(pEeprom->Capacity - pEeprom->PageSize, ucData, pEeprom->PageSize) == HAL_OK);
+	SIMTEST_CHECK(EEPROM_SPI_WaitReady() == HAL_OK);
+	memcpy(ucSimTestImage, hEepSim[0].Mem, hEepSim[0].Capacity);
+
+	uwWrites = hEepSim[0].Writes;
+	SIMTEST_CHECK(EEPROM_SPI_CalibrateClock() == HAL_OK);
+	SIMTEST_CHECK(pEeprom->ClkStep == EEP_CAL_MARGIN_STEPS);
+	SIMTEST_CHECK(hEepSim[0].Writes == uwWrites);
+	SIMTEST_CHECK(memcmp(ucSimTestImage, hEepSim[0].Mem, hEepSim[0].Capacity) == 0);
+
+	return uwFails;
+}
+
+/**
+  * @brief  size detection by reads only: a smaller part is found by its wrap, a
+  *         larger one holding a block twice at a power of two apart is not
+  *         mistaken for it, a blank part or one with only such a copy is left
+  *         uncertain with the configured size. Nothing is written, and the
+  *         selected device is restored, also when no chip answers
+	* @retval number of failed conditions
+  */
+//==============================================
+static uint32_t EEPROM_SimTest_Detect(void)
+//==============================================
+{
+	uint32_t uwFails = 0, uwWrites, uwStart;
+	EEP_DeviceTypeDef hDetect;
+	uint8_t ucBlock[64];
+
+	EEPROM_SimTest_Pattern(ucBlock, sizeof(ucBlock), 42);
+
+	// 25xx080 behind a handle configured for 2 KB
+	hDetect = hSimTestChip[1];
+	EEPROM_Sim_Init(1024, 32, 2);
+	EEPROM_SimTest_Pattern(hEepSim[0].Mem, 1024, 44);
+	uwWrites = hEepSim[0].Writes;
+	uwStart = BSP_GetMicros();
+	SIMTEST_CHECK(BSP_EEPROM_Detect(&hDetect) == HAL_OK);
+	SIMTEST_CHECK(BSP_GetMicros() - uwStart < 1000);
+	SIMTEST_CHECK(hDetect.Capacity == 1024);
+	SIMTEST_CHECK(hEepSim[0].Writes == uwWrites);
+	SIMTEST_CHECK(pEeprom == &hEeprom);
+
+	// 25xx320 with data and an A/B copy 1 KB apart, the other windows differ
+	hDetect = hSimTestChip[1];
+	EEPROM_Sim_Init(4096, 32, 2);
+	EEPROM_SimTest_Pattern(hEepSim[0].Mem, 4096, 45);
+	memcpy(&hEepSim[0].Mem[0], ucBlock, sizeof(ucBlock));
+	memcpy(&hEepSim[0].Mem[1024], ucBlock, sizeof(ucBlock));
+	uwWrites = hEepSim[0].Writes;
+	SIMTEST_CHECK(BSP_EEPROM_Detect(&hDetect) == HAL_OK);
+	SIMTEST_CHECK(hDetect.Capacity == 4096);
+	SIMTEST_CHECK(hDetect.PageSize == 32);
+	SIMTEST_CHECK(hEepSim[0].Writes == uwWrites);
+
+	// only the A/B copy on a blank 25xx320: reads cannot tell, configured size kept
+	hDetect = hSimTestChip[1];
+	EEPROM_Sim_Init(4096, 32, 2);
+	memcpy(&hEepSim[0].Mem[0], ucBlock, sizeof(ucBlock));
+	memcpy(&hEepSim[0].Mem[1024], ucBlock, sizeof(ucBlock));
+	SIMTEST_CHECK(BSP_EEPROM_Detect(&hDetect) == HAL_OK);
+	SIMTEST_CHECK(hDetect.Capacity == hSimTestChip[1].Capacity);
+
+	// blank part: configured size kept, nothing written
+	hDetect = hSimTestChip[1];
+	EEPROM_Sim_Init(4096, 32, 2);
+	uwWrites = hEepSim[0].Writes;
+	SIMTEST_CHECK(BSP_EEPROM_Detect(&hDetect) == HAL_OK);
+	SIMTEST_CHECK(hDetect.Capacity == hSimTestChip[1].Capacity);
+	SIMTEST_CHECK(hEepSim[0].Writes == uwWrites);
+
+	// nothing on that chip select: fails, the selection is restored
+	EEPROM_Sim_Reset();
+	EEPROM_Sim_AddChip(hSimTestChip[0].CsPin, 4096, 32, 2);
+	SIMTEST_CHECK(BSP_EEPROM_Detect(&hDetect) != HAL_OK);
+	SIMTEST_CHECK(pEeprom == &hEeprom);
+
+	return uwFails;
+}
+
+/**
+  * @brief  memory diagnostics over the whole part: a clean part passes, a cell
+  *         disturbed by writes to another block and a stuck bit are found, and
+  *         the data is left as it was, the disturbed cell included
+	* @retval number of failed conditions
+  */
+//==============================================
+static uint32_t EEPROM_SimTest_Diag(void)
+//==============================================
+{
+	uint32_t uwFails = 0;
+	uint8_t ucFound = 0;
+	EEP_DiagReportTypeDef xReport;
+
+	EEPROM_SimTest_Pattern(hEepSim[0].Mem, pEeprom->Capacity, 43);
+	memcpy(ucSimTestImage, hEepSim[0].Mem, pEeprom->Capacity);
+	SIMTEST_CHECK(BSP_EEPROM_Diag_Run(0, pEeprom->Capacity, &xReport) == HAL_OK);
+	SIMTEST_CHECK(xReport.Errors == 0);
+	SIMTEST_CHECK(memcmp(ucSimTestImage, hEepSim[0].Mem, pEeprom->Capacity) == 0);
+
+	// writes to byte 200 copy bit 6 into byte 1500, five blocks further; they differ on entry
+	hEepSim[0].Mem[200] |= 0x40;
+	hEepSim[0].Mem[1500] &= (uint8_t)~0x40;
+	memcpy(ucSimTestImage, hEepSim[0].Mem, pEeprom->Capacity);
+	hEepSim[0].Faults.Coupling[0].Aggressor = 200;
+	hEepSim[0].Faults.Coupling[0].Victim = 1500;
+	hEepSim[0].Faults.Coupling[0].Mask = 0x40;
+	SIMTEST_CHECK(BSP_EEPROM_Diag_Run(0, pEeprom->Capacity, &xReport) == HAL_OK);
+	BSP_EEPROM_Diag_Print(&xReport);
+	SIMTEST_CHECK(xReport.Phase[EEP_DIAG_COUPLING].Errors != 0);
+	SIMTEST_CHECK(xReport.Phase[EEP_DIAG_COUPLING].Mask == 0x40);
+	for(uint8_t i = 0; (i < xReport.Errors) && (i < EEP_DIAG_MAX_FAILS); i++){
+		if(xReport.Fail[i].Addr == 1500 && xReport.Fail[i].Phase == EEP_DIAG_COUPLING) ucFound = 1;
+	}
+	SIMTEST_CHECK(ucFound);
+	SIMTEST_CHECK(memcmp(ucSimTestImage, hEepSim[0].Mem, pEeprom->Capacity) == 0);
+	hEepSim[0].Faults.Coupling[0].Mask = 0;
+
+	// bit 2 of byte 777 stuck at 1, already wrong in the coupling pass; its block is rebuilt to what it holds
+	hEepSim[0].Faults.Stuck[0].Addr = 777;
+	hEepSim[0].Faults.Stuck[0].Mask = 0x04;
+	hEepSim[0].Faults.Stuck[0].Value = 0x04;
+	SIMTEST_CHECK(BSP_EEPROM_Diag_Run(0, pEeprom->Capacity, &xReport) == HAL_OK);
+	SIMTEST_CHECK(xReport.Phase[EEP_DIAG_MARCH].Errors != 0);
+	SIMTEST_CHECK(xReport.Phase[EEP_DIAG_MARCH].Mask == 0x04);
+	SIMTEST_CHECK(xReport.Errors != 0 && xReport.Fail[0].Addr == 777 && xReport.Fail[0].Mask == 0x04);
+	SIMTEST_CHECK(memcmp(ucSimTestImage, hEepSim[0].Mem, pEeprom->Capacity) == 0);
+
+	return uwFails;
+}
+
+/**
+  * @brief  replays BSRR words into the bus model with IDR samples taken as
+  *         EEPROM_Wave_Start does: one before the first word, one after each
+  * @param  pWave: words from EEPROM_Wave_Build
+  * @param  uiWords: number of words
+  * @param  pSample: output, uiWords + 1 samples
+	* @retval none
+  */
+//==============================================================================================
+static void EEPROM_SimTest_WaveRun(const uint32_t* pWave, uint16_t uiWords, uint16_t* pSample)
+//==============================================================================================
+{
+	pSample[0] = EEPROM_Sim_GetSO() ? EEP_MISO_Pin : 0;
+	for(uint16_t i = 0; i < uiWords; i++)
+	{
+		if(pWave[i] & ((uint32_t)EEP_MOSI_Pin << 16)) EEPROM_Sim_SetPin(EEP_SIM_PIN_SI, 0);
+		if(pWave[i] & EEP_MOSI_Pin) EEPROM_Sim_SetPin(EEP_SIM_PIN_SI, 1);
+		if(pWave[i] & ((uint32_t)EEP_CLK_Pin << 16)) EEPROM_Sim_SetPin(EEP_SIM_PIN_CK, 0);
+		if(pWave[i] & EEP_CLK_Pin) EEPROM_Sim_SetPin(EEP_SIM_PIN_CK, 1);
+		pSample[i + 1] = EEPROM_Sim_GetSO() ? EEP_MISO_Pin : 0;
+	}
+}
+
+/**
+  * @brief  clocks one phase of a frame through EEPROM_Wave_Build, the model
+  *         and EEPROM_Wave_Pack
+  * @param  pTx: bytes to send, NULL for a read phase
+  * @param  pRx: received bytes, NULL to drop them
+  * @param  uiLen: number of bytes, up to EEP_WAVE_CHUNK
+	* @retval none
+  */
+//======================================================================================
+static void EEPROM_SimTest_WavePhase(const uint8_t* pTx, uint8_t* pRx, uint16_t uiLen)
+//======================================================================================
+{
+	static uint32_t uwWave[EEP_WAVE_WORDS];
+	static uint16_t uiSample[EEP_WAVE_SAMPLES];
+	uint16_t uiWords;
+
+	uiWords = EEPROM_Wave_Build(uwWave, pTx, uiLen);
+	EEPROM_SimTest_WaveRun(uwWave, uiWords, uiSample);
+	if(pRx != NULL) EEPROM_Wave_Pack(pRx, uiSample, uiLen);
+}
+
+/**
+  * @brief  bit-bang waveforms: the words have the SPI mode 0 shape, and READ,
+  *         WREN and WRITE frames built by EEPROM_Wave_Build and packed by
+  *         EEPROM_Wave_Pack round trip through the model
+	* @retval number of failed conditions
+  */
+//==============================================
+static uint32_t EEPROM_SimTest_Wave(void)
+//==============================================
+{
+	uint32_t uwFails = 0, uwWrites, uwWave[16];
+	uint8_t ucHead[4], ucData[EEP_WAVE_CHUNK], ucRx[EEP_WAVE_CHUNK], ucByte = 0xA5;
+	uint8_t ucHeadLen = 1 + pEeprom->AddrBytes;
+
+	// SCK low with the bit on MOSI, then SCK high; a read phase leaves MOSI alone
+	SIMTEST_CHECK(EEPROM_Wave_Build(uwWave, &ucByte, 1) == 16);
+	for(uint8_t b = 0; b < 8; b++){
+		SIMTEST_CHECK(uwWave[2 * b] == (((uint32_t)EEP_CLK_Pin << 16) |
+									((ucByte & (0x80 >> b)) ? (uint32_t)EEP_MOSI_Pin : (uint32_t)EEP_MOSI_Pin << 16)));
+		SIMTEST_CHECK(uwWave[2 * b + 1] == (uint32_t)EEP_CLK_Pin);
+	}
+	SIMTEST_CHECK(EEPROM_Wave_Build(uwWave, NULL, 1) == 16);
+	SIMTEST_CHECK(uwWave[0] == ((uint32_t)EEP_CLK_Pin << 16));
+
+	// READ at 0x123, header sent and data clocked in one chunk
+	EEPROM_SimTest_Pattern(&hEepSim[0].Mem[0x123], sizeof(ucData), 46);
+	ucHead[0] = CMD_READ;
+	for(uint8_t i = 0; i < pEeprom->AddrBytes; i++) ucHead[1 + i] = (uint8_t)(0x123 >> (8 * (pEeprom->AddrBytes - 1 - i)));
+	EEPROM_Sim_SetCs(pEeprom->CsPin, 0);
+	EEPROM_SimTest_WavePhase(ucHead, NULL, ucHeadLen);
+	EEPROM_SimTest_WavePhase(NULL, ucRx, sizeof(ucRx));
+	EEPROM_Sim_SetCs(pEeprom->CsPin, 1);
+	SIMTEST_CHECK(memcmp(ucRx, &hEepSim[0].Mem[0x123], sizeof(ucRx)) == 0);
+
+	// WREN, then WRITE of one chunk at 0x200, programmed when CS rises
+	EEPROM_SimTest_Pattern(ucData, sizeof(ucData), 47);
+	uwWrites = hEepSim[0].Writes;
+	ucHead[0] = CMD_WREN;
+	EEPROM_Sim_SetCs(pEeprom->CsPin, 0);
+	EEPROM_SimTest_WavePhase(ucHead, NULL, 1);
+	EEPROM_Sim_SetCs(pEeprom->CsPin, 1);
+	ucHead[0] = CMD_WRITE;
+	for(uint8_t i = 0; i < pEeprom->AddrBytes; i++) ucHead[1 + i] = (uint8_t)(0x200 >> (8 * (pEeprom->AddrBytes - 1 - i)));
+	EEPROM_Sim_SetCs(pEeprom->CsPin, 0);
+	EEPROM_SimTest_WavePhase(ucHead, NULL, ucHeadLen);
+	EEPROM_SimTest_WavePhase(ucData, NULL, sizeof(ucData));
+	EEPROM_Sim_SetCs(pEeprom->CsPin, 1);
+	SIMTEST_CHECK(hEepSim[0].Writes - uwWrites == 1);
+	SIMTEST_CHECK(memcmp(ucData, &hEepSim[0].Mem[0x200], sizeof(ucData)) == 0);
+
+	return uwFails;
+}
+
+// Seed corpus of EEPROM_Sim_Fuzz, one op per line: kind (bit 0 set = read),
+// address[3], length[2]. Addresses and lengths are taken modulo the range the
+// fuzzer uses, so each entry replays exactly on the default 2 KB / 32 B part.
+#define SIMTEST_FUZZ_RANDOM							 (uint32_t)64 		// seeded random inputs replayed after the corpus
+#define SIMTEST_FUZZ_RANDOM_OPS					 (uint32_t)32
+
+static const uint8_t ucSimTestFuzzCross[] = {
+	0x00, 0x00, 0x00, 0x1E, 0x00, 0x04,													// 4 bytes across the first page boundary
+	0x01, 0x00, 0x00, 0x1C, 0x00, 0x08,
+	0x02, 0x00, 0x00, 0x40, 0x00, 0x20,													// one aligned page, then rewritten
+	0x04, 0x00, 0x00, 0x40, 0x00, 0x20,
+	0x01, 0x00, 0x00, 0x40, 0x00, 0x20,
+};
+static const uint8_t ucSimTestFuzzLong[] = {
+	0x00, 0x00, 0x00, 0x00, 0x02, 0x00,													// the longest transfer, page aligned
+	0x00, 0x00, 0x00, 0x65, 0x01, 0xFF,													// and unaligned over the end of it
+	0x01, 0x00, 0x00, 0x00, 0x02, 0x00,
+	0x03, 0x00, 0x00, 0x64, 0x01, 0xFF,
+};
+static const uint8_t ucSimTestFuzzRange[] = {
+	0x00, 0x00, 0x07, 0xFF, 0x00, 0x01,													// last byte of the part
+	0x00, 0x00, 0x07, 0xFF, 0x00, 0x02,													// one past the end, refused
+	0x00, 0x00, 0x08, 0x02, 0x00, 0x01,													// start past the end, refused
+	0x00, 0x00, 0x00, 0x10, 0x00, 0x00,													// zero length, refused
+	0x01, 0x00, 0x08, 0x10, 0x00, 0x04,
+	0x01, 0x00, 0x07, 0xE0, 0x00, 0x20,
+	0x05, 0x00, 0x07, 0xF0,																			// trailing partial op, ignored
+};
+
+typedef struct
+{
+	const uint8_t* pData;
+	uint32_t Size;
+} EEP_SimTestFuzzTypeDef;
+
+static const EEP_SimTestFuzzTypeDef xSimTestFuzzCorpus[] = {
+	{ ucSimTestFuzzCross, sizeof(ucSimTestFuzzCross) },
+	{ ucSimTestFuzzLong, 	sizeof(ucSimTestFuzzLong) },
+	{ ucSimTestFuzzRange, sizeof(ucSimTestFuzzRange) },
+};
+
+/**
+  * @brief  replays the fuzz seed corpus and a set of seeded random inputs
+  *         through EEPROM_Sim_Fuzz, so the differential checks of the write
+  *         path run on every host build and not only under libFuzzer
+	* @retval number of failed conditions
+  */
+//==============================================
+static uint32_t EEPROM_SimTest_Fuzz(void)
+//==============================================
+{
+	uint32_t uwFails = 0;
+	uint8_t ucInput[SIMTEST_FUZZ_RANDOM_OPS * EEP_SIM_FUZZ_OP_BYTES];
+
+	for(uint32_t i = 0; i < sizeof(xSimTestFuzzCorpus) / sizeof(xSimTestFuzzCorpus[0]); i++){
+		SIMTEST_CHECK(EEPROM_Sim_Fuzz(xSimTestFuzzCorpus[i].pData, xSimTestFuzzCorpus[i].Size) == 0);
+	}
+
+	for(uint32_t s = 0; s < SIMTEST_FUZZ_RANDOM; s++)
+	{
+		EEPROM_SimTest_Pattern(ucInput, sizeof(ucInput), 0xF022 + s);
+		// short transfers in half of the inputs, so pages get rewritten in pieces
+		for(uint32_t i = 0; (s & 1) && (i < sizeof(ucInput)); i += EEP_SIM_FUZZ_OP_BYTES){
+			ucInput[i + 4] = 0;
+			ucInput[i + 5] &= 0x3F;
+		}
+		SIMTEST_CHECK(EEPROM_Sim_Fuzz(ucInput, sizeof(ucInput)) == 0);
+	}
+
+	return uwFails;
+}
+
+/**
+  * @brief  append writer benchmark: both passes read back right, and the model
+  *         sees one write cycle per record for the first and one per page for
+  *         the writer
+	* @retval number of failed conditions
+  */
+//==============================================
+static uint32_t EEPROM_SimTest_Append(void)
+//==============================================
+{
+	uint32_t uwFails = 0, uwWrites = hEepSim[0].Writes;
+	uint32_t uwLength = (uint32_t)EEP_BENCH_PAGES * pEeprom->PageSize;
+
+	if(uwLength > pEeprom->Capacity) uwLength = pEeprom->Capacity;
+
+	SIMTEST_CHECK(BSP_EEPROM_Append_BenchmarkTest() == HAL_OK);
+	SIMTEST_CHECK(hEepSim[0].Writes - uwWrites == uwLength / EEP_APPEND_BENCH_RECORD + uwLength / pEeprom->PageSize);
+
+	return uwFails;
+}
+
+/**
+  * @brief  interleaved writes on separate chip selects: every chip keeps its own
+  *         data and the write cycles of four chips overlap
+	* @retval number of failed conditions
+  */
+//===============================================
+static uint32_t EEPROM_SimTest_Interleave(void)
+//===============================================
+{
+	uint32_t uwFails = 0, uwStart, uwTime[2];
+	EEP_DeviceTypeDef* pDevices[EEP_MAX_DEVICES];
+	EEP_WriteJobTypeDef jobs[EEP_MAX_DEVICES];
+	uint8_t ucData[EEP_MAX_DEVICES][EEP_SPI_PAGESIZE];
+
+	EEPROM_SimTest_Bus(pDevices, EEP_MAX_DEVICES);
+	SIMTEST_CHECK(EEPROM_SPI_InterleaveTest(pDevices, EEP_MAX_DEVICES) == HAL_OK);
+	SIMTEST_CHECK(pEeprom == pDevices[0]);
+
+	// chip d took part in the passes with d + 1 and more chips
+	for(uint8_t d = 0; d < EEP_MAX_DEVICES; d++){
+		SIMTEST_CHECK(hEepSim[d].Writes == (uint32_t)EEP_BENCH_PAGES * (EEP_MAX_DEVICES - d));
+		SIMTEST_CHECK(hEepSim[d].EmptyWrites == 0 && hEepSim[d].WrapWrites == 0);
+	}
+
+	for(uint8_t d = 0; d < EEP_MAX_DEVICES; d++) EEPROM_SimTest_Pattern(ucData[d], EEP_SPI_PAGESIZE, d + 1);
+	for(uint8_t n = 1; n <= EEP_MAX_DEVICES; n += EEP_MAX_DEVICES - 1)
+	{
+		uwStart = BSP_GetMicros();
+		for(uint16_t i = 0; i < EEP_BENCH_PAGES; i++)
+		{
+			for(uint8_t d = 0; d < n; d++){
+				jobs[d].pDevice = pDevices[d];
+				jobs[d].pBuffer = ucData[d];
+				jobs[d].WriteAddr = (uint32_t)i * EEP_SPI_PAGESIZE;
+				jobs[d].NumByteToWrite = EEP_SPI_PAGESIZE;
+			}
+			SIMTEST_CHECK(EEPROM_SPI_MultiWrite(jobs, n) == HAL_OK);
+		}
+		for(uint8_t d = 0; d < n; d++){
+			SIMTEST_CHECK(EEPROM_SPI_Select(pDevices[d]) == HAL_OK);
+			SIMTEST_CHECK(EEPROM_SPI_WaitReady() == HAL_OK);
+		}
+		uwTime[n != 1] = BSP_GetMicros() - uwStart;
+	}
+
+	for(uint8_t d = 0; d < EEP_MAX_DEVICES; d++){
+		for(uint16_t i = 0; i < EEP_BENCH_PAGES; i++) SIMTEST_CHECK(memcmp(&hEepSim[d].Mem[i * EEP_SPI_PAGESIZE], ucData[d], EEP_SPI_PAGESIZE) == 0);
+	}
+	EEP_LOG("  %d pages: 1 chip %lu us, %d chips %lu us\r\n", EEP_BENCH_PAGES, (unsigned long)uwTime[0],
+					EEP_MAX_DEVICES, (unsigned long)uwTime[1]);
+	SIMTEST_CHECK(uwTime[1] < uwTime[0] + uwTime[0] / 2);
+
+	return uwFails;
+}
+
+#define SIMTEST_GANG_LANES							 EEP_SIM_MAX_CHIPS
+#define SIMTEST_GANG_ADDR								 (uint32_t)0x47 		// mid page, the range spans four pages
+#define SIMTEST_GANG_LEN								 (uint32_t)(3 * EEP_SPI_PAGESIZE + 5)
+#define SIMTEST_GANG_STUCK							 (uint32_t)10 			// byte of lane 1 with a stuck bit
+
+/**
+  * @brief  gang programming of four model chips from the BSRR word stream:
+  *         every lane gets its own data, lane 1 has a stuck bit and fails the
+  *         verify at that byte only, lane 3 hangs in its second write cycle
+  *         and is dropped while the other lanes carry on
+	* @retval number of failed conditions
+  */
+//==============================================
+static uint32_t EEPROM_SimTest_Gang(void)
+//==============================================
+{
+	uint32_t uwFails = 0, uwErrors = 0;
+	uint32_t uwPages = (SIMTEST_GANG_ADDR + SIMTEST_GANG_LEN - 1) / EEP_SPI_PAGESIZE - SIMTEST_GANG_ADDR / EEP_SPI_PAGESIZE + 1;
+	uint32_t uwFirst = EEP_SPI_PAGESIZE - SIMTEST_GANG_ADDR % EEP_SPI_PAGESIZE;
+	EEP_GangTypeDef gang = { .Device = EEP_DEVICE_INIT(GPIOA, GPIO_PIN_4), .Port = GPIOA, .SckPin = GPIO_PIN_5, .LaneCount = SIMTEST_GANG_LANES };
+	uint8_t ucLane[SIMTEST_GANG_LANES][SIMTEST_GANG_LEN];
+	const uint8_t* pData[SIMTEST_GANG_LANES];
+	EEP_SimTypeDef* pChip[SIMTEST_GANG_LANES];
+	EEP_SimFaultsTypeDef faults;
+
+	// every chip answers the shared chip select, lane l drives chip l
+	EEPROM_Sim_Reset();
+	for(uint8_t l = 0; l < SIMTEST_GANG_LANES; l++)
+	{
+		pChip[l] = EEPROM_Sim_AddChip(gang.Device.CsPin, gang.Device.Capacity, gang.Device.PageSize, gang.Device.AddrBytes);
+		gang.Lane[l].MosiPin = (uint16_t)(GPIO_PIN_8 << l);
+		gang.Lane[l].MisoPin = (uint16_t)(GPIO_PIN_12 << l);
+		EEPROM_SimTest_Pattern(ucLane[l], SIMTEST_GANG_LEN, 0x6A00 + l);
+		ucLane[l][0] = l;
+		pData[l] = ucLane[l];
+	}
+
+	memset(&faults, 0, sizeof(faults));
+	faults.Stuck[0].Addr = SIMTEST_GANG_ADDR + SIMTEST_GANG_STUCK;
+	faults.Stuck[0].Mask = 0x01;
+	faults.Stuck[0].Value = (uint8_t)~ucLane[1][SIMTEST_GANG_STUCK];
+	EEPROM_Sim_SetChipFaults(pChip[1], &faults);
+	memset(&faults, 0, sizeof(faults));
+	faults.WipStuckAtWrite = 2;
+	EEPROM_Sim_SetChipFaults(pChip[3], &faults);
+
+	SIMTEST_CHECK(BSP_EEPROM_Gang_Init(&gang) == HAL_OK);
+	SIMTEST_CHECK(BSP_EEPROM_Gang_Write(&gang, SIMTEST_GANG_ADDR, pData, SIMTEST_GANG_LEN) == HAL_ERROR);
+	SIMTEST_CHECK(gang.FailMask == 0x08);
+	SIMTEST_CHECK(BSP_EEPROM_Gang_Verify(&gang, SIMTEST_GANG_ADDR, pData, SIMTEST_GANG_LEN) == HAL_ERROR);
+	SIMTEST_CHECK(gang.FailMask == 0x0A);
+
+	for(uint8_t l = 0; l < 3; l++){
+		SIMTEST_CHECK(pChip[l]->Writes == uwPages);
+		SIMTEST_CHECK(memcmp(&pChip[l]->Mem[SIMTEST_GANG_ADDR], ucLane[l], SIMTEST_GANG_LEN) == 0);
+	}
+	SIMTEST_CHECK(gang.Lane[0].FailAddr == EEP_GANG_NO_FAIL && gang.Lane[0].Errors == 0);
+	SIMTEST_CHECK(gang.Lane[2].FailAddr == EEP_GANG_NO_FAIL && gang.Lane[2].Errors == 0);
+	SIMTEST_CHECK(gang.Lane[1].FailAddr == SIMTEST_GANG_ADDR + SIMTEST_GANG_STUCK && gang.Lane[1].Errors == 1);
+
+	// the hung chip kept its first page and ignores the READ, SO stays high
+	for(uint32_t i = 0; i < SIMTEST_GANG_LEN; i++) uwErrors += (ucLane[3][i] != 0xFF);
+	SIMTEST_CHECK(pChip[3]->Writes == 2);
+	SIMTEST_CHECK(memcmp(&pChip[3]->Mem[SIMTEST_GANG_ADDR], ucLane[3], uwFirst) == 0);
+	SIMTEST_CHECK(gang.Lane[3].FailAddr == SIMTEST_GANG_ADDR && gang.Lane[3].Errors == uwErrors);
+
+	return uwFails;
+}
+
+/**
+  * @brief  striped volume on 1, 2 and 4 chips: the benchmark passes, unit u of
+  *         the stripe sits on chip u % n, and n chips write n times the data
+  *         in about the time one chip takes
+	* @retval number of failed conditions
+  */
+//==============================================
+static uint32_t EEPROM_SimTest_Stripe(void)
+//==============================================
+{
+	uint32_t uwFails = 0, uwStart, uwTime[EEP_MAX_DEVICES + 1];
+	EEP_DeviceTypeDef* pDevices[EEP_MAX_DEVICES];
+	uint8_t ucData[EEP_MAX_DEVICES * EEP_SPI_PAGESIZE];
+	uint32_t uwRowSize;
+
+	EEPROM_SimTest_Bus(pDevices, EEP_MAX_DEVICES);
+	SIMTEST_CHECK(BSP_EEPROM_Stripe_BenchmarkTest(pDevices, EEP_MAX_DEVICES) == HAL_OK);
+	SIMTEST_CHECK(pEeprom == pDevices[0]);
+
+	// passes on 1, 2 and 4 chips, the last one left row r unit d on chip d
+	SIMTEST_CHECK(hEepSim[0].Writes == 3 * EEP_BENCH_PAGES);
+	SIMTEST_CHECK(hEepSim[1].Writes == 2 * EEP_BENCH_PAGES);
+	SIMTEST_CHECK(hEepSim[2].Writes == EEP_BENCH_PAGES && hEepSim[3].Writes == EEP_BENCH_PAGES);
+	for(uint8_t d = 0; d < EEP_MAX_DEVICES; d++){
+		for(uint16_t r = 0; r < EEP_BENCH_PAGES; r++){
+			for(uint16_t j = 0; j < EEP_SPI_PAGESIZE; j++){
+				if(hEepSim[d].Mem[r * EEP_SPI_PAGESIZE + j] != (uint8_t)(r * 7 + d * EEP_SPI_PAGESIZE + j)) uwFails++;
+			}
+		}
+	}
+
+	for(uint8_t n = 1; n <= EEP_MAX_DEVICES; n <<= 1)
+	{
+		uwRowSize = (uint32_t)n * EEP_SPI_PAGESIZE;
+		SIMTEST_CHECK(BSP_EEPROM_Stripe_Init(pDevices, n) == HAL_OK);
+		SIMTEST_CHECK(hEepStripe.Capacity == n * pDevices[0]->Capacity);
+
+		uwStart = BSP_GetMicros();
+		for(uint16_t r = 0; r < EEP_BENCH_PAGES; r++){
+			EEPROM_SimTest_Pattern(ucData, uwRowSize, r + n);
+			SIMTEST_CHECK(BSP_EEPROM_Stripe_Write(r * uwRowSize, ucData, uwRowSize) == HAL_OK);
+		}
+		for(uint8_t d = 0; d < n; d++){
+			SIMTEST_CHECK(EEPROM_SPI_Select(pDevices[d]) == HAL_OK);
+			SIMTEST_CHECK(EEPROM_SPI_WaitReady() == HAL_OK);
+		}
+		uwTime[n] = BSP_GetMicros() - uwStart;
+
+		for(uint16_t r = 0; r < EEP_BENCH_PAGES; r++){
+			EEPROM_SimTest_Pattern(ucSimTestImage, uwRowSize, r + n);
+			SIMTEST_CHECK(BSP_EEPROM_Stripe_Read(r * uwRowSize, ucData, uwRowSize) == HAL_OK);
+			SIMTEST_CHECK(memcmp(ucData, ucSimTestImage, uwRowSize) == 0);
+		}
+		EEP_LOG("  %d chip(s): %d rows of %lu bytes in %lu us\r\n", n, EEP_BENCH_PAGES, (unsigned long)uwRowSize, (unsigned long)uwTime[n]);
+	}
+	SIMTEST_CHECK(uwTime[2] < uwTime[1] + uwTime[1] / 4);
+	SIMTEST_CHECK(uwTime[4] < uwTime[1] + uwTime[1] / 4);
+
+	return uwFails;
+}
+
+/**
+  * @brief  partial page writes on the mirrored volume: a page whose copies both
+  *         fail their CRC starts over blank, but a chip that cannot be read
+  *         stops the write so its good copy is not replaced by a blank one.
+  *         The resync records a lost page and carries on with the others.
+	* @retval number of failed conditions
+  */
+//==============================================
+static uint32_t EEPROM_SimTest_Mirror(void)
+//==============================================
+{
+	uint32_t uwFails = 0, uwData, uwPage;
+	EEP_DeviceTypeDef* pDevices[2];
+	uint8_t ucData[EEP_SPI_PAGESIZE * 4];
+	uint8_t ucBack[EEP_SPI_PAGESIZE * 4];
+
+	EEPROM_SimTest_Bus(pDevices, 2);
+	SIMTEST_CHECK(BSP_EEPROM_Mirror_Init(pDevices[0], pDevices[1]) == HAL_OK);
+	uwData = hEepMirror.PageSize - EEP_MIRROR_CRC_SIZE;
+
+	EEPROM_SimTest_Pattern(ucData, sizeof(ucData), 7);
+	SIMTEST_CHECK(BSP_EEPROM_Mirror_Write(0, ucData, sizeof(ucData)) == HAL_OK);
+	SIMTEST_CHECK(BSP_EEPROM_Mirror_Read(0, ucBack, sizeof(ucBack)) == HAL_OK);
+	SIMTEST_CHECK(memcmp(ucBack, ucData, sizeof(ucData)) == 0);
+
+	// page 1 rotten on both chips: the partial write rebuilds it from 0xFF
+	uwPage = 1;
+	hEepSim[0].Mem[uwPage * hEepMirror.PageSize] ^= 0x01;
+	hEepSim[1].Mem[uwPage * hEepMirror.PageSize + 1] ^= 0x01;
+	SIMTEST_CHECK(BSP_EEPROM_Mirror_Write(uwPage * uwData + 4, ucData, 4) == HAL_OK);
+	SIMTEST_CHECK(BSP_EEPROM_Mirror_Read(uwPage * uwData, ucBack, uwData) == HAL_OK);
+	for(uint32_t i = 0; i < uwData; i++){
+		SIMTEST_CHECK(ucBack[i] == ((i >= 4 && i < 8) ? ucData[i - 4] : 0xFF));
+	}
+
+	// page 2 rotten on chip 0 while chip 1 hangs: nothing may be written
+	uwPage = 2;
+	hEepSim[0].Mem[uwPage * hEepMirror.PageSize] ^= 0x01;
+	memcpy(ucSimTestImage, hEepSim[0].Mem, hEepSim[0].Capacity);
+	hEepSim[1].WipStuck = 1;
+	SIMTEST_CHECK(BSP_EEPROM_Mirror_Write(uwPage * uwData + 4, ucData, 4) == HAL_ERROR);
+	SIMTEST_CHECK(memcmp(ucSimTestImage, hEepSim[0].Mem, hEepSim[0].Capacity) == 0);
+
+	// once chip 1 answers again its copy still holds the data
+	hEepSim[1].WipStuck = 0;
+	SIMTEST_CHECK(BSP_EEPROM_Mirror_Read(uwPage * uwData, ucBack, uwData) == HAL_OK);
+	SIMTEST_CHECK(memcmp(ucBack, &ucData[uwPage * uwData], uwData) == 0);
+	SIMTEST_CHECK(BSP_EEPROM_Mirror_Resync() == HAL_OK);
+	SIMTEST_CHECK(memcmp(&hEepSim[0].Mem[uwPage * hEepMirror.PageSize], &hEepSim[1].Mem[uwPage * hEepMirror.PageSize], hEepMirror.PageSize) == 0);
+
+	// page 0 lost on both chips ahead of a stale page 3: the read stops at the
+	// lost page and the resync records it, then goes on to repair page 3
+	hEepSim[0].Mem[0] ^= 0x01;
+	hEepSim[1].Mem[1] ^= 0x01;
+	hEepSim[1].Mem[3 * hEepMirror.PageSize] ^= 0x01;
+	SIMTEST_CHECK(BSP_EEPROM_Mirror_Read(3 * uwData, ucBack, uwData) == HAL_OK);
+	SIMTEST_CHECK(memcmp(ucBack, &ucData[3 * uwData], uwData) == 0);
+	memset(ucBack, 0x5A, sizeof(ucBack));
+	SIMTEST_CHECK(BSP_EEPROM_Mirror_Read(0, ucBack, sizeof(ucBack)) == HAL_ERROR);
+	for(uint32_t i = 0; i < sizeof(ucBack); i++) SIMTEST_CHECK(ucBack[i] == 0x5A);
+
+	uint32_t uwLost = hEepMirror.Lost;
+	for(uint8_t i = 0; i < 2; i++)
+	{
+		for(uint8_t c = 0; c < 2; c++){
+			SIMTEST_CHECK(EEPROM_SPI_Select(pDevices[c]) == HAL_OK);
+			SIMTEST_CHECK(EEPROM_SPI_WaitReady() == HAL_OK);
+		}
+		SIMTEST_CHECK(BSP_EEPROM_Mirror_Resync() == HAL_OK);
+	}
+	SIMTEST_CHECK(hEepMirror.Lost == uwLost + 1);
+	SIMTEST_CHECK(memcmp(&hEepSim[0].Mem[3 * hEepMirror.PageSize], &hEepSim[1].Mem[3 * hEepMirror.PageSize], hEepMirror.PageSize) == 0);
+
+	// rewriting the lost page brings it back
+	SIMTEST_CHECK(BSP_EEPROM_Mirror_Write(0, ucData, uwData) == HAL_OK);
+	SIMTEST_CHECK(BSP_EEPROM_Mirror_Read(0, ucBack, uwData) == HAL_OK);
+	SIMTEST_CHECK(memcmp(ucBack, ucData, uwData) == 0);
+
+	return uwFails;
+}
+
+#ifdef BSP_EEPROM_USE_RTOS
+#define SIMTEST_RTOS_CLIENTS						 (uint8_t)3
+#define SIMTEST_RTOS_ROUNDS							 (uint8_t)4
+#define SIMTEST_RTOS_REGION							 (uint32_t)(4 * EEP_SPI_PAGESIZE) // bytes each client owns
+#define SIMTEST_RTOS_TIMEOUT_MS					 (uint32_t)10000
+#define SIMTEST_RTOS_RECORD							 (uint32_t)4 			// bytes of one queued record
+
+static void EEPROM_SimTest_RtosClient(void const* argument);
+
+osThreadDef(EEPROM_SimTest_RtosClient, osPriorityNormal, SIMTEST_RTOS_CLIENTS, 0);
+osSemaphoreDef(SimTestRtosDone);
+osSemaphoreDef(SimTestRtosEntered);
+osSemaphoreDef(SimTestRtosGate);
+
+// requests handed to the worker travel as 32 bit values, so they are static here
+static EEP_RequestTypeDef xSimTestReq[EEP_RTOS_QUEUE_SIZE];
+static uint8_t ucSimTestReqBuf[EEP_RTOS_QUEUE_SIZE][EEP_SPI_PAGESIZE];
+static EEP_RequestTypeDef xSimTestGateReq;
+static uint8_t ucSimTestGateBuf[SIMTEST_RTOS_RECORD];
+static osSemaphoreId SimTestRtosDoneId;
+static osSemaphoreId SimTestRtosEnteredId;
+static osSemaphoreId SimTestRtosGateId;
+static volatile uint32_t uwSimTestRtosFails[SIMTEST_RTOS_CLIENTS + 1];
+static volatile uint32_t uwSimTestCallbacks;
+
+/**
+  * @brief  client thread: blocking writes and reads of its own region, each
+  *         round with new data, then releases SimTestRtosDoneId
+  * @param  argument: client number
+	* @retval none
+  */
+//===========================================================
+static void EEPROM_SimTest_RtosClient(void const* argument)
+//===========================================================
+{
+	uint32_t c = (uint32_t)(uintptr_t)argument;
+	uint8_t ucData[SIMTEST_RTOS_REGION], ucBack[SIMTEST_RTOS_REGION];
+
+	for(uint8_t r = 0; r < SIMTEST_RTOS_ROUNDS; r++)
+	{
+		EEPROM_SimTest_Pattern(ucData, sizeof(ucData), c * 16 + r);
+		memset(ucBack, 0, sizeof(ucBack));
+		if(BSP_EEPROM_Rtos_Write(c * SIMTEST_RTOS_REGION, ucData, sizeof(ucData)) != HAL_OK) uwSimTestRtosFails[c]++;
+		if(BSP_EEPROM_Rtos_Read(c * SIMTEST_RTOS_REGION, ucBack, sizeof(ucBack)) != HAL_OK) uwSimTestRtosFails[c]++;
+		if(memcmp(ucData, ucBack, sizeof(ucData)) != 0) uwSimTestRtosFails[c]++;
+	}
+
+	osSemaphoreRelease(SimTestRtosDoneId);
+}
+
+/**
+  * @brief  completion callback, runs on the worker: the status is final and a
+  *         blocking call from here is refused instead of dead locking
+  * @param  pReq: completed request
+	* @retval none
+  */
+//=============================================================
+static void EEPROM_SimTest_RtosDone(EEP_RequestTypeDef* pReq)
+//=============================================================
+{
+	uint8_t ucByte;
+
+	if(pReq->Status != HAL_OK) uwSimTestRtosFails[SIMTEST_RTOS_CLIENTS]++;
+	if(BSP_EEPROM_Rtos_Read(0, &ucByte, 1) != HAL_ERROR) uwSimTestRtosFails[SIMTEST_RTOS_CLIENTS]++;
+	uwSimTestCallbacks++;
+}
+
+/**
+  * @brief  completion callback that holds the worker until the test opens the
+  *         gate, so the requests queued meanwhile are taken as one batch
+  * @param  pReq: completed request
+	* @retval none
+  */
+//=============================================================
+static void EEPROM_SimTest_RtosGate(EEP_RequestTypeDef* pReq)
+//=============================================================
+{
+	(void)pReq;
+	osSemaphoreRelease(SimTestRtosEnteredId);
+	osSemaphoreWait(SimTestRtosGateId, osWaitForever);
+}
+
+/**
+  * @brief  storage worker on POSIX threads: concurrent blocking clients keep
+  *         their data apart, queued requests complete through their callback
+  *         and semaphore, adjacent queued records share one page program
+	* @retval number of failed conditions
+  */
+//==============================================
+static uint32_t EEPROM_SimTest_Rtos(void)
+//==============================================
+{
+	uint32_t uwFails = 0;
+	uint8_t ucData[SIMTEST_RTOS_REGION];
+
+	SIMTEST_CHECK(BSP_EEPROM_Rtos_Init() == HAL_OK);
+	SimTestRtosDoneId = osSemaphoreCreate(osSemaphore(SimTestRtosDone), 0);
+	SIMTEST_CHECK(SimTestRtosDoneId != NULL);
+
+	for(uint32_t c = 0; c < SIMTEST_RTOS_CLIENTS; c++){
+		SIMTEST_CHECK(osThreadCreate(osThread(EEPROM_SimTest_RtosClient), (void*)(uintptr_t)c) != NULL);
+	}
+	for(uint32_t c = 0; c < SIMTEST_RTOS_CLIENTS; c++){
+		SIMTEST_CHECK(osSemaphoreWait(SimTestRtosDoneId, SIMTEST_RTOS_TIMEOUT_MS) > 0);
+	}
+	for(uint32_t c = 0; c < SIMTEST_RTOS_CLIENTS; c++)
+	{
+		SIMTEST_CHECK(uwSimTestRtosFails[c] == 0);
+		EEPROM_SimTest_Pattern(ucData, sizeof(ucData), c * 16 + SIMTEST_RTOS_ROUNDS - 1);
+		SIMTEST_CHECK(memcmp(&hEepSim[0].Mem[c * SIMTEST_RTOS_REGION], ucData, sizeof(ucData)) == 0);
+	}
+
+	// a queue full of page writes, each reporting through callback and semaphore
+	for(uint32_t i = 0; i < EEP_RTOS_QUEUE_SIZE; i++)
+	{
+		EEPROM_SimTest_Pattern(ucSimTestReqBuf[i], EEP_SPI_PAGESIZE, 100 + i);
+		xSimTestReq[i] = (EEP_RequestTypeDef){ .Type = EEP_REQ_WRITE, .Address = SIMTEST_RTOS_CLIENTS * SIMTEST_RTOS_REGION + i * EEP_SPI_PAGESIZE,
+																					 .pBuffer = ucSimTestReqBuf[i], .Length = EEP_SPI_PAGESIZE,
+																					 .Done = SimTestRtosDoneId, .Callback = EEPROM_SimTest_RtosDone };
+		SIMTEST_CHECK(BSP_EEPROM_Rtos_Submit(&xSimTestReq[i]) == HAL_OK);
+	}
+	for(uint32_t i = 0; i < EEP_RTOS_QUEUE_SIZE; i++){
+		SIMTEST_CHECK(osSemaphoreWait(SimTestRtosDoneId, SIMTEST_RTOS_TIMEOUT_MS) > 0);
+	}
+	SIMTEST_CHECK(uwSimTestCallbacks == EEP_RTOS_QUEUE_SIZE);
+	SIMTEST_CHECK(uwSimTestRtosFails[SIMTEST_RTOS_CLIENTS] == 0);
+	for(uint32_t i = 0; i < EEP_RTOS_QUEUE_SIZE; i++){
+		SIMTEST_CHECK(xSimTestReq[i].Status == HAL_OK);
+		SIMTEST_CHECK(memcmp(&hEepSim[0].Mem[xSimTestReq[i].Address], ucSimTestReqBuf[i], EEP_SPI_PAGESIZE) == 0);
+	}
+
+	// records queued while the worker is held form one batch and one page program
+	SimTestRtosEnteredId = osSemaphoreCreate(osSemaphore(SimTestRtosEntered), 0);
+	SimTestRtosGateId = osSemaphoreCreate(osSemaphore(SimTestRtosGate), 0);
+	SIMTEST_CHECK(SimTestRtosEnteredId != NULL && SimTestRtosGateId != NULL);
+	xSimTestGateReq = (EEP_RequestTypeDef){ .Type = EEP_REQ_WRITE, .Address = 0, .pBuffer = ucSimTestGateBuf,
+																				 .Length = SIMTEST_RTOS_RECORD, .Callback = EEPROM_SimTest_RtosGate };
+	SIMTEST_CHECK(BSP_EEPROM_Rtos_Submit(&xSimTestGateReq) == HAL_OK);
+	SIMTEST_CHECK(osSemaphoreWait(SimTestRtosEnteredId, SIMTEST_RTOS_TIMEOUT_MS) > 0);
+
+	uint32_t uwBase = (SIMTEST_RTOS_CLIENTS * SIMTEST_RTOS_REGION) + (EEP_RTOS_QUEUE_SIZE * EEP_SPI_PAGESIZE);
+	uint32_t uwWrites = hEepSim[0].Writes;
+
+	for(uint32_t i = 0; i < (EEP_RTOS_QUEUE_SIZE - 1); i++)
+	{
+		EEPROM_SimTest_Pattern(ucSimTestReqBuf[i], SIMTEST_RTOS_RECORD, 200 + i);
+		xSimTestReq[i] = (EEP_RequestTypeDef){ .Type = EEP_REQ_WRITE, .Address = uwBase + i * SIMTEST_RTOS_RECORD,
+																					 .pBuffer = ucSimTestReqBuf[i], .Length = SIMTEST_RTOS_RECORD, .Done = SimTestRtosDoneId };
+		SIMTEST_CHECK(BSP_EEPROM_Rtos_Submit(&xSimTestReq[i]) == HAL_OK);
+	}
+	osSemaphoreRelease(SimTestRtosGateId);
+	for(uint32_t i = 0; i < (EEP_RTOS_QUEUE_SIZE - 1); i++){
+		SIMTEST_CHECK(osSemaphoreWait(SimTestRtosDoneId, SIMTEST_RTOS_TIMEOUT_MS) > 0);
+	}
+	SIMTEST_CHECK(hEepSim[0].Writes == uwWrites + 1);
+	for(uint32_t i = 0; i < (EEP_RTOS_QUEUE_SIZE - 1); i++){
+		SIMTEST_CHECK(xSimTestReq[i].Status == HAL_OK);
+		SIMTEST_CHECK(memcmp(&hEepSim[0].Mem[xSimTestReq[i].Address], ucSimTestReqBuf[i], SIMTEST_RTOS_RECORD) == 0);
+	}
+
+	return uwFails;
+}
+#endif /* BSP_EEPROM_USE_RTOS */
+
+static const EEP_SimTestTypeDef xSimTests[] = {
+	{ "chunk planner", 				EEPROM_SimTest_Planner },
+	{ "fuzz corpus replay", 		EEPROM_SimTest_Fuzz },
+	{ "range fill", 				EEPROM_SimTest_Fill },
+	{ "clock calibration", 		EEPROM_SimTest_Calibrate },
+	{ "write cycle wait", 			EEPROM_SimTest_WaitMode },
+	{ "config migration", 			EEPROM_SimTest_Config },
+#ifdef BSP_EEPROM_FLASH_VIRTUAL
+	{ "flash emulation", 			EEPROM_SimTest_Flash },
+#endif
+	{ "size detection", 				EEPROM_SimTest_Detect },
+	{ "memory diagnostics", 		EEPROM_SimTest_Diag },
+	{ "wave build and pack", 		EEPROM_SimTest_Wave },
+	{ "append writer", 					EEPROM_SimTest_Append },
+	{ "multi chip interleave", EEPROM_SimTest_Interleave },
+	{ "gang programming", 			EEPROM_SimTest_Gang },
+	{ "striped volume", 				EEPROM_SimTest_Stripe },
+	{ "mirrored volume", 			EEPROM_SimTest_Mirror },
+#ifdef BSP_EEPROM_USE_RTOS
+	{ "rtos storage worker", 	EEPROM_SimTest_Rtos },
+#endif
+};
+
+/**
+  * @brief  runs every check on a fresh model and logs the result of each
+	* @retval number of failed conditions over all checks, 0 if all passed
+  */
+//==============================================
+uint32_t EEPROM_SimTest_Run(void)
+//==============================================
+{
+	uint32_t uwFails, uwTotal = 0;
+
+	for(uint32_t t = 0; t < sizeof(xSimTests) / sizeof(xSimTests[0]); t++)
+	{
+		EEPROM_SimTest_Setup();
+		uwFails = xSimTests[t].Run();
+		uwTotal += uwFails;
+		EEP_LOG("%-28s %s\r\n", xSimTests[t].Name, (uwFails == 0) ? "Passed" : "Failed");
+	}
+
+	return uwTotal;
+}
+
+#ifdef BSP_EEPROM_SIMTEST
+#include "stdarg.h"
+
+/**
+  * @brief  EEP_LOG goes to stdout on the host
+  * @param  format: printf format
+	* @retval number of characters written
+  */
+//==============================================
+int aPrintOutLog(const char* format, ...)
+//==============================================
+{
+	va_list args;
+	int iLen;
+
+	va_start(args, format);
+	iLen = vprintf(format, args);
+	va_end(args);
+
+	return iLen;
+}
+
+//==============================================
+int main(void)
+//==============================================
+{
+	return (EEPROM_SimTest_Run() == 0) ? 0 : 1;
+}
+#endif
+
+#endif /* BSP_EEPROM_SIM */
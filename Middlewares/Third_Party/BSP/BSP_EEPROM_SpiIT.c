@@ -0,0 +1,217 @@
+/**
+  ******************************************************************************
+  * @file    BSP_EEPROM_SpiIT.c
+  * @author  Hossein Bagherzade(@realhba)
+	* @email	 hossein.bagherzade@gmail.com
+  * @version V1.0.0
+  * @date    18-Oct-2026
+  * @brief   Interrupt driven SPI1 frames for the hardware path, between polled
+  * transfers and DMA. A frame is the instruction/address header followed by
+  * the payload with no gap in between; the ISR keeps EEP_SPIIT_INFLIGHT bytes
+  * queued, so SCK keeps running, and raises CS itself after the last byte is
+  * in. A callback then reports the result. The driver uses it for payloads
+  * from hEepSpiIT.Threshold bytes on, EEPROM_SpiIT_Benchmark measures where
+  * that point is on the actual clock and bus settings.
+  ******************************************************************************
+	**/
+
+#include "BSP_EEPROM_SpiIT.h"
+#include "string.h"
+
+#if (USE_HARDSPI_IT == 1)
+
+EEP_SpiITTypeDef hEepSpiIT = { .Threshold = EEP_SPIIT_THRESHOLD_DEFAULT };
+
+static uint8_t ucSpiITReady = 0;
+
+/**
+  * @brief  next byte of the frame: header, then payload or 0xFF
+	* @retval byte to send
+  */
+//==============================================
+static uint8_t EEPROM_SpiIT_NextTx(void)
+//==============================================
+{
+	uint16_t i = hEepSpiIT.TxCount++;
+
+	if(i < hEepSpiIT.HeaderLen) return hEepSpiIT.Header[i];
+
+	return (hEepSpiIT.pTx != NULL) ? hEepSpiIT.pTx[i - hEepSpiIT.HeaderLen] : 0xFF;
+}
+
+/**
+  * @brief  ends the frame: CS high, write cycle bookkeeping and the callback
+  * @param  status: result reported to the caller
+	* @retval none
+  */
+//=========================================================
+static void EEPROM_SpiIT_Finish(HAL_StatusTypeDef status)
+//=========================================================
+{
+	__HAL_SPI_DISABLE_IT(&hspi1, SPI_IT_RXNE);
+
+	EEP_SPI_CS_HIGH();
+	if(hEepSpiIT.WriteCycle) EEPROM_SPI_WriteCycleStarted();
+
+	hEepSpiIT.Status = status;
+	hEepSpiIT.Busy = 0;
+
+	if(hEepSpiIT.Callback != NULL) hEepSpiIT.Callback(status, hEepSpiIT.pContext);
+}
+
+/**
+  * @brief  starts a frame on the selected device and returns at once. pEeprom
+  *         must stay selected and the buffers valid until it completes
+  * @param  pHeader: instruction and address bytes
+  * @param  ucHeaderLen: header length, up to EEP_HEADER_MAX
+  * @param  pTx: payload to send, NULL sends 0xFF
+  * @param  pRx: payload received, NULL discards it
+  * @param  uiLen: payload bytes
+  * @param  ucWriteCycle: 1 if the CS rising edge starts a write cycle (WRITE, WRSR)
+  * @param  callback: called from the ISR at the end, may be NULL
+  * @param  pContext: passed to the callback
+	* @retval HAL_StatusTypeDef enum, HAL_OK once the frame is started
+  */
+//=====================================================================================================================
+HAL_StatusTypeDef EEPROM_SpiIT_Start(const uint8_t* pHeader, uint8_t ucHeaderLen, const uint8_t* pTx, uint8_t* pRx,
+																		 uint16_t uiLen, uint8_t ucWriteCycle, EEP_SpiITCallbackTypeDef callback, void* pContext)
+//=====================================================================================================================
+{
+	SPI_TypeDef* pSpi = hspi1.Instance;
+
+	if(hEepSpiIT.Busy || ucHeaderLen > EEP_HEADER_MAX || (uint32_t)ucHeaderLen + uiLen == 0 ||
+		 (uint32_t)ucHeaderLen + uiLen > 0xFFFF) return HAL_ERROR;
+
+	if(!ucSpiITReady){
+		HAL_NVIC_SetPriority(EEP_SPIIT_IRQn, EEP_SPIIT_IRQ_PRIORITY, 0);
+		HAL_NVIC_EnableIRQ(EEP_SPIIT_IRQn);
+		ucSpiITReady = 1;
+	}
+
+	memcpy(hEepSpiIT.Header, pHeader, ucHeaderLen);
+	hEepSpiIT.HeaderLen = ucHeaderLen;
+	hEepSpiIT.pTx = pTx;
+	hEepSpiIT.pRx = pRx;
+	hEepSpiIT.Total = ucHeaderLen + uiLen;
+	hEepSpiIT.TxCount = 0;
+	hEepSpiIT.RxCount = 0;
+	hEepSpiIT.WriteCycle = ucWriteCycle;
+	hEepSpiIT.Callback = callback;
+	hEepSpiIT.pContext = pContext;
+	hEepSpiIT.Status = HAL_BUSY;
+	hEepSpiIT.Busy = 1;
+
+	// RXNE per byte, and nothing left over from a polled transmit
+	SET_BIT(pSpi->CR2, SPI_CR2_FRXTH);
+	__HAL_SPI_ENABLE(&hspi1);
+	while(pSpi->SR & SPI_SR_RXNE) (void)*(__IO uint8_t*)&pSpi->DR;
+	__HAL_SPI_CLEAR_OVRFLAG(&hspi1);
+
+	EEP_SPI_CS_LOW();
+	while(hEepSpiIT.TxCount < hEepSpiIT.Total && hEepSpiIT.TxCount < EEP_SPIIT_INFLIGHT){
+		*(__IO uint8_t*)&pSpi->DR = EEPROM_SpiIT_NextTx();
+	}
+	__HAL_SPI_ENABLE_IT(&hspi1, SPI_IT_RXNE);
+
+	return HAL_OK;
+}
+
+/**
+  * @brief  idles until the frame is done, every byte gets EEPROM_SPI_FLAG_TIMEOUT_US
+	* @retval HAL_StatusTypeDef enum, result of the frame
+  */
+//==============================================
+HAL_StatusTypeDef EEPROM_SpiIT_Wait(void)
+//==============================================
+{
+	BSP_DeadlineTypeDef deadline = BSP_Deadline_After(EEPROM_SPI_FLAG_TIMEOUT_US * hEepSpiIT.Total);
+
+	while(hEepSpiIT.Busy)
+	{
+		if(BSP_Deadline_Expired(deadline))
+		{
+			__HAL_SPI_DISABLE_IT(&hspi1, SPI_IT_RXNE);
+			if(hEepSpiIT.Busy) EEPROM_SpiIT_Finish(HAL_TIMEOUT);
+			break;
+		}
+		BSP_Timebase_IdleHook(0);
+	}
+
+	return hEepSpiIT.Status;
+}
+
+/**
+  * @brief  SPI1 interrupt, must be called from SPI1_IRQHandler. Every byte in
+  *         frees a FIFO slot for the next one out
+	* @retval none
+  */
+//==============================================
+void EEPROM_SpiIT_IRQHandler(void)
+//==============================================
+{
+	SPI_TypeDef* pSpi = hspi1.Instance;
+	uint8_t ucByte;
+
+	while((pSpi->SR & SPI_SR_RXNE) && hEepSpiIT.RxCount < hEepSpiIT.Total)
+	{
+		ucByte = *(__IO uint8_t*)&pSpi->DR;
+		if(hEepSpiIT.RxCount >= hEepSpiIT.HeaderLen && hEepSpiIT.pRx != NULL){
+			hEepSpiIT.pRx[hEepSpiIT.RxCount - hEepSpiIT.HeaderLen] = ucByte;
+		}
+		hEepSpiIT.RxCount++;
+
+		if(hEepSpiIT.TxCount < hEepSpiIT.Total) *(__IO uint8_t*)&pSpi->DR = EEPROM_SpiIT_NextTx();
+	}
+
+	if(hEepSpiIT.Busy && hEepSpiIT.RxCount == hEepSpiIT.Total) EEPROM_SpiIT_Finish(HAL_OK);
+}
+
+/**
+  * @brief  times READs of 3 to 128 bytes polled and interrupt driven and sets
+  *         the threshold to the first size where IT costs at most
+  *         EEP_SPIIT_BENCH_SLACK_PCT more wall time, the CPU is free meanwhile
+	* @retval HAL_StatusTypeDef enum, HAL_OK in case of successful operation
+  */
+//==============================================
+HAL_StatusTypeDef EEPROM_SpiIT_Benchmark(void)
+//==============================================
+{
+	static const uint16_t uiSizes[] = { 3, 5, 8, 16, 35, 64, 128 };
+	HAL_StatusTypeDef E2PStatus = HAL_OK;
+	uint16_t uiSaved = hEepSpiIT.Threshold, uiPick = 0xFFFF;
+	uint32_t uwPoll, uwIT, uwStart;
+	uint8_t ucBuf[128];
+
+	EEP_LOG("EEPROM polled vs IT READ, %d transfers each :\r\n\r\n", EEP_SPIIT_BENCH_REPS);
+
+	for(uint8_t s = 0; (s < sizeof(uiSizes) / sizeof(uiSizes[0])) && (E2PStatus == HAL_OK); s++)
+	{
+		if(uiSizes[s] > pEeprom->Capacity) break;
+
+		hEepSpiIT.Threshold = 0xFFFF;
+		uwStart = BSP_GetMicros();
+		for(uint8_t r = 0; (r < EEP_SPIIT_BENCH_REPS) && (E2PStatus == HAL_OK); r++){
+			E2PStatus = EEPROM_SPI_ReadBuffer(ucBuf, 0, uiSizes[s]);
+		}
+		uwPoll = BSP_GetMicros() - uwStart;
+
+		hEepSpiIT.Threshold = 0;
+		uwStart = BSP_GetMicros();
+		for(uint8_t r = 0; (r < EEP_SPIIT_BENCH_REPS) && (E2PStatus == HAL_OK); r++){
+			E2PStatus = EEPROM_SPI_ReadBuffer(ucBuf, 0, uiSizes[s]);
+		}
+		uwIT = BSP_GetMicros() - uwStart;
+
+		EEP_LOG("%3d bytes: polled %lu us, IT %lu us\r\n", uiSizes[s],
+						(unsigned long)(uwPoll / EEP_SPIIT_BENCH_REPS), (unsigned long)(uwIT / EEP_SPIIT_BENCH_REPS));
+
+		if(uiPick == 0xFFFF && uwIT * 100 <= uwPoll * (100 + EEP_SPIIT_BENCH_SLACK_PCT)) uiPick = uiSizes[s];
+	}
+
+	hEepSpiIT.Threshold = (E2PStatus == HAL_OK) ? uiPick : uiSaved;
+	EEP_LOG("IT threshold: %u bytes\r\n\r\n", hEepSpiIT.Threshold);
+
+	return E2PStatus;
+}
+
+#endif /* USE_HARDSPI_IT */
@@ -0,0 +1,64 @@
+/**
+  ******************************************************************************
+  * @file    BSP_EEPROM_SpiIT.h
+  * @author  Hossein Bagherzade(@realhba)
+	* @email	 hossein.bagherzade@gmail.com
+  * @version V1.0.0
+  * @date    18-Oct-2026
+  * @brief   Header file for BSP_EEPROM_SpiIT.c
+  ******************************************************************************
+	**/
+
+
+#ifndef __BSP_EEPROM_SPIIT_H
+#define __BSP_EEPROM_SPIIT_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "BSP_EEPROM.h"
+
+
+#define EEP_SPIIT_IRQn									 SPI1_IRQn
+#define EEP_SPIIT_IRQ_PRIORITY					 (uint32_t)1
+#define EEP_SPIIT_INFLIGHT							 (uint8_t)2 			// bytes queued ahead, keeps SCK running between interrupts
+#define EEP_SPIIT_THRESHOLD_DEFAULT			 (uint16_t)16 		// payload bytes from which IT is used, until benchmarked
+#define EEP_SPIIT_BENCH_REPS						 (uint8_t)16 			// transfers timed per size and mode
+#define EEP_SPIIT_BENCH_SLACK_PCT				 (uint32_t)25 		// extra wall time accepted for giving the CPU away
+
+typedef void (*EEP_SpiITCallbackTypeDef)(HAL_StatusTypeDef status, void* pContext);
+
+typedef struct
+{
+	uint8_t  Header[EEP_HEADER_MAX];
+	uint8_t  HeaderLen;
+	const uint8_t* pTx;																					// payload to send, NULL clocks out 0xFF
+	uint8_t* pRx;																								// payload received, NULL discards it
+	uint16_t Total;																							// header plus payload bytes
+	uint16_t TxCount;
+	uint16_t RxCount;
+	uint8_t  WriteCycle;																				// the CS rising edge starts a write cycle
+	volatile uint8_t Busy;
+	HAL_StatusTypeDef Status;
+	EEP_SpiITCallbackTypeDef Callback;
+	void*    pContext;
+	uint16_t Threshold;																					// payload size from which the driver uses IT
+} EEP_SpiITTypeDef;
+
+
+extern EEP_SpiITTypeDef hEepSpiIT;
+
+HAL_StatusTypeDef EEPROM_SpiIT_Start(const uint8_t* pHeader, uint8_t ucHeaderLen, const uint8_t* pTx, uint8_t* pRx,
+																		 uint16_t uiLen, uint8_t ucWriteCycle, EEP_SpiITCallbackTypeDef callback, void* pContext);
+HAL_StatusTypeDef EEPROM_SpiIT_Wait(void);
+void EEPROM_SpiIT_IRQHandler(void);
+HAL_StatusTypeDef EEPROM_SpiIT_Benchmark(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __BSP_EEPROM_SPIIT_H */
+
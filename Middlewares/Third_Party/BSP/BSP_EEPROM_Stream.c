@@ -0,0 +1,290 @@
+/**
+  ******************************************************************************
+  * @file    BSP_EEPROM_Stream.c
+  * @author  Hossein Bagherzade(@realhba)
+	* @email	 hossein.bagherzade@gmail.com
+  * @version V1.0.0
+  * @date    18-Oct-2026
+  * @brief   Sequential scans (log replay, image CRC, export) as one continuous
+  * READ through two EEP_STREAM_CHUNK buffers. On the hardware path SPI1 DMA
+  * fills one buffer while the consumer works on the other; the DMA interrupt
+  * starts the next chunk right away if that buffer is free and otherwise
+  * stops the clock until the consumer hands it back, so a slow consumer
+  * never loses data. The soft and flash paths keep the same interface and
+  * buffers, they just read and consume in turn.
+  ******************************************************************************
+	**/
+
+#include "BSP_EEPROM_Stream.h"
+#include "BSP_EEPROM_Flash.h"
+
+EEP_StreamTypeDef hEepStream;
+
+#if (USE_FLASH_EEPROM == 0) && (USE_SOFTWARE_SPI == 0)
+
+static DMA_HandleTypeDef hStreamDmaRx;
+static DMA_HandleTypeDef hStreamDmaTx;
+static const uint8_t ucStreamDummy = 0xFF;
+static uint8_t ucStreamReady = 0;
+
+/**
+  * @brief  starts DMA of the next chunk into a buffer, RX is armed before TX
+  * @param  ucBuf: buffer index
+	* @retval none
+  */
+//==============================================
+static void EEPROM_Stream_Run(uint8_t ucBuf)
+//==============================================
+{
+	uint16_t uiLen = (hEepStream.ToFill > EEP_STREAM_CHUNK) ? EEP_STREAM_CHUNK : (uint16_t)hEepStream.ToFill;
+
+	hEepStream.Len[ucBuf] = uiLen;
+	hEepStream.ToFill -= uiLen;
+	hEepStream.Filling = ucBuf;
+
+	if(HAL_DMA_Start_IT(&hStreamDmaRx, (uint32_t)&hspi1.Instance->DR, (uint32_t)hEepStream.Buf[ucBuf], uiLen) != HAL_OK ||
+		 HAL_DMA_Start(&hStreamDmaTx, (uint32_t)&ucStreamDummy, (uint32_t)&hspi1.Instance->DR, uiLen) != HAL_OK)
+	{
+		hEepStream.Error = 1;
+		return;
+	}
+
+	SET_BIT(hspi1.Instance->CR2, SPI_CR2_RXDMAEN);
+	SET_BIT(hspi1.Instance->CR2, SPI_CR2_TXDMAEN);
+}
+
+/**
+  * @brief  a chunk is in: hand it over and go on with the other buffer if it is free
+  * @param  hdma: DMA handle
+	* @retval none
+  */
+//=========================================================
+static void EEPROM_Stream_RxDone(DMA_HandleTypeDef* hdma)
+//=========================================================
+{
+	uint8_t ucNext = hEepStream.Filling ^ 1;
+
+	CLEAR_BIT(hspi1.Instance->CR2, SPI_CR2_TXDMAEN | SPI_CR2_RXDMAEN);
+	HAL_DMA_Abort(&hStreamDmaTx);
+
+	hEepStream.Filled[hEepStream.Filling] = 1;
+	if(hEepStream.ToFill == 0) return;
+
+	if(!hEepStream.Filled[ucNext]){
+		EEPROM_Stream_Run(ucNext);
+	}
+	else{
+		hEepStream.Paused = 1;
+		hEepStream.Stalls++;
+	}
+}
+
+/**
+  * @brief  DMA error on the RX channel
+  * @param  hdma: DMA handle
+	* @retval none
+  */
+//==========================================================
+static void EEPROM_Stream_RxError(DMA_HandleTypeDef* hdma)
+//==========================================================
+{
+	CLEAR_BIT(hspi1.Instance->CR2, SPI_CR2_TXDMAEN | SPI_CR2_RXDMAEN);
+	HAL_DMA_Abort(&hStreamDmaTx);
+
+	hEepStream.Error = 1;
+}
+
+/**
+  * @brief  sets up the SPI1 DMA channels once
+	* @retval HAL_StatusTypeDef enum, HAL_OK in case of successful operation
+  */
+//=================================================
+static HAL_StatusTypeDef EEPROM_Stream_Init(void)
+//=================================================
+{
+	if(ucStreamReady) return HAL_OK;
+
+	EEP_STREAM_DMA_CLK_ENABLE();
+
+	hStreamDmaRx.Instance = EEP_STREAM_DMA_RX;
+	hStreamDmaRx.Init.Direction = DMA_PERIPH_TO_MEMORY;
+	hStreamDmaRx.Init.PeriphInc = DMA_PINC_DISABLE;
+	hStreamDmaRx.Init.MemInc = DMA_MINC_ENABLE;
+	hStreamDmaRx.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+	hStreamDmaRx.Init.MemDataAlignment = DMA_MDATAALIGN_BYTE;
+	hStreamDmaRx.Init.Mode = DMA_NORMAL;
+	hStreamDmaRx.Init.Priority = DMA_PRIORITY_VERY_HIGH;
+	if(HAL_DMA_Init(&hStreamDmaRx) != HAL_OK) return HAL_ERROR;
+	hStreamDmaRx.XferCpltCallback = EEPROM_Stream_RxDone;
+	hStreamDmaRx.XferErrorCallback = EEPROM_Stream_RxError;
+
+	hStreamDmaTx.Instance = EEP_STREAM_DMA_TX;
+	hStreamDmaTx.Init.Direction = DMA_MEMORY_TO_PERIPH;
+	hStreamDmaTx.Init.PeriphInc = DMA_PINC_DISABLE;
+	hStreamDmaTx.Init.MemInc = DMA_MINC_DISABLE;
+	hStreamDmaTx.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+	hStreamDmaTx.Init.MemDataAlignment = DMA_MDATAALIGN_BYTE;
+	hStreamDmaTx.Init.Mode = DMA_NORMAL;
+	hStreamDmaTx.Init.Priority = DMA_PRIORITY_HIGH;
+	if(HAL_DMA_Init(&hStreamDmaTx) != HAL_OK) return HAL_ERROR;
+
+	HAL_NVIC_SetPriority(EEP_STREAM_DMA_IRQn, EEP_STREAM_DMA_IRQ_PRIORITY, 0);
+	HAL_NVIC_EnableIRQ(EEP_STREAM_DMA_IRQn);
+
+	ucStreamReady = 1;
+	return HAL_OK;
+}
+
+/**
+  * @brief  DMA interrupt, must be called from DMA1_Channel2_3_IRQHandler
+	* @retval none
+  */
+//==============================================
+void EEPROM_Stream_IRQHandler(void)
+//==============================================
+{
+	HAL_DMA_IRQHandler(&hStreamDmaRx);
+}
+
+/**
+  * @brief  DMA side of the stream: the READ header is sent polled, then the
+  *         chunks alternate between the buffers while the consumer runs
+  * @param  uwAddress: first address
+  * @param  uwLength: bytes to stream
+  * @param  consumer: chunk consumer
+  * @param  pContext: passed to the consumer
+	* @retval HAL_StatusTypeDef enum, HAL_OK in case of successful operation
+  */
+//=====================================================================================================================================
+static HAL_StatusTypeDef EEPROM_Stream_Dma(uint32_t uwAddress, uint32_t uwLength, EEP_StreamConsumerTypeDef consumer, void* pContext)
+//=====================================================================================================================================
+{
+	HAL_StatusTypeDef E2PStatus = HAL_OK;
+	BSP_DeadlineTypeDef deadline;
+	SPI_TypeDef* pSpi = hspi1.Instance;
+	uint32_t uwOffset = 0;
+	uint8_t ucBuf = 0;
+
+	if(EEPROM_Stream_Init() != HAL_OK) return HAL_ERROR;
+
+	hEepStream.Filled[0] = hEepStream.Filled[1] = 0;
+	hEepStream.Paused = 0;
+	hEepStream.Error = 0;
+	hEepStream.ToFill = uwLength;
+
+	if(EEPROM_SPI_ReadStart(uwAddress) != HAL_OK){
+		EEPROM_SPI_ReadStop();
+		return HAL_ERROR;
+	}
+
+	// 8 bit RXNE for the DMA and nothing left over from the polled header
+	SET_BIT(pSpi->CR2, SPI_CR2_FRXTH);
+	while(pSpi->SR & SPI_SR_BSY);
+	while(pSpi->SR & SPI_SR_RXNE) (void)*(__IO uint8_t*)&pSpi->DR;
+	__HAL_SPI_CLEAR_OVRFLAG(&hspi1);
+
+	EEPROM_Stream_Run(0);
+
+	while(uwOffset < uwLength)
+	{
+		deadline = BSP_Deadline_After(EEPROM_SPI_FLAG_TIMEOUT_US * EEP_STREAM_CHUNK);
+		while(!hEepStream.Filled[ucBuf] && !hEepStream.Error)
+		{
+			if(BSP_Deadline_Expired(deadline)){
+				hEepStream.Error = 1;
+				break;
+			}
+			BSP_Timebase_IdleHook(0);
+		}
+		if(hEepStream.Error){
+			E2PStatus = HAL_TIMEOUT;
+			break;
+		}
+
+		E2PStatus = consumer(hEepStream.Buf[ucBuf], hEepStream.Len[ucBuf], uwOffset, pContext);
+		if(E2PStatus != HAL_OK) break;
+		uwOffset += hEepStream.Len[ucBuf];
+
+		// hand the buffer back, a stalled bus restarts right into it
+		__disable_irq();
+		hEepStream.Filled[ucBuf] = 0;
+		if(hEepStream.Paused){
+			hEepStream.Paused = 0;
+			EEPROM_Stream_Run(ucBuf);
+		}
+		__enable_irq();
+
+		ucBuf ^= 1;
+	}
+
+	if(E2PStatus != HAL_OK){
+		CLEAR_BIT(pSpi->CR2, SPI_CR2_TXDMAEN | SPI_CR2_RXDMAEN);
+		HAL_DMA_Abort(&hStreamDmaRx);
+		HAL_DMA_Abort(&hStreamDmaTx);
+	}
+	while(pSpi->SR & SPI_SR_BSY);
+	EEPROM_SPI_ReadStop();
+
+	return E2PStatus;
+}
+
+#endif
+
+/**
+  * @brief  streams a range to a consumer in EEP_STREAM_CHUNK pieces using one
+  *         continuous READ and two buffers. On the hardware path the next chunk
+  *         is read by DMA while the consumer runs and the bus waits for a slow
+  *         consumer instead of dropping data; the consumer must not keep the
+  *         pointer after it returns
+  * @param  uwAddress: first address
+  * @param  uwLength: bytes to stream
+  * @param  consumer: chunk consumer, called in address order
+  * @param  pContext: passed to the consumer
+	* @retval HAL_StatusTypeDef enum, HAL_OK in case of successful operation
+  */
+//==============================================================================================================================
+HAL_StatusTypeDef BSP_EEPROM_Stream(uint32_t uwAddress, uint32_t uwLength, EEP_StreamConsumerTypeDef consumer, void* pContext)
+//==============================================================================================================================
+{
+	HAL_StatusTypeDef E2PStatus = HAL_OK;
+	uint32_t uwOffset = 0;
+	uint16_t uiLen;
+	uint8_t ucBuf = 0;
+
+	if(uwLength == 0 || consumer == NULL || uwAddress >= EEP_BACKEND_CAPACITY || uwLength > EEP_BACKEND_CAPACITY - uwAddress) return HAL_ERROR;
+
+	hEepStream.Stalls = 0;
+
+#if (USE_FLASH_EEPROM == 0) && (USE_SOFTWARE_SPI == 0)
+	(void)uwOffset; (void)uiLen; (void)ucBuf;
+	E2PStatus = EEPROM_Stream_Dma(uwAddress, uwLength, consumer, pContext);
+#else
+#if (USE_FLASH_EEPROM == 0)
+	if(EEPROM_SPI_ReadStart(uwAddress) != HAL_OK){
+		EEPROM_SPI_ReadStop();
+		return HAL_ERROR;
+	}
+#endif
+
+	while((E2PStatus == HAL_OK) && (uwOffset < uwLength))
+	{
+		uiLen = (uwLength - uwOffset > EEP_STREAM_CHUNK) ? EEP_STREAM_CHUNK : (uint16_t)(uwLength - uwOffset);
+#if (USE_FLASH_EEPROM == 1)
+		E2PStatus = BSP_EEPROM_Flash_Read(uwAddress + uwOffset, hEepStream.Buf[ucBuf], uiLen);
+#else
+		E2PStatus = EEPROM_SPI_ReadNext(hEepStream.Buf[ucBuf], uiLen);
+#endif
+		hEepStream.Len[ucBuf] = uiLen;
+		if(E2PStatus == HAL_OK) E2PStatus = consumer(hEepStream.Buf[ucBuf], uiLen, uwOffset, pContext);
+
+		uwOffset += uiLen;
+		ucBuf ^= 1;
+	}
+
+#if (USE_FLASH_EEPROM == 0)
+	EEPROM_SPI_ReadStop();
+#endif
+#endif
+
+	return E2PStatus;
+}
@@ -0,0 +1,58 @@
+/**
+  ******************************************************************************
+  * @file    BSP_EEPROM_Stream.h
+  * @author  Hossein Bagherzade(@realhba)
+	* @email	 hossein.bagherzade@gmail.com
+  * @version V1.0.0
+  * @date    18-Oct-2026
+  * @brief   Header file for BSP_EEPROM_Stream.c
+  ******************************************************************************
+	**/
+
+
+#ifndef __BSP_EEPROM_STREAM_H
+#define __BSP_EEPROM_STREAM_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "BSP_EEPROM.h"
+
+
+#define EEP_STREAM_CHUNK								 (uint16_t)64 		// bytes per buffer, the stream uses two
+#define EEP_STREAM_DMA_RX								 DMA1_Channel2 		// SPI1_RX
+#define EEP_STREAM_DMA_TX								 DMA1_Channel3 		// SPI1_TX, clocks out 0xFF
+#define EEP_STREAM_DMA_CLK_ENABLE()			 __HAL_RCC_DMA1_CLK_ENABLE()
+#define EEP_STREAM_DMA_IRQn							 DMA1_Channel2_3_IRQn
+#define EEP_STREAM_DMA_IRQ_PRIORITY			 (uint32_t)1
+
+// Gets every chunk in address order, uwOffset is its position in the stream.
+// Anything but HAL_OK stops the stream with that status.
+typedef HAL_StatusTypeDef (*EEP_StreamConsumerTypeDef)(const uint8_t* pData, uint16_t uiLen, uint32_t uwOffset, void* pContext);
+
+typedef struct
+{
+	uint8_t  Buf[2][EEP_STREAM_CHUNK];
+	uint16_t Len[2];
+	volatile uint8_t Filled[2];																	// set by the DMA side, cleared once consumed
+	volatile uint8_t Paused;																		// bus stopped, the consumer still holds the other buffer
+	volatile uint8_t Error;
+	uint8_t  Filling;																						// buffer the DMA writes to
+	uint32_t ToFill;																						// bytes not requested from the bus yet
+	uint32_t Stalls;																						// statistics: pauses caused by the consumer
+} EEP_StreamTypeDef;
+
+
+extern EEP_StreamTypeDef hEepStream;
+
+HAL_StatusTypeDef BSP_EEPROM_Stream(uint32_t uwAddress, uint32_t uwLength, EEP_StreamConsumerTypeDef consumer, void* pContext);
+void EEPROM_Stream_IRQHandler(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __BSP_EEPROM_STREAM_H */
+
@@ -0,0 +1,567 @@
+/**
+  ******************************************************************************
+  * @file    BSP_EEPROM_Volume.c
+  * @author  Hossein Bagherzade(@realhba)
+	* @email	 hossein.bagherzade@gmail.com
+  * @version V1.0.0
+  * @date    18-Oct-2026
+  * @brief   Logical volumes built from several SPI EEPROMs sharing one bus.
+  * The striped volume spreads page sized units round-robin over the chips, so
+  * a sequential write programs one page on every chip in the same tWC window.
+  * The mirrored volume keeps two CRC sealed copies and reads the free one.
+  ******************************************************************************
+	**/
+
+#include "BSP_EEPROM_Volume.h"
+#include "string.h"
+
+EEP_StripeTypeDef hEepStripe;
+
+
+//=======================================================================================
+//================================== Striped volume =====================================
+//=======================================================================================
+
+/**
+  * @brief  builds the striped volume from a set of chips
+  * @param  pDevices: device handles, all with the same page size
+  * @param  ucCount: number of devices, up to EEP_MAX_DEVICES
+	* @retval HAL_StatusTypeDef enum, HAL_OK in case of successful operation
+  */
+//=========================================================================================
+HAL_StatusTypeDef BSP_EEPROM_Stripe_Init(EEP_DeviceTypeDef* pDevices[], uint8_t ucCount)
+//=========================================================================================
+{
+	uint32_t uwChipSize;
+
+	hEepStripe.DeviceCount = 0;
+	if(ucCount == 0 || ucCount > EEP_MAX_DEVICES || pDevices[0] == NULL) return HAL_ERROR;
+
+	hEepStripe.StripeSize = pDevices[0]->PageSize;
+	uwChipSize = pDevices[0]->Capacity;
+
+	for(uint8_t i = 0; i < ucCount; i++)
+	{
+		if(pDevices[i] == NULL || pDevices[i]->PageSize != hEepStripe.StripeSize) return HAL_ERROR;
+		if(pDevices[i]->Capacity < uwChipSize) uwChipSize = pDevices[i]->Capacity;
+		hEepStripe.pDevices[i] = pDevices[i];
+	}
+
+	// the smallest chip sets the number of full rows
+	uwChipSize -= uwChipSize % hEepStripe.StripeSize;
+	hEepStripe.Capacity = uwChipSize * ucCount;
+	hEepStripe.DeviceCount = ucCount;
+
+	return HAL_OK;
+}
+
+/**
+  * @brief  writes a buffer into the striped volume. Each row of the stripe (one
+  *         unit per chip) is handed to the interleaving scheduler, so the chips
+  *         program their pages in parallel.
+  * @param  reg_address: logical address starts from 0x00000000
+  * @param  data_buf: pointer to a user defined buffer for data to be copied
+  * @param  length: number of bytes to be written statring from reg_address
+	* @retval HAL_StatusTypeDef enum, HAL_OK in case of successful operation
+  */
+//====================================================================================================
+HAL_StatusTypeDef BSP_EEPROM_Stripe_Write(uint32_t reg_address, uint8_t data_buf[], uint32_t length)
+//====================================================================================================
+{
+	HAL_StatusTypeDef E2PStatus = HAL_OK;
+	EEP_WriteJobTypeDef jobs[EEP_MAX_DEVICES];
+	uint32_t uwUnit, uwOffset, uwChunk;
+	uint8_t n;
+
+	if(hEepStripe.DeviceCount == 0 || data_buf == NULL) return HAL_ERROR;
+	if(reg_address >= hEepStripe.Capacity || length > hEepStripe.Capacity - reg_address) return HAL_ERROR;
+
+	while((length > 0) && (E2PStatus == HAL_OK))
+	{
+		// consecutive units are on distinct chips, so a row never hits one chip twice
+		for(n = 0; (n < hEepStripe.DeviceCount) && (length > 0); n++)
+		{
+			uwUnit = reg_address / hEepStripe.StripeSize;
+			uwOffset = reg_address % hEepStripe.StripeSize;
+			uwChunk = EEP_CHUNK_LEN(reg_address, length, hEepStripe.StripeSize);
+
+			jobs[n].pDevice = hEepStripe.pDevices[uwUnit % hEepStripe.DeviceCount];
+			jobs[n].pBuffer = data_buf;
+			jobs[n].WriteAddr = (uwUnit / hEepStripe.DeviceCount) * hEepStripe.StripeSize + uwOffset;
+			jobs[n].NumByteToWrite = uwChunk;
+
+			reg_address += uwChunk;
+			data_buf += uwChunk;
+			length -= uwChunk;
+		}
+
+		E2PStatus = EEPROM_SPI_MultiWrite(jobs, n);
+	}
+
+	return E2PStatus;
+}
+
+/**
+  * @brief  reads a buffer from the striped volume. The units of one chip are
+  *         consecutive in its own address space, so every chip is read with a
+  *         single continuous READ that scatters into the user buffer.
+  * @param  reg_address: logical address starts from 0x00000000
+  * @param  data_buf: pointer to a user defined buffer for data to be copied
+  * @param  length: number of bytes to be restored statring from reg_address
+	* @retval HAL_StatusTypeDef enum, HAL_OK in case of successful operation
+  */
+//===================================================================================================
+HAL_StatusTypeDef BSP_EEPROM_Stripe_Read(uint32_t reg_address, uint8_t data_buf[], uint32_t length)
+//===================================================================================================
+{
+	HAL_StatusTypeDef E2PStatus = HAL_OK;
+	EEP_DeviceTypeDef* pSaved = pEeprom;
+	uint32_t uwFirst, uwLast, uwUnit, uwFrom, uwTo, uwEnd;
+	uint8_t ucCount = hEepStripe.DeviceCount;
+
+	if(ucCount == 0 || data_buf == NULL || length == 0) return HAL_ERROR;
+	if(reg_address >= hEepStripe.Capacity || length > hEepStripe.Capacity - reg_address) return HAL_ERROR;
+
+	uwEnd = reg_address + length;
+	uwFirst = reg_address / hEepStripe.StripeSize;
+	uwLast = (uwEnd - 1) / hEepStripe.StripeSize;
+
+	for(uint8_t c = 0; (c < ucCount) && (E2PStatus == HAL_OK); c++)
+	{
+		// first unit of the range that lives on chip c
+		uwUnit = uwFirst + (c + ucCount - (uwFirst % ucCount)) % ucCount;
+		if(uwUnit > uwLast) continue;
+
+		uwFrom = (uwUnit == uwFirst) ? reg_address : uwUnit * hEepStripe.StripeSize;
+
+		E2PStatus = EEPROM_SPI_Select(hEepStripe.pDevices[c]);
+		if(E2PStatus != HAL_OK) break;
+
+		E2PStatus = EEPROM_SPI_ReadStart((uwUnit / ucCount) * hEepStripe.StripeSize + uwFrom % hEepStripe.StripeSize);
+		for(; (uwUnit <= uwLast) && (E2PStatus == HAL_OK); uwUnit += ucCount)
+		{
+			uwFrom = uwUnit * hEepStripe.StripeSize;
+			uwTo = uwFrom + hEepStripe.StripeSize;
+			if(uwFrom < reg_address) uwFrom = reg_address;
+			if(uwTo > uwEnd) uwTo = uwEnd;
+
+			E2PStatus = EEPROM_SPI_ReadNext(&data_buf[uwFrom - reg_address], uwTo - uwFrom);
+		}
+		EEPROM_SPI_ReadStop();
+	}
+
+	if(EEPROM_SPI_Select(pSaved) != HAL_OK) E2PStatus = HAL_ERROR;
+	return E2PStatus;
+}
+
+/**
+  * @brief  benchmarks sequential volume writes and reads striped over 1, 2 and 4
+  *         chips (as many as given) and verifies the data read back
+  * @param  pDevices: device handles, one per chip select
+  * @param  ucCount: number of devices, up to EEP_MAX_DEVICES
+	* @retval HAL_StatusTypeDef enum, HAL_OK in case of successful operation
+  */
+//==================================================================================================
+HAL_StatusTypeDef BSP_EEPROM_Stripe_BenchmarkTest(EEP_DeviceTypeDef* pDevices[], uint8_t ucCount)
+//==================================================================================================
+{
+	HAL_StatusTypeDef E2PStatus = HAL_OK;
+	EEP_DeviceTypeDef* pSaved = pEeprom;
+	uint8_t ucRow[EEP_MAX_DEVICES * EEP_SPI_PAGESIZE];
+	uint8_t ucBack[EEP_MAX_DEVICES * EEP_SPI_PAGESIZE];
+	uint32_t uwRowSize, uwStart, uwWrite, uwRead;
+
+	EEP_LOG("EEPROM Striped Volume Benchmark, %d rows :\r\n\r\n", EEP_BENCH_PAGES);
+
+	for(uint8_t n = 1; (n <= ucCount) && (n <= EEP_MAX_DEVICES) && (E2PStatus == HAL_OK); n <<= 1)
+	{
+		E2PStatus = BSP_EEPROM_Stripe_Init(pDevices, n);
+		if(E2PStatus != HAL_OK) break;
+
+		uwRowSize = n * EEP_SPI_PAGESIZE;
+		if(uwRowSize * EEP_BENCH_PAGES > hEepStripe.Capacity) break;
+
+		uwStart = BSP_GetMicros();
+		for(uint16_t r = 0; (r < EEP_BENCH_PAGES) && (E2PStatus == HAL_OK); r++){
+			for(uint32_t i = 0; i < uwRowSize; i++) ucRow[i] = (uint8_t)(r * 7 + i);
+			E2PStatus = BSP_EEPROM_Stripe_Write(r * uwRowSize, ucRow, uwRowSize);
+		}
+		for(uint8_t d = 0; (d < n) && (E2PStatus == HAL_OK); d++){
+			E2PStatus = EEPROM_SPI_Select(pDevices[d]);
+			if(E2PStatus == HAL_OK) E2PStatus = EEPROM_SPI_WaitReady();
+		}
+		uwWrite = BSP_GetMicros() - uwStart;
+
+		uwRead = 0;
+		for(uint16_t r = 0; (r < EEP_BENCH_PAGES) && (E2PStatus == HAL_OK); r++){
+			uwStart = BSP_GetMicros();
+			E2PStatus = BSP_EEPROM_Stripe_Read(r * uwRowSize, ucBack, uwRowSize);
+			uwRead += BSP_GetMicros() - uwStart;
+
+			for(uint32_t i = 0; (i < uwRowSize) && (E2PStatus == HAL_OK); i++){
+				if(ucBack[i] != (uint8_t)(r * 7 + i)) E2PStatus = HAL_ERROR;
+			}
+		}
+		if(uwWrite == 0) uwWrite = 1;
+		if(uwRead == 0) uwRead = 1;
+
+		EEP_LOG("%d chip(s): write %lu us/page, %lu B/s, read %lu B/s %s\r\n", n,
+						(unsigned long)(uwWrite / (EEP_BENCH_PAGES * n)),
+						(unsigned long)((uint64_t)uwRowSize * EEP_BENCH_PAGES * 1000000 / uwWrite),
+						(unsigned long)((uint64_t)uwRowSize * EEP_BENCH_PAGES * 1000000 / uwRead),
+						(E2PStatus == HAL_OK) ? "Passed" : "Failed");
+	}
+
+	if(EEPROM_SPI_Select(pSaved) != HAL_OK) E2PStatus = HAL_ERROR;
+	return E2PStatus;
+}
+
+
+//=======================================================================================
+//================================== Mirrored volume ====================================
+//=======================================================================================
+
+EEP_MirrorTypeDef hEepMirror;
+
+#define MIRROR_DATA_SIZE								 (uint32_t)(hEepMirror.PageSize - EEP_MIRROR_CRC_SIZE)
+#define MIRROR_IS_STALE(c, page)				 ((hEepMirror.Stale[c][(page) >> 3] >> ((page) & 7)) & 0x01)
+#define MIRROR_SET_STALE(c, page)				 (hEepMirror.Stale[c][(page) >> 3] |= (uint8_t)(1 << ((page) & 7)))
+#define MIRROR_CLR_STALE(c, page)				 (hEepMirror.Stale[c][(page) >> 3] &= (uint8_t)~(1 << ((page) & 7)))
+
+/**
+  * @brief  builds the mirrored volume from two chips of the same geometry
+  * @param  pDevice0: first copy
+  * @param  pDevice1: second copy
+	* @retval HAL_StatusTypeDef enum, HAL_OK in case of successful operation
+  */
+//=====================================================================================================
+HAL_StatusTypeDef BSP_EEPROM_Mirror_Init(EEP_DeviceTypeDef* pDevice0, EEP_DeviceTypeDef* pDevice1)
+//=====================================================================================================
+{
+	memset(&hEepMirror, 0, sizeof(hEepMirror));
+
+	if(pDevice0 == NULL || pDevice1 == NULL || pDevice0 == pDevice1) return HAL_ERROR;
+	if(pDevice0->PageSize != pDevice1->PageSize) return HAL_ERROR;
+	if(pDevice0->PageSize > EEP_MIRROR_PAGE_MAX || pDevice0->PageSize <= EEP_MIRROR_CRC_SIZE) return HAL_ERROR;
+
+	hEepMirror.pDevices[0] = pDevice0;
+	hEepMirror.pDevices[1] = pDevice1;
+	hEepMirror.PageSize = pDevice0->PageSize;
+	hEepMirror.PageCount = ((pDevice0->Capacity < pDevice1->Capacity) ? pDevice0->Capacity : pDevice1->Capacity) / hEepMirror.PageSize;
+	if(hEepMirror.PageCount > EEP_MIRROR_MAX_PAGES) hEepMirror.PageCount = EEP_MIRROR_MAX_PAGES;
+	hEepMirror.Capacity = hEepMirror.PageCount * MIRROR_DATA_SIZE;
+
+	return HAL_OK;
+}
+
+/**
+  * @brief  checks a physical page image, a never written (all 0xFF) page is valid too
+  * @param  pPage: page data followed by its CRC
+	* @retval 1 if the page can be trusted
+  */
+//==============================================
+static uint8_t BSP_EEPROM_Mirror_PageValid(uint8_t* pPage)
+//==============================================
+{
+	uint16_t uiCrc = EEPROM_SPI_Crc16(0xFFFF, pPage, MIRROR_DATA_SIZE);
+	uint8_t ucBlank = 1;
+
+	if((pPage[MIRROR_DATA_SIZE] == (uint8_t)(uiCrc >> 8)) && (pPage[MIRROR_DATA_SIZE + 1] == (uint8_t)uiCrc)) return 1;
+
+	for(uint32_t i = 0; (i < hEepMirror.PageSize) && ucBlank; i++){
+		if(pPage[i] != 0xFF) ucBlank = 0;
+	}
+	return ucBlank;
+}
+
+/**
+  * @brief  reads one page copy from a chip and checks it
+  * @param  ucChip: 0 or 1
+  * @param  uwPage: physical page number
+  * @param  pPage: page buffer of PageSize bytes
+  * @param  pValid: set to 1 if the copy passes its CRC, 0 if not
+	* @retval HAL_StatusTypeDef enum, HAL_OK if the copy could be read
+  */
+//=====================================================================================================================
+static HAL_StatusTypeDef BSP_EEPROM_Mirror_ReadCopy(uint8_t ucChip, uint32_t uwPage, uint8_t* pPage, uint8_t* pValid)
+//=====================================================================================================================
+{
+	*pValid = 0;
+	if(EEPROM_SPI_Select(hEepMirror.pDevices[ucChip]) != HAL_OK) return HAL_ERROR;
+	if(EEPROM_SPI_ReadBuffer(pPage, uwPage * hEepMirror.PageSize, hEepMirror.PageSize) != HAL_OK) return HAL_ERROR;
+
+	*pValid = BSP_EEPROM_Mirror_PageValid(pPage);
+	return HAL_OK;
+}
+
+/**
+  * @brief  reads a page from whichever good copy is free first, falling back to
+  *         the other one on a CRC mismatch or a bus error
+  * @param  uwPage: physical page number
+  * @param  pPage: page buffer of PageSize bytes
+  * @param  pLost: if not NULL, set to 1 when both copies were read and neither
+  *         passes its CRC, so the page content is gone rather than unreachable
+	* @retval HAL_StatusTypeDef enum, HAL_OK in case of successful operation
+  */
+//====================================================================================================
+static HAL_StatusTypeDef BSP_EEPROM_Mirror_ReadPage(uint32_t uwPage, uint8_t* pPage, uint8_t* pLost)
+//====================================================================================================
+{
+	uint8_t ucFirst = 0, ucValid, ucReadable;
+
+	if(pLost != NULL) *pLost = 0;
+
+	// a known stale copy goes last, then prefer a chip that is not inside a write cycle
+	if(MIRROR_IS_STALE(0, uwPage)){
+		ucFirst = 1;
+	}
+	else if(!MIRROR_IS_STALE(1, uwPage)){
+		EEPROM_SPI_Select(hEepMirror.pDevices[0]);
+		if(EEPROM_SPI_PollReady() != HAL_OK){
+			EEPROM_SPI_Select(hEepMirror.pDevices[1]);
+			if(EEPROM_SPI_PollReady() == HAL_OK) ucFirst = 1;
+		}
+	}
+
+	ucReadable = (BSP_EEPROM_Mirror_ReadCopy(ucFirst, uwPage, pPage, &ucValid) == HAL_OK);
+	if(ucValid) return HAL_OK;
+
+	MIRROR_SET_STALE(ucFirst, uwPage);
+	hEepMirror.Fallbacks++;
+
+	if(BSP_EEPROM_Mirror_ReadCopy(ucFirst ^ 1, uwPage, pPage, &ucValid) != HAL_OK) return HAL_ERROR;
+	if(!ucValid){
+		if(pLost != NULL) *pLost = ucReadable;
+		return HAL_ERROR;
+	}
+
+	// the good copy was just confirmed, whatever the bitmap said before
+	MIRROR_CLR_STALE(ucFirst ^ 1, uwPage);
+	return HAL_OK;
+}
+
+/**
+  * @brief  seals a page with its CRC and writes it to both chips, the two write
+  *         cycles overlap. A chip that fails is marked stale and left for resync.
+  * @param  uwPage: physical page number
+  * @param  pPage: page buffer of PageSize bytes, the CRC bytes get filled in
+	* @retval HAL_StatusTypeDef enum, HAL_OK if at least one copy was written
+  */
+//=======================================================================================
+static HAL_StatusTypeDef BSP_EEPROM_Mirror_WritePage(uint32_t uwPage, uint8_t* pPage)
+//=======================================================================================
+{
+	EEP_DeviceTypeDef* pSaved = pEeprom;
+	EEP_WriteJobTypeDef jobs[2];
+	uint16_t uiCrc = EEPROM_SPI_Crc16(0xFFFF, pPage, MIRROR_DATA_SIZE);
+	uint8_t ucWritten = 0;
+
+	pPage[MIRROR_DATA_SIZE] = (uint8_t)(uiCrc >> 8);
+	pPage[MIRROR_DATA_SIZE + 1] = (uint8_t)uiCrc;
+
+	for(uint8_t c = 0; c < 2; c++){
+		jobs[c].pDevice = hEepMirror.pDevices[c];
+		jobs[c].pBuffer = pPage;
+		jobs[c].WriteAddr = uwPage * hEepMirror.PageSize;
+		jobs[c].NumByteToWrite = hEepMirror.PageSize;
+	}
+
+	if(EEPROM_SPI_MultiWrite(jobs, 2) == HAL_OK){
+		MIRROR_CLR_STALE(0, uwPage);
+		MIRROR_CLR_STALE(1, uwPage);
+		return HAL_OK;
+	}
+
+	// find out which chip let us down, the other copy keeps the volume alive
+	for(uint8_t c = 0; c < 2; c++)
+	{
+		if(jobs[c].NumByteToWrite != 0){
+			if((EEPROM_SPI_Select(hEepMirror.pDevices[c]) != HAL_OK) ||
+				 (EEPROM_SPI_WritePage(pPage, uwPage * hEepMirror.PageSize, hEepMirror.PageSize) != HAL_OK)){
+				MIRROR_SET_STALE(c, uwPage);
+				continue;
+			}
+		}
+		MIRROR_CLR_STALE(c, uwPage);
+		ucWritten++;
+	}
+
+	EEPROM_SPI_Select(pSaved);
+	return (ucWritten != 0) ? HAL_OK : HAL_ERROR;
+}
+
+/**
+  * @brief  writes a buffer to both copies of the mirrored volume
+  * @param  reg_address: logical address starts from 0x00000000
+  * @param  data_buf: pointer to a user defined buffer for data to be copied
+  * @param  length: number of bytes to be written statring from reg_address
+	* @retval HAL_StatusTypeDef enum, HAL_OK in case of successful operation
+  */
+//====================================================================================================
+HAL_StatusTypeDef BSP_EEPROM_Mirror_Write(uint32_t reg_address, uint8_t data_buf[], uint32_t length)
+//====================================================================================================
+{
+	HAL_StatusTypeDef E2PStatus = HAL_OK;
+	EEP_DeviceTypeDef* pSaved = pEeprom;
+	uint8_t ucPage[EEP_MIRROR_PAGE_MAX];
+	uint32_t uwPage, uwOffset, uwChunk;
+	uint8_t ucLost;
+
+	if(hEepMirror.PageCount == 0 || data_buf == NULL) return HAL_ERROR;
+	if(reg_address >= hEepMirror.Capacity || length > hEepMirror.Capacity - reg_address) return HAL_ERROR;
+
+	while((length > 0) && (E2PStatus == HAL_OK))
+	{
+		uwPage = reg_address / MIRROR_DATA_SIZE;
+		uwOffset = reg_address % MIRROR_DATA_SIZE;
+		uwChunk = EEP_CHUNK_LEN(reg_address, length, MIRROR_DATA_SIZE);
+
+		// the CRC covers the whole page, so partial pages are read-modify-write.
+		// Only a page that neither copy can vouch for starts over blank, a bus
+		// error would have the rest of the page overwritten on both chips
+		if(uwChunk != MIRROR_DATA_SIZE){
+			E2PStatus = BSP_EEPROM_Mirror_ReadPage(uwPage, ucPage, &ucLost);
+			if((E2PStatus != HAL_OK) && ucLost){
+				memset(ucPage, 0xFF, hEepMirror.PageSize);
+				E2PStatus = HAL_OK;
+			}
+			if(E2PStatus != HAL_OK) break;
+		}
+		memcpy(&ucPage[uwOffset], data_buf, uwChunk);
+
+		E2PStatus = BSP_EEPROM_Mirror_WritePage(uwPage, ucPage);
+
+		reg_address += uwChunk;
+		data_buf += uwChunk;
+		length -= uwChunk;
+	}
+
+	if(EEPROM_SPI_Select(pSaved) != HAL_OK) E2PStatus = HAL_ERROR;
+	return E2PStatus;
+}
+
+/**
+  * @brief  reads a buffer from the mirrored volume, every page comes from a copy
+  *         that is free and passes its CRC
+  * @param  reg_address: logical address starts from 0x00000000
+  * @param  data_buf: pointer to a user defined buffer for data to be copied
+  * @param  length: number of bytes to be restored statring from reg_address
+	* @retval HAL_StatusTypeDef enum, HAL_OK in case of successful operation
+  */
+//===================================================================================================
+HAL_StatusTypeDef BSP_EEPROM_Mirror_Read(uint32_t reg_address, uint8_t data_buf[], uint32_t length)
+//===================================================================================================
+{
+	HAL_StatusTypeDef E2PStatus = HAL_OK;
+	EEP_DeviceTypeDef* pSaved = pEeprom;
+	uint8_t ucPage[EEP_MIRROR_PAGE_MAX];
+	uint32_t uwOffset, uwChunk;
+
+	if(hEepMirror.PageCount == 0 || data_buf == NULL) return HAL_ERROR;
+	if(reg_address >= hEepMirror.Capacity || length > hEepMirror.Capacity - reg_address) return HAL_ERROR;
+
+	while((length > 0) && (E2PStatus == HAL_OK))
+	{
+		uwOffset = reg_address % MIRROR_DATA_SIZE;
+		uwChunk = EEP_CHUNK_LEN(reg_address, length, MIRROR_DATA_SIZE);
+
+		E2PStatus = BSP_EEPROM_Mirror_ReadPage(reg_address / MIRROR_DATA_SIZE, ucPage, NULL);
+		if(E2PStatus != HAL_OK) break;
+		memcpy(data_buf, &ucPage[uwOffset], uwChunk);
+
+		reg_address += uwChunk;
+		data_buf += uwChunk;
+		length -= uwChunk;
+	}
+
+	if(EEPROM_SPI_Select(pSaved) != HAL_OK) E2PStatus = HAL_ERROR;
+	return E2PStatus;
+}
+
+/**
+  * @brief  low priority background work, call it from the idle loop. Each call
+  *         repairs one stale page copy, or when none is known, scrubs the next
+  *         page by checking both copies. It backs off while a chip is busy.
+  *         A page with no valid copy left is counted as lost and dropped from
+  *         the bitmaps, it stays unreadable until the next write of it.
+	* @retval HAL_OK when done for now, HAL_BUSY if a chip was busy, HAL_ERROR on failure
+  */
+//==============================================
+HAL_StatusTypeDef BSP_EEPROM_Mirror_Resync(void)
+//==============================================
+{
+	HAL_StatusTypeDef E2PStatus = HAL_OK;
+	EEP_DeviceTypeDef* pSaved = pEeprom;
+	uint8_t ucPage[EEP_MIRROR_PAGE_MAX];
+	uint8_t ucCopy[EEP_MIRROR_PAGE_MAX];
+	uint32_t uwPage = hEepMirror.PageCount;
+	uint8_t ucGood[2], ucLost;
+
+	if(hEepMirror.PageCount == 0) return HAL_ERROR;
+
+	// never make a foreground access wait on us
+	for(uint8_t c = 0; c < 2; c++){
+		EEPROM_SPI_Select(hEepMirror.pDevices[c]);
+		if(EEPROM_SPI_PollReady() != HAL_OK) E2PStatus = HAL_BUSY;
+	}
+
+	if(E2PStatus == HAL_OK)
+	{
+		for(uint32_t i = 0; i < (hEepMirror.PageCount + 7) / 8; i++){
+			if((hEepMirror.Stale[0][i] | hEepMirror.Stale[1][i]) != 0){
+				uwPage = i * 8;
+				while(!MIRROR_IS_STALE(0, uwPage) && !MIRROR_IS_STALE(1, uwPage)) uwPage++;
+				break;
+			}
+		}
+
+		if(uwPage < hEepMirror.PageCount)
+		{
+			// the good copy already carries its CRC, only the stale chip gets written
+			E2PStatus = BSP_EEPROM_Mirror_ReadPage(uwPage, ucPage, &ucLost);
+			if((E2PStatus != HAL_OK) && ucLost){
+				// nothing to repair from, move on to the other stale pages
+				MIRROR_CLR_STALE(0, uwPage);
+				MIRROR_CLR_STALE(1, uwPage);
+				hEepMirror.Lost++;
+				E2PStatus = HAL_OK;
+			}
+			for(uint8_t c = 0; (c < 2) && (E2PStatus == HAL_OK); c++)
+			{
+				if(!MIRROR_IS_STALE(c, uwPage)) continue;
+
+				E2PStatus = EEPROM_SPI_Select(hEepMirror.pDevices[c]);
+				if(E2PStatus == HAL_OK) E2PStatus = EEPROM_SPI_WritePage(ucPage, uwPage * hEepMirror.PageSize, hEepMirror.PageSize);
+				if(E2PStatus == HAL_OK){
+					MIRROR_CLR_STALE(c, uwPage);
+					hEepMirror.Repairs++;
+				}
+			}
+		}
+		else
+		{
+			uwPage = hEepMirror.ScrubPage;
+			hEepMirror.ScrubPage = (uwPage + 1) % hEepMirror.PageCount;
+
+			ucLost = 1;
+			if(BSP_EEPROM_Mirror_ReadCopy(0, uwPage, ucPage, &ucGood[0]) != HAL_OK) ucGood[0] = ucLost = 0;
+			if(BSP_EEPROM_Mirror_ReadCopy(1, uwPage, ucCopy, &ucGood[1]) != HAL_OK) ucGood[1] = ucLost = 0;
+
+			if(ucGood[0] && ucGood[1] && (memcmp(ucPage, ucCopy, hEepMirror.PageSize) != 0)){
+				// both sealed but different: a write was torn between the chips, take copy 0
+				MIRROR_SET_STALE(1, uwPage);
+			}
+			else if(!ucGood[0] && !ucGood[1] && ucLost){
+				// both read back and neither passes its CRC, a repair has no source
+				hEepMirror.Lost++;
+			}
+			else{
+				if(!ucGood[0]) MIRROR_SET_STALE(0, uwPage);
+				if(!ucGood[1]) MIRROR_SET_STALE(1, uwPage);
+			}
+		}
+	}
+
+	EEPROM_SPI_Select(pSaved);
+	return E2PStatus;
+}
@@ -0,0 +1,68 @@
+/**
+  ******************************************************************************
+  * @file    BSP_EEPROM_Volume.h
+  * @author  Hossein Bagherzade(@realhba)
+	* @email	 hossein.bagherzade@gmail.com
+  * @version V1.0.0
+  * @date    18-Oct-2026
+  * @brief   Header file for BSP_EEPROM_Volume.c
+  ******************************************************************************
+	**/
+
+
+#ifndef __BSP_EEPROM_VOLUME_H
+#define __BSP_EEPROM_VOLUME_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "BSP_EEPROM.h"
+
+
+#define EEP_MIRROR_CRC_SIZE							 (uint8_t)2 			// CRC-16 kept in the last bytes of every page
+#define EEP_MIRROR_PAGE_MAX							 (uint16_t)64 		// largest physical page a mirror handles
+#define EEP_MIRROR_MAX_PAGES						 (uint32_t)512 		// pages tracked by the stale bitmaps
+
+typedef struct
+{
+	EEP_DeviceTypeDef* pDevices[EEP_MAX_DEVICES];								// member chips, stripe unit u lives on chip u % DeviceCount
+	uint8_t  DeviceCount;
+	uint16_t StripeSize;																				// bytes per stripe unit, the common page size
+	uint32_t Capacity;																					// logical size in bytes
+} EEP_StripeTypeDef;
+
+typedef struct
+{
+	EEP_DeviceTypeDef* pDevices[2];															// the two copies
+	uint16_t PageSize;																					// physical page, data plus CRC
+	uint32_t PageCount;
+	uint32_t Capacity;																					// logical size in bytes
+	uint32_t ScrubPage;																					// next page the background resync checks
+	uint8_t  Stale[2][EEP_MIRROR_MAX_PAGES / 8];								// page copies known to be bad, per chip
+	uint32_t Fallbacks;																					// statistics: reads served by the other copy
+	uint32_t Repairs;																						// statistics: pages rewritten by the resync
+	uint32_t Lost;																							// statistics: pages the resync found with no valid copy
+} EEP_MirrorTypeDef;
+
+
+extern EEP_StripeTypeDef hEepStripe;
+extern EEP_MirrorTypeDef hEepMirror;
+
+HAL_StatusTypeDef BSP_EEPROM_Stripe_Init(EEP_DeviceTypeDef* pDevices[], uint8_t ucCount);
+HAL_StatusTypeDef BSP_EEPROM_Stripe_Write(uint32_t reg_address, uint8_t data_buf[], uint32_t length);
+HAL_StatusTypeDef BSP_EEPROM_Stripe_Read(uint32_t reg_address, uint8_t data_buf[], uint32_t length);
+HAL_StatusTypeDef BSP_EEPROM_Stripe_BenchmarkTest(EEP_DeviceTypeDef* pDevices[], uint8_t ucCount);
+
+HAL_StatusTypeDef BSP_EEPROM_Mirror_Init(EEP_DeviceTypeDef* pDevice0, EEP_DeviceTypeDef* pDevice1);
+HAL_StatusTypeDef BSP_EEPROM_Mirror_Write(uint32_t reg_address, uint8_t data_buf[], uint32_t length);
+HAL_StatusTypeDef BSP_EEPROM_Mirror_Read(uint32_t reg_address, uint8_t data_buf[], uint32_t length);
+HAL_StatusTypeDef BSP_EEPROM_Mirror_Resync(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __BSP_EEPROM_VOLUME_H */
+
@@ -0,0 +1,335 @@
+/**
+  ******************************************************************************
+  * @file    BSP_EEPROM_Wave.c
+  * @author  Hossein Bagherzade(@realhba)
+	* @email	 hossein.bagherzade@gmail.com
+  * @version V1.0.0
+  * @date    18-Oct-2026
+  * @brief   Timer paced bit-bang SPI for the data phases of the soft path. The
+  * bytes are turned into one GPIO BSRR word per half clock period up front,
+  * TIM1 update events move them to the port with DMA and TIM1 CH4, half way
+  * through each half period, copies IDR into a sample buffer with a second
+  * DMA channel. The CPU idles during the transfer and packs MISO afterwards,
+  * the bit rate only depends on the timer. EEPROM_Wave_Build/Pack are pure,
+  * with BSP_EEPROM_SIM the words are replayed into the bus model instead.
+  ******************************************************************************
+	**/
+
+#include "BSP_EEPROM_Wave.h"
+#include "main.h"
+
+/**
+  * @brief  turns bytes into BSRR words, MSB first in SPI mode 0: SCK low with
+  *         the new MOSI level, then SCK high for the device to sample it. SCK
+  *         is left high as by EEPROM_SoftSPI_SendByte
+  * @param  pWave: output, 16 words per byte
+  * @param  pTx: bytes to send, NULL leaves MOSI as it is (read phases)
+  * @param  uiLen: number of bytes
+	* @retval number of words
+  */
+//===============================================================================
+uint16_t EEPROM_Wave_Build(uint32_t* pWave, const uint8_t* pTx, uint16_t uiLen)
+//===============================================================================
+{
+	uint32_t* p = pWave;
+
+	for(uint16_t i = 0; i < uiLen; i++)
+	{
+		for(uint8_t ucMask = 0x80; ucMask != 0; ucMask >>= 1)
+		{
+			*p = (uint32_t)EEP_CLK_Pin << 16;
+			if(pTx != NULL) *p |= (pTx[i] & ucMask) ? (uint32_t)EEP_MOSI_Pin : (uint32_t)EEP_MOSI_Pin << 16;
+			p++;
+			*p++ = (uint32_t)EEP_CLK_Pin;
+		}
+	}
+
+	return (uint16_t)(p - pWave);
+}
+
+/**
+  * @brief  packs MISO out of the IDR samples of a run. Sample 0 is taken before
+  *         the first word, sample n+1 after word n, so bit k of the run is in
+  *         sample 2k+2, the middle of its SCK high time
+  * @param  pRx: output bytes
+  * @param  pSample: IDR samples
+  * @param  uiLen: number of bytes
+	* @retval none
+  */
+//============================================================================
+void EEPROM_Wave_Pack(uint8_t* pRx, const uint16_t* pSample, uint16_t uiLen)
+//============================================================================
+{
+	const uint16_t* p = pSample + 2;
+	uint8_t ucByte;
+
+	for(uint16_t i = 0; i < uiLen; i++)
+	{
+		ucByte = 0;
+		for(uint8_t b = 0; b < 8; b++, p += 2)
+		{
+			ucByte = (uint8_t)((ucByte << 1) | ((*p & EEP_MISO_Pin) != 0));
+		}
+		pRx[i] = ucByte;
+	}
+}
+
+
+#if (USE_SOFTSPI_WAVE == 1)
+
+EEP_WaveTypeDef hEepWave;
+
+#ifndef BSP_EEPROM_SIM
+
+/**
+  * @brief  end of the IDR channel, the last sample is in: stop the timer
+  * @param  hdma: DMA handle
+	* @retval none
+  */
+//=====================================================
+static void EEPROM_Wave_Done(DMA_HandleTypeDef* hdma)
+//=====================================================
+{
+	__HAL_TIM_DISABLE(&hEepWave.hTim);
+	__HAL_TIM_DISABLE_DMA(&hEepWave.hTim, TIM_DMA_UPDATE | TIM_DMA_CC4);
+	HAL_DMA_Abort(&hEepWave.hDmaOut);
+
+	hEepWave.Busy = 0;
+}
+
+/**
+  * @brief  sets up TIM1 and the two DMA channels, pins are left to EEPROM_SoftSPI_Init
+	* @retval HAL_StatusTypeDef enum, HAL_OK in case of successful operation
+  */
+//==============================================
+HAL_StatusTypeDef EEPROM_Wave_Init(void)
+//==============================================
+{
+	EEP_WAVE_TIM_CLK_ENABLE();
+	EEP_WAVE_DMA_CLK_ENABLE();
+
+	hEepWave.hTim.Instance = EEP_WAVE_TIM;
+	hEepWave.hTim.Init.Prescaler = 0;
+	hEepWave.hTim.Init.CounterMode = TIM_COUNTERMODE_UP;
+	hEepWave.hTim.Init.Period = EEP_WAVE_HALF_TICKS_MIN - 1;
+	hEepWave.hTim.Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
+	hEepWave.hTim.Init.RepetitionCounter = 0;
+	hEepWave.hTim.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_DISABLE;
+	if(HAL_TIM_Base_Init(&hEepWave.hTim) != HAL_OK) return HAL_ERROR;
+
+	hEepWave.hDmaOut.Instance = EEP_WAVE_DMA_OUT;
+	hEepWave.hDmaOut.Init.Direction = DMA_MEMORY_TO_PERIPH;
+	hEepWave.hDmaOut.Init.PeriphInc = DMA_PINC_DISABLE;
+	hEepWave.hDmaOut.Init.MemInc = DMA_MINC_ENABLE;
+	hEepWave.hDmaOut.Init.PeriphDataAlignment = DMA_PDATAALIGN_WORD;
+	hEepWave.hDmaOut.Init.MemDataAlignment = DMA_MDATAALIGN_WORD;
+	hEepWave.hDmaOut.Init.Mode = DMA_NORMAL;
+	hEepWave.hDmaOut.Init.Priority = DMA_PRIORITY_VERY_HIGH;
+	if(HAL_DMA_Init(&hEepWave.hDmaOut) != HAL_OK) return HAL_ERROR;
+
+	hEepWave.hDmaIn.Instance = EEP_WAVE_DMA_IN;
+	hEepWave.hDmaIn.Init.Direction = DMA_PERIPH_TO_MEMORY;
+	hEepWave.hDmaIn.Init.PeriphInc = DMA_PINC_DISABLE;
+	hEepWave.hDmaIn.Init.MemInc = DMA_MINC_ENABLE;
+	hEepWave.hDmaIn.Init.PeriphDataAlignment = DMA_PDATAALIGN_HALFWORD;
+	hEepWave.hDmaIn.Init.MemDataAlignment = DMA_MDATAALIGN_HALFWORD;
+	hEepWave.hDmaIn.Init.Mode = DMA_NORMAL;
+	hEepWave.hDmaIn.Init.Priority = DMA_PRIORITY_HIGH;
+	if(HAL_DMA_Init(&hEepWave.hDmaIn) != HAL_OK) return HAL_ERROR;
+	hEepWave.hDmaIn.XferCpltCallback = EEPROM_Wave_Done;
+
+	HAL_NVIC_SetPriority(EEP_WAVE_DMA_IRQn, EEP_WAVE_DMA_IRQ_PRIORITY, 0);
+	HAL_NVIC_EnableIRQ(EEP_WAVE_DMA_IRQn);
+
+	hEepWave.Busy = 0;
+	hEepWave.Ready = 1;
+
+	return HAL_OK;
+}
+
+/**
+  * @brief  clocks out the first uiWords words of hEepWave.Wave and samples IDR
+  *         uiWords + 1 times, the half period follows pEeprom->ClkStep
+  * @param  uiWords: number of words, up to EEP_WAVE_WORDS
+	* @retval HAL_StatusTypeDef enum, HAL_OK once the run is started
+  */
+//=====================================================
+HAL_StatusTypeDef EEPROM_Wave_Start(uint16_t uiWords)
+//=====================================================
+{
+	uint32_t uwHalf = (uint32_t)EEP_WAVE_HALF_TICKS_MIN << pEeprom->ClkStep;
+
+	if(uiWords == 0 || uiWords > EEP_WAVE_WORDS || hEepWave.Busy) return HAL_ERROR;
+
+	// counter at 0: CC4 samples once before the first update writes word 0
+	__HAL_TIM_DISABLE(&hEepWave.hTim);
+	__HAL_TIM_SET_AUTORELOAD(&hEepWave.hTim, uwHalf - 1);
+	__HAL_TIM_SET_COMPARE(&hEepWave.hTim, TIM_CHANNEL_4, uwHalf / 2);
+	__HAL_TIM_SET_COUNTER(&hEepWave.hTim, 0);
+	__HAL_TIM_CLEAR_FLAG(&hEepWave.hTim, TIM_FLAG_UPDATE | TIM_FLAG_CC4);
+
+	hEepWave.Busy = 1;
+	if(HAL_DMA_Start(&hEepWave.hDmaOut, (uint32_t)hEepWave.Wave, (uint32_t)&EEP_WAVE_GPIO->BSRR, uiWords) != HAL_OK ||
+		 HAL_DMA_Start_IT(&hEepWave.hDmaIn, (uint32_t)&EEP_WAVE_GPIO->IDR, (uint32_t)hEepWave.Sample, uiWords + 1) != HAL_OK)
+	{
+		HAL_DMA_Abort(&hEepWave.hDmaOut);
+		hEepWave.Busy = 0;
+		return HAL_ERROR;
+	}
+
+	__HAL_TIM_ENABLE_DMA(&hEepWave.hTim, TIM_DMA_UPDATE | TIM_DMA_CC4);
+	__HAL_TIM_ENABLE(&hEepWave.hTim);
+
+	return HAL_OK;
+}
+
+/**
+  * @brief  idles until the run is done, a run that overstays is stopped
+  * @param  uiWords: words of the run
+	* @retval HAL_StatusTypeDef enum, HAL_OK when the run is done
+  */
+//===========================================================
+static HAL_StatusTypeDef EEPROM_Wave_Wait(uint16_t uiWords)
+//===========================================================
+{
+	// four times the nominal run time covers any APB prescaler
+	uint32_t uwTicks = (uint32_t)uiWords * ((uint32_t)EEP_WAVE_HALF_TICKS_MIN << pEeprom->ClkStep);
+	BSP_DeadlineTypeDef deadline = BSP_Deadline_After(EEPROM_SPI_FLAG_TIMEOUT_US + 4 * (uwTicks / (SystemCoreClock / 1000000)));
+
+	while(hEepWave.Busy)
+	{
+		if(BSP_Deadline_Expired(deadline))
+		{
+			__HAL_TIM_DISABLE(&hEepWave.hTim);
+			__HAL_TIM_DISABLE_DMA(&hEepWave.hTim, TIM_DMA_UPDATE | TIM_DMA_CC4);
+			HAL_DMA_Abort(&hEepWave.hDmaOut);
+			HAL_DMA_Abort(&hEepWave.hDmaIn);
+			hEepWave.Busy = 0;
+			return HAL_TIMEOUT;
+		}
+		BSP_Timebase_IdleHook(0);
+	}
+
+	return HAL_OK;
+}
+
+/**
+  * @brief  DMA interrupt, must be called from DMA1_Channel4_5_IRQHandler
+	* @retval none
+  */
+//==============================================
+void EEPROM_Wave_IRQHandler(void)
+//==============================================
+{
+	HAL_DMA_IRQHandler(&hEepWave.hDmaIn);
+}
+
+#else
+
+/**
+  * @brief  host build, nothing to set up
+	* @retval HAL_OK
+  */
+//==============================================
+HAL_StatusTypeDef EEPROM_Wave_Init(void)
+//==============================================
+{
+	hEepWave.Busy = 0;
+	hEepWave.Ready = 1;
+
+	return HAL_OK;
+}
+
+/**
+  * @brief  host build: the words drive the bus model one by one and IDR is
+  *         sampled after each, as CC4 does half way through the half period
+  * @param  uiWords: number of words, up to EEP_WAVE_WORDS
+	* @retval HAL_StatusTypeDef enum, HAL_OK when the run is done
+  */
+//=====================================================
+HAL_StatusTypeDef EEPROM_Wave_Start(uint16_t uiWords)
+//=====================================================
+{
+	uint32_t w;
+
+	if(uiWords == 0 || uiWords > EEP_WAVE_WORDS) return HAL_ERROR;
+
+	hEepWave.Sample[0] = EEPROM_Sim_GetSO() ? EEP_MISO_Pin : 0;
+	for(uint16_t i = 0; i < uiWords; i++)
+	{
+		w = hEepWave.Wave[i];
+		if(w & ((uint32_t)EEP_MOSI_Pin << 16)) EEPROM_Sim_SetPin(EEP_SIM_PIN_SI, 0);
+		if(w & EEP_MOSI_Pin) EEPROM_Sim_SetPin(EEP_SIM_PIN_SI, 1);
+		if(w & ((uint32_t)EEP_CLK_Pin << 16)) EEPROM_Sim_SetPin(EEP_SIM_PIN_CK, 0);
+		if(w & EEP_CLK_Pin) EEPROM_Sim_SetPin(EEP_SIM_PIN_CK, 1);
+		hEepWave.Sample[i + 1] = EEPROM_Sim_GetSO() ? EEP_MISO_Pin : 0;
+	}
+
+	return HAL_OK;
+}
+
+/**
+  * @brief  host build, runs complete inside EEPROM_Wave_Start
+  * @param  uiWords: words of the run
+	* @retval HAL_OK
+  */
+//===========================================================
+static HAL_StatusTypeDef EEPROM_Wave_Wait(uint16_t uiWords)
+//===========================================================
+{
+	(void)uiWords;
+
+	return HAL_OK;
+}
+
+#endif /* BSP_EEPROM_SIM */
+
+/**
+  * @brief  true while a run is on the wire
+	* @retval 1 if busy
+  */
+//==============================================
+uint8_t EEPROM_Wave_IsBusy(void)
+//==============================================
+{
+	return hEepWave.Busy;
+}
+
+/**
+  * @brief  clocks a data phase in runs of EEP_WAVE_CHUNK bytes, CS is left to
+  *         the caller. The CPU idles in BSP_Timebase_IdleHook during each run
+  *         and builds or packs between runs, SCK stays high meanwhile
+  * @param  pTx: bytes to send, NULL for a read phase
+  * @param  pRx: received bytes, NULL for a write phase
+  * @param  uwLen: number of bytes
+	* @retval HAL_StatusTypeDef enum, HAL_OK in case of successful operation
+  */
+//========================================================================================
+HAL_StatusTypeDef EEPROM_Wave_Transfer(const uint8_t* pTx, uint8_t* pRx, uint32_t uwLen)
+//========================================================================================
+{
+	uint16_t uiLen, uiWords;
+
+	if(!hEepWave.Ready && EEPROM_Wave_Init() != HAL_OK) return HAL_ERROR;
+
+	while(uwLen != 0)
+	{
+		uiLen = (uwLen > EEP_WAVE_CHUNK) ? EEP_WAVE_CHUNK : (uint16_t)uwLen;
+		uiWords = EEPROM_Wave_Build(hEepWave.Wave, pTx, uiLen);
+
+		if(EEPROM_Wave_Start(uiWords) != HAL_OK) return HAL_ERROR;
+
+		if(EEPROM_Wave_Wait(uiWords) != HAL_OK) return HAL_TIMEOUT;
+
+		if(pRx != NULL){
+			EEPROM_Wave_Pack(pRx, hEepWave.Sample, uiLen);
+			pRx += uiLen;
+		}
+		if(pTx != NULL) pTx += uiLen;
+		uwLen -= uiLen;
+	}
+
+	return HAL_OK;
+}
+
+#endif /* USE_SOFTSPI_WAVE */
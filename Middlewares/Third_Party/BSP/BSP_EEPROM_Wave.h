@@ -0,0 +1,67 @@
+/**
+  ******************************************************************************
+  * @file    BSP_EEPROM_Wave.h
+  * @author  Hossein Bagherzade(@realhba)
+	* @email	 hossein.bagherzade@gmail.com
+  * @version V1.0.0
+  * @date    18-Oct-2026
+  * @brief   Header file for BSP_EEPROM_Wave.c
+  ******************************************************************************
+	**/
+
+
+#ifndef __BSP_EEPROM_WAVE_H
+#define __BSP_EEPROM_WAVE_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "BSP_EEPROM.h"
+
+
+// SCK, MOSI and MISO must share one port, BSRR is written and IDR sampled as a whole
+#define EEP_WAVE_GPIO										 GPIOA
+#define EEP_WAVE_TIM										 TIM1
+#define EEP_WAVE_TIM_CLK_ENABLE()				 __HAL_RCC_TIM1_CLK_ENABLE()
+#define EEP_WAVE_DMA_CLK_ENABLE()				 __HAL_RCC_DMA1_CLK_ENABLE()
+#define EEP_WAVE_DMA_OUT								 DMA1_Channel5 		// TIM1_UP: BSRR word per half period
+#define EEP_WAVE_DMA_IN									 DMA1_Channel4 		// TIM1_CH4: IDR sample half way through it
+#define EEP_WAVE_DMA_IRQn								 DMA1_Channel4_5_IRQn
+#define EEP_WAVE_DMA_IRQ_PRIORITY				 (uint32_t)1
+
+#define EEP_WAVE_CHUNK									 (uint16_t)8 			// bytes clocked per DMA run, costs 96 bytes of RAM per byte
+#define EEP_WAVE_WORDS									 (EEP_WAVE_CHUNK * 16) 						// two half periods per bit
+#define EEP_WAVE_SAMPLES								 (EEP_WAVE_WORDS + 1) 							// one more taken before the first word
+#define EEP_WAVE_HALF_TICKS_MIN					 (uint16_t)24 		// half period at ClkStep 0, doubled per step
+
+typedef struct
+{
+	TIM_HandleTypeDef hTim;
+	DMA_HandleTypeDef hDmaOut;
+	DMA_HandleTypeDef hDmaIn;
+	uint32_t Wave[EEP_WAVE_WORDS];
+	uint16_t Sample[EEP_WAVE_SAMPLES];
+	volatile uint8_t Busy;
+	uint8_t  Ready;
+} EEP_WaveTypeDef;
+
+
+extern EEP_WaveTypeDef hEepWave;
+
+uint16_t EEPROM_Wave_Build(uint32_t* pWave, const uint8_t* pTx, uint16_t uiLen);
+void EEPROM_Wave_Pack(uint8_t* pRx, const uint16_t* pSample, uint16_t uiLen);
+
+HAL_StatusTypeDef EEPROM_Wave_Init(void);
+HAL_StatusTypeDef EEPROM_Wave_Start(uint16_t uiWords);
+uint8_t EEPROM_Wave_IsBusy(void);
+HAL_StatusTypeDef EEPROM_Wave_Transfer(const uint8_t* pTx, uint8_t* pRx, uint32_t uwLen);
+void EEPROM_Wave_IRQHandler(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __BSP_EEPROM_WAVE_H */
+
@@ -0,0 +1,289 @@
+/**
+  ******************************************************************************
+  * @file    BSP_Timebase.c
+  * @author  Hossein Bagherzade(@realhba)
+	* @email	 hossein.bagherzade@gmail.com
+  * @version V1.0.0
+  * @date    18-Oct-2026
+  * @brief   1 us free-running timebase and deadline based delays.
+  * The 16bit TIM counter is extended to 32bit by counting update events,
+  * so time stamps wrap after ~71 minutes and deadlines are compared signed.
+  ******************************************************************************
+	**/
+
+#include "BSP_Timebase.h"
+
+#ifndef BSP_TIMEBASE_VIRTUAL
+//=======================================================================================
+//=========================== Hardware timer timebase ===================================
+//=======================================================================================
+
+TIM_HandleTypeDef htimebase;
+static volatile uint32_t uwTimebaseHigh = 0;
+static volatile uint32_t uwAlarmUs = 0;
+static volatile uint32_t uwWakeLatencyUs = 0;
+
+/**
+  * @brief  clock of the APB timers: PCLK, doubled by the RCC whenever the APB
+  *         prescaler is not 1
+	* @retval timer kernel clock in Hz
+  */
+//==============================================
+static uint32_t BSP_Timebase_TimerClock(void)
+//==============================================
+{
+	uint32_t uwPclk = HAL_RCC_GetPCLK1Freq();
+
+	if((RCC->CFGR & RCC_CFGR_PPRE) != RCC_HCLK_DIV1) uwPclk *= 2;
+
+	return uwPclk;
+}
+
+/**
+  * @brief  starts the free-running timer used as us timebase
+	* @retval HAL_StatusTypeDef enum, HAL_OK in case of successful operation
+  */
+//==============================================
+HAL_StatusTypeDef BSP_Timebase_Init(void)
+//==============================================
+{
+	TIMEBASE_TIM_CLK_ENABLE();
+
+	htimebase.Instance = TIMEBASE_TIM;
+	htimebase.Init.Prescaler = (BSP_Timebase_TimerClock() / TIMEBASE_TICK_HZ) - 1;
+	htimebase.Init.CounterMode = TIM_COUNTERMODE_UP;
+	htimebase.Init.Period = 0xFFFF;
+	htimebase.Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
+	htimebase.Init.RepetitionCounter = 0;
+	htimebase.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_DISABLE;
+	if(HAL_TIM_Base_Init(&htimebase) != HAL_OK) return HAL_ERROR;
+
+	uwTimebaseHigh = 0;
+	__HAL_TIM_CLEAR_FLAG(&htimebase, TIM_FLAG_UPDATE);
+
+	HAL_NVIC_SetPriority(TIMEBASE_TIM_IRQn, TIMEBASE_TIM_IRQ_PRIORITY, 0);
+	HAL_NVIC_EnableIRQ(TIMEBASE_TIM_IRQn);
+
+	return HAL_TIM_Base_Start_IT(&htimebase);
+}
+
+/**
+  * @brief  counts timer overflows, must be called from the TIM IRQ handler
+	* @retval none
+  */
+//==============================================
+void BSP_Timebase_IRQHandler(void)
+//==============================================
+{
+	if(__HAL_TIM_GET_FLAG(&htimebase, TIM_FLAG_UPDATE) != RESET)
+	{
+		__HAL_TIM_CLEAR_FLAG(&htimebase, TIM_FLAG_UPDATE);
+		uwTimebaseHigh += 0x10000;
+	}
+
+	// CC1 matches once per counter wrap, the alarm is only done when the full 32bit time is reached
+	if((__HAL_TIM_GET_FLAG(&htimebase, TIM_FLAG_CC1) != RESET) && (__HAL_TIM_GET_IT_SOURCE(&htimebase, TIM_IT_CC1) != RESET))
+	{
+		__HAL_TIM_CLEAR_FLAG(&htimebase, TIM_FLAG_CC1);
+		if(BSP_Deadline_Expired(uwAlarmUs)){
+			__HAL_TIM_DISABLE_IT(&htimebase, TIM_IT_CC1);
+			uwWakeLatencyUs = BSP_GetMicros() - uwAlarmUs;
+		}
+	}
+}
+
+/**
+  * @brief  arms the compare alarm and sleeps (WFI) until the deadline is reached.
+  *         SysTick keeps running, so HAL_GetTick stays valid and simply costs
+  *         one extra wakeup per millisecond.
+  * @param  deadline: absolute wakeup time, as made by BSP_Deadline_After
+	* @retval none
+  */
+//==============================================
+void BSP_Timebase_SleepUntil(BSP_DeadlineTypeDef deadline)
+//==============================================
+{
+	if(BSP_Deadline_Expired(deadline)) return;
+
+	__disable_irq();
+	uwAlarmUs = deadline;
+	__HAL_TIM_SET_COMPARE(&htimebase, TIM_CHANNEL_1, deadline & 0xFFFF);
+	__HAL_TIM_CLEAR_FLAG(&htimebase, TIM_FLAG_CC1);
+	__HAL_TIM_ENABLE_IT(&htimebase, TIM_IT_CC1);
+
+	// With PRIMASK set a pending irq still ends WFI, so no wakeup can be lost
+	// between the check and the sleep; it is serviced once irqs are enabled.
+	while(!BSP_Deadline_Expired(deadline))
+	{
+		HAL_PWR_EnterSLEEPMode(PWR_MAINREGULATOR_ON, PWR_SLEEPENTRY_WFI);
+		__enable_irq();
+		__disable_irq();
+	}
+
+	__HAL_TIM_DISABLE_IT(&htimebase, TIM_IT_CC1);
+	__enable_irq();
+}
+
+/**
+  * @brief  delay between the last alarm deadline and its interrupt
+	* @retval wakeup latency in microseconds
+  */
+//==============================================
+uint32_t BSP_Timebase_GetWakeLatency(void)
+//==============================================
+{
+	return uwWakeLatencyUs;
+}
+
+/**
+  * @brief  current time stamp
+	* @retval microseconds since BSP_Timebase_Init
+  */
+//==============================================
+uint32_t BSP_GetMicros(void)
+//==============================================
+{
+	uint32_t primask = __get_PRIMASK();
+	uint32_t high, low;
+
+	__disable_irq();
+	high = uwTimebaseHigh;
+	low = TIMEBASE_TIM->CNT;
+
+	// Overflow happened but the IRQ is not serviced yet (we may be called with irqs masked)
+	if(__HAL_TIM_GET_FLAG(&htimebase, TIM_FLAG_UPDATE) != RESET){
+		low = TIMEBASE_TIM->CNT;
+		high += 0x10000;
+	}
+	__set_PRIMASK(primask);
+
+	return high | low;
+}
+
+/**
+  * @brief  millisecond tick, kept on SysTick for HAL compatibility
+	* @retval milliseconds since HAL_Init
+  */
+//==============================================
+uint32_t BSP_GetTick(void)
+//==============================================
+{
+	return HAL_GetTick();
+}
+
+#else
+//=======================================================================================
+//=========================== Virtual clock for host builds =============================
+//=======================================================================================
+
+static uint64_t ullVirtualMicros = 0;
+
+//==============================================
+HAL_StatusTypeDef BSP_Timebase_Init(void)
+//==============================================
+{
+	ullVirtualMicros = 0;
+	return HAL_OK;
+}
+
+//==============================================
+void BSP_Timebase_IRQHandler(void)
+//==============================================
+{
+}
+
+/**
+  * @brief  moves the virtual clock forward, used by simulated peripherals
+  * @param  us: elapsed microseconds
+	* @retval none
+  */
+//==============================================
+void BSP_Timebase_Advance(uint32_t us)
+//==============================================
+{
+	ullVirtualMicros += us;
+}
+
+//==============================================
+uint32_t BSP_GetMicros(void)
+//==============================================
+{
+	return (uint32_t)ullVirtualMicros;
+}
+
+//==============================================
+void BSP_Timebase_SleepUntil(BSP_DeadlineTypeDef deadline)
+//==============================================
+{
+	BSP_Timebase_Advance(BSP_Deadline_Remaining(deadline));
+}
+
+//==============================================
+uint32_t BSP_Timebase_GetWakeLatency(void)
+//==============================================
+{
+	return 0;
+}
+
+//==============================================
+uint32_t BSP_GetTick(void)
+//==============================================
+{
+	return (uint32_t)(ullVirtualMicros / 1000);
+}
+
+#endif
+
+/**
+  * @brief  called repeatedly by NONE_BLOCKING waits, override it to sleep or yield
+  * @param  uwRemainingUs: time left of a timed wait, 0 while waiting for an
+  *         event that may come any moment (DMA, interrupt)
+	* @retval none
+  */
+//=========================================================
+__weak void BSP_Timebase_IdleHook(uint32_t uwRemainingUs)
+//=========================================================
+{
+	(void)uwRemainingUs;
+}
+
+/**
+  * @brief  waits for a number of microseconds
+  * @param  us: delay in microseconds
+  * @param  mode: BLOCKING spins, NONE_BLOCKING runs the idle hook while waiting
+	* @retval none
+  */
+//=========================================================
+void BSP_DelayUs(uint32_t us, BSP_DelayModeTypeDef mode)
+//=========================================================
+{
+#ifdef BSP_TIMEBASE_VIRTUAL
+	if(mode == NONE_BLOCKING) BSP_Timebase_IdleHook(us);
+	BSP_Timebase_Advance(us);
+#else
+	BSP_DeadlineTypeDef deadline = BSP_Deadline_After(us);
+
+	while(!BSP_Deadline_Expired(deadline))
+	{
+		if(mode == NONE_BLOCKING) BSP_Timebase_IdleHook(BSP_Deadline_Remaining(deadline));
+	}
+#endif
+}
+
+/**
+  * @brief  waits for a number of milliseconds
+  * @param  ms: delay in milliseconds
+  * @param  mode: BLOCKING spins, NONE_BLOCKING runs the idle hook while waiting
+	* @retval none
+  */
+//=========================================================
+void BSP_Delay(uint32_t ms, BSP_DelayModeTypeDef mode)
+//=========================================================
+{
+	// split long delays so the us deadline never gets near the signed range
+	while(ms > 1000){
+		BSP_DelayUs(1000000, mode);
+		ms -= 1000;
+	}
+	BSP_DelayUs(ms * 1000, mode);
+}
@@ -0,0 +1,94 @@
+/**
+  ******************************************************************************
+  * @file    BSP_Timebase.h
+  * @author  Hossein Bagherzade(@realhba)
+	* @email	 hossein.bagherzade@gmail.com
+  * @version V1.0.0
+  * @date    18-Oct-2026
+  * @brief   Header file for BSP_Timebase.c
+  ******************************************************************************
+	**/
+
+
+#ifndef __BSP_TIMEBASE_H
+#define __BSP_TIMEBASE_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "stm32f0xx_hal.h"
+
+
+//#define BSP_TIMEBASE_VIRTUAL 											// host builds: time only moves by BSP_Timebase_Advance()
+
+#define TIMEBASE_TIM										 TIM14
+#define TIMEBASE_TIM_IRQn								 TIM14_IRQn
+#define TIMEBASE_TIM_CLK_ENABLE()				 __HAL_RCC_TIM14_CLK_ENABLE()
+#define TIMEBASE_TIM_IRQ_PRIORITY				 (uint32_t)0
+#define TIMEBASE_TICK_HZ								 (uint32_t)1000000 		// 1 us resolution
+
+typedef enum
+{
+	BLOCKING = 0,																								// spin until the deadline
+	NONE_BLOCKING																								// call BSP_Timebase_IdleHook(remaining) while waiting
+} BSP_DelayModeTypeDef;
+
+typedef uint32_t BSP_DeadlineTypeDef; 												// absolute time stamp in us
+
+
+HAL_StatusTypeDef BSP_Timebase_Init(void);
+void BSP_Timebase_IRQHandler(void);
+void BSP_Timebase_IdleHook(uint32_t uwRemainingUs);
+
+uint32_t BSP_GetMicros(void);
+uint32_t BSP_GetTick(void);
+
+void BSP_DelayUs(uint32_t us, BSP_DelayModeTypeDef mode);
+void BSP_Delay(uint32_t ms, BSP_DelayModeTypeDef mode);
+
+void BSP_Timebase_SleepUntil(BSP_DeadlineTypeDef deadline);
+uint32_t BSP_Timebase_GetWakeLatency(void);
+
+#ifdef BSP_TIMEBASE_VIRTUAL
+void BSP_Timebase_Advance(uint32_t us);
+#endif
+
+/**
+  * @brief  makes a deadline which expires us microseconds from now
+  * @param  us: relative timeout in microseconds (must be below 2^31)
+	* @retval absolute deadline
+  */
+__STATIC_INLINE BSP_DeadlineTypeDef BSP_Deadline_After(uint32_t us)
+{
+	return BSP_GetMicros() + us;
+}
+
+/**
+  * @brief  checks a deadline, safe against wraparound of the us counter
+  * @param  deadline: value returned by BSP_Deadline_After
+	* @retval 1 if the deadline is reached
+  */
+__STATIC_INLINE uint8_t BSP_Deadline_Expired(BSP_DeadlineTypeDef deadline)
+{
+	return ((int32_t)(BSP_GetMicros() - deadline) >= 0) ? 1 : 0;
+}
+
+/**
+  * @brief  time left until a deadline
+  * @param  deadline: value returned by BSP_Deadline_After
+	* @retval remaining microseconds, 0 if already expired
+  */
+__STATIC_INLINE uint32_t BSP_Deadline_Remaining(BSP_DeadlineTypeDef deadline)
+{
+	int32_t iLeft = (int32_t)(deadline - BSP_GetMicros());
+	return (iLeft > 0) ? (uint32_t)iLeft : 0;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __BSP_TIMEBASE_H */
+
@@ -40,7 +40,11 @@
 #include "main.h"
 #include "stm32f0xx_hal.h"
 #include "DebugProbe.h"
+#include "BSP_Timebase.h"
 #include "bsp_eeprom.h"
+#if (USE_FLASH_EEPROM == 1)
+#include "BSP_EEPROM_Flash.h"
+#endif
 
 /* Private variables ---------------------------------------------------------*/
 SPI_HandleTypeDef hspi1;
@@ -67,6 +71,9 @@ int main(void)
   /* Configure the system clock */
   SystemClock_Config();
 	
+	/* Start the us timebase used for eeprom deadlines */
+	BSP_Timebase_Init();
+	
   /* Initialize all configured peripherals */
   MX_USART1_UART_Init();
 	BSP_DebugProbe_Init(115200);
@@ -74,11 +81,20 @@ int main(void)
   /* Initialize interrupts */
   MX_NVIC_Init();
 	
+#if (USE_FLASH_EEPROM == 1)
+	/*Rebuild the emulated eeprom from its log in the internal flash*/
+	BSP_EEPROM_Flash_Init();
+#else
+	/*Pick the fastest bus clock the board tolerates*/
+	EEPROM_SPI_Init();
+	EEPROM_SPI_CalibrateClock();
+	
 	/*Testing eeprom in single write mode*/
 	EEPROM_SPI_SingleReadWriteTest(0);
 	
 	/*Testing eeprom in multiple write mode*/	
 	EEPROM_SPI_MultipleReadWriteTest(0);
+#endif
 	
   /* Infinite loop */
   while (1)
@@ -35,6 +35,10 @@
 #include "stm32f0xx.h"
 #include "stm32f0xx_it.h"
 #include "DebugProbe.h"
+#include "BSP_Timebase.h"
+#include "BSP_EEPROM_Wave.h"
+#include "BSP_EEPROM_SpiIT.h"
+#include "BSP_EEPROM_Stream.h"
 
 /* External variables --------------------------------------------------------*/
 extern UART_HandleTypeDef huart1;
@@ -93,6 +97,44 @@ void SysTick_Handler(void)
 /* please refer to the startup file (startup_stm32f0xx.s).                    */
 /******************************************************************************/
 
+/**
+* @brief This function handles TIM14 global interrupt (us timebase).
+*/
+void TIM14_IRQHandler(void)
+{
+  BSP_Timebase_IRQHandler();
+}
+
+#if (USE_SOFTSPI_WAVE == 1)
+/**
+* @brief This function handles DMA1 channel 4 and 5 interrupts (soft SPI waveform).
+*/
+void DMA1_Channel4_5_IRQHandler(void)
+{
+  EEPROM_Wave_IRQHandler();
+}
+#endif
+
+#if (USE_SOFTWARE_SPI == 0) && (USE_FLASH_EEPROM == 0)
+/**
+* @brief This function handles DMA1 channel 2 and 3 interrupts (EEPROM stream).
+*/
+void DMA1_Channel2_3_IRQHandler(void)
+{
+  EEPROM_Stream_IRQHandler();
+}
+#endif
+
+#if (USE_HARDSPI_IT == 1)
+/**
+* @brief This function handles SPI1 global interrupt (EEPROM frames).
+*/
+void SPI1_IRQHandler(void)
+{
+  EEPROM_SpiIT_IRQHandler();
+}
+#endif
+
 /**
 * @brief This function handles USART1 global interrupt.
 */